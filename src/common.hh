@@ -118,6 +118,10 @@ char *GetPrintlogLine(int Line);
 void IncrementObjectCounter(void);
 void DecrementObjectCounter(void);
 uint32 GetObjectCounter(void);
+uint32 GetObjectCounterMax(void);
+void SetObjectBlocks(int Blocks);
+int GetObjectBlocks(void);
+int GetObjectBlocksMax(void);
 void IncrementPlayersOnline(void);
 void DecrementPlayersOnline(void);
 int GetPlayersOnline(void);
@@ -165,6 +169,7 @@ void GetDate(int *Year, int *Cycle, int *Day);
 void GetAmbiente(int *Brightness, int *Color);
 uint32 GetRoundAtTime(int Hour, int Minute);
 uint32 GetRoundForNextMinute(void);
+int64 GetMonotonicMicroseconds(void);
 
 // utils.cc
 // =============================================================================
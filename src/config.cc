@@ -33,6 +33,14 @@ int PremiumPlayerBuffer;
 int PremiumNewbieBuffer;
 int Beat;
 int RebootTime;
+int RefreshMapBudget;
+bool ChaseFlowFields;
+bool StaticFieldCache;
+int PlayerDataPoolSize;
+bool BinaryPlayerData;
+int PlayerIndexSnapshotAge;
+int ReaderWorkers;
+char PlayerlistFile[4096];
 
 TDatabaseSettings ADMIN_DATABASE;
 TDatabaseSettings VOLATILE_DATABASE;
@@ -99,6 +107,14 @@ void ReadConfig(void){
 	NumberOfQueryManagers = 0;
 	Beat = 200;
 	RebootTime = 540;
+	RefreshMapBudget = 20;
+	ChaseFlowFields = true;
+	StaticFieldCache = true;
+	PlayerDataPoolSize = 2000;
+	BinaryPlayerData = true;
+	PlayerIndexSnapshotAge = 0;
+	ReaderWorkers = 2;
+	PlayerlistFile[0] = 0;
 	ADMIN_DATABASE.Database[0] = 0;
 	VOLATILE_DATABASE.Database[0] = 0;
 	WEB_DATABASE.Database[0] = 0;
@@ -181,6 +197,27 @@ void ReadConfig(void){
 			strcpy(WorldName, Script.readString());
 		}else if(strcmp(Identifier, "beat") == 0){
 			Beat = Script.readNumber();
+		}else if(strcmp(Identifier, "refreshmapbudget") == 0){
+			RefreshMapBudget = Script.readNumber();
+		}else if(strcmp(Identifier, "chaseflowfields") == 0){
+			ChaseFlowFields = (Script.readNumber() != 0);
+		}else if(strcmp(Identifier, "staticfieldcache") == 0){
+			StaticFieldCache = (Script.readNumber() != 0);
+		}else if(strcmp(Identifier, "playerdatapoolsize") == 0){
+			PlayerDataPoolSize = Script.readNumber();
+		}else if(strcmp(Identifier, "binaryplayerdata") == 0){
+			BinaryPlayerData = (Script.readNumber() != 0);
+		}else if(strcmp(Identifier, "playerindexsnapshotage") == 0){
+			// NOTE(fusion): Maximum age in seconds of a player index snapshot that
+			// is still used on startup. Only characters created after it are then
+			// requested from the query manager, so deleted or renamed characters
+			// keep their old names until the snapshot expires. Zero (the default)
+			// reloads every name on every restart.
+			PlayerIndexSnapshotAge = Script.readNumber();
+		}else if(strcmp(Identifier, "readerworkers") == 0){
+			ReaderWorkers = Script.readNumber();
+		}else if(strcmp(Identifier, "playerlistfile") == 0){
+			strcpy(PlayerlistFile, Script.readString());
 		}else if(strcmp(Identifier, "admindatabase") == 0){
 			Script.readSymbol('(');
 			strcpy(ADMIN_DATABASE.Product, Script.readIdentifier());
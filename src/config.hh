@@ -48,6 +48,14 @@ extern int PremiumPlayerBuffer;
 extern int PremiumNewbieBuffer;
 extern int Beat;
 extern int RebootTime;
+extern int RefreshMapBudget;
+extern bool ChaseFlowFields;
+extern bool StaticFieldCache;
+extern int PlayerDataPoolSize;
+extern bool BinaryPlayerData;
+extern int PlayerIndexSnapshotAge;
+extern int ReaderWorkers;
+extern char PlayerlistFile[4096];
 extern TDatabaseSettings ADMIN_DATABASE;
 extern TDatabaseSettings VOLATILE_DATABASE;
 extern TDatabaseSettings WEB_DATABASE;
@@ -110,11 +110,60 @@ struct TRaceData {
 	vector<TSpellData> Spell;
 };
 
+// NOTE(fusion): Parts of `TPlayerData` that changed since it was last saved,
+// so `SavePlayerData` only has to look at those. Depots are tracked separately
+// with one bit per depot in `DirtyDepots`.
+enum : int {
+	PLAYER_DIRTY_GENERAL		= 0x01,
+	PLAYER_DIRTY_SKILLS			= 0x02,
+	PLAYER_DIRTY_SPELLS			= 0x04,
+	PLAYER_DIRTY_QUESTS			= 0x08,
+	PLAYER_DIRTY_MURDERS		= 0x10,
+	PLAYER_DIRTY_INVENTORY		= 0x20,
+	PLAYER_DIRTY_ALL			= 0x3F,
+};
+
+// NOTE(fusion): Dirty player data is saved by the writer thread in steps that
+// are spread over the save interval (in seconds). See `SavePlayerPoolSlots`.
+#define PLAYERDATA_SAVE_INTERVAL 900
+#define PLAYERDATA_SAVE_STEPS 90
+
+// NOTE(fusion): Quest values are sparse. Characters only ever touch a handful
+// of quests, so values are kept as a list sorted by quest number instead of a
+// dense array, which also lets quest numbers go well past the old limit of 500.
+// A value of zero means unset and is never stored. This has no constructor or
+// destructor because `TPlayerData` is zero initialized with memset, so the list
+// must be explicitly released with `release`. `QUESTVALUES_DENSE_SIZE` is what
+// the old array took per slot and is only used for memory reports.
+#define MAX_QUESTS 65535
+#define QUESTVALUES_DENSE_SIZE (500 * 4)
+
+struct TQuestValue {
+	uint16 QuestNr;
+	int Value;
+};
+
+struct TQuestValues {
+	int get(int QuestNr);
+	void set(int QuestNr, int Value);
+	void copy(TQuestValues *Other);
+	void clear(void);
+	void release(void);
+
+	// DATA
+	// =================
+	int Count;
+	int Capacity;
+	TQuestValue *Entry;
+};
+
 struct TPlayerData {
 	uint32 CharacterID;
 	pid_t Locked;
 	int Sticky;
 	bool Dirty;
+	int DirtySections;
+	int DirtyDepots;
 	int Race;
 	TOutfit OriginalOutfit;
 	TOutfit CurrentOutfit;
@@ -143,12 +192,13 @@ struct TPlayerData {
 	int NextLevel[25];
 	int Delta[25];
 	uint8 SpellList[256];
-	int QuestValues[500];
+	TQuestValues QuestValues;
 	int MurderTimestamps[20];
 	uint8 *Inventory;
 	int InventorySize;
 	uint8 *Depot[MAX_DEPOTS];
 	int DepotSize[MAX_DEPOTS];
+	bool DepotPending[MAX_DEPOTS];
 	uint32 AccountID;
 	int Sex;
 	char Name[30];
@@ -199,6 +249,7 @@ struct TSkill{
 	int Get(void);
 	int GetProgress(void);
 	void Check(void);
+	void SyncCount(void);
 	void Change(int Amount);
 	void SetMax(void);
 	void DecreasePercent(int Percent);
@@ -250,6 +301,7 @@ struct TSkill{
 	int Count;
 	int MaxCount;
 	int AddLevel;
+	uint32 CountRound;	// Skill timer round up to which `Count` is current.
 };
 
 struct TSkillLevel: TSkill {
@@ -347,6 +399,7 @@ struct TSkillBase{
 	bool NewSkill(uint16 SkillNo, TCreature *Creature);
 	bool SetSkills(int Race);
 	void ProcessSkills(void);
+	uint32 NextTimerRound(void);
 	bool SetTimer(uint16 SkNr, int Cycle, int Count, int MaxCount, int AdditionalValue);
 	void DelTimer(uint16 SkNr);
 
@@ -355,6 +408,7 @@ struct TSkillBase{
 	TSkill *Skills[25];
 	TSkill *TimerList[25];
 	uint16 FirstFreeTimer;
+	uint32 TimerDueRound;
 };
 
 // TCombat
@@ -449,6 +503,42 @@ struct TFindCreatures {
 	bool finished;
 };
 
+// NOTE(fusion): Players and monsters found by `TFindTargets`, along with the
+// parts of the monster target conditions that only change when the creature
+// moves. These are cached per 16x16 block until some creature enters, leaves,
+// or moves inside it.
+struct TTargetCandidate {
+	uint32 ID;
+	int x;
+	int y;
+	int z;
+	int Type;
+	bool Protected;
+	bool Ignored;
+};
+
+struct TFindTargets {
+	TFindTargets(int RadiusX, int RadiusY, uint32 CreatureID);
+	TTargetCandidate *getNext(void);
+
+	// DATA
+	// =================
+	int startx;
+	int starty;
+	int endx;
+	int endy;
+	int blockx;
+	int blocky;
+	uint32 ActID;
+	uint32 SkipID;
+	TTargetCandidate *Block;
+	int BlockCandidates;
+	int BlockIndex;
+	bool Uncached;
+	TTargetCandidate Current;
+	bool finished;
+};
+
 // TCreature
 // =============================================================================
 enum : int {
@@ -510,6 +600,35 @@ struct TToDoEntry {
 	};
 };
 
+// NOTE(fusion): Running totals of what a creature carries so inventory counts
+// and searches don't have to walk every container. Objects are counted by type
+// and, for liquid containers and keys, by liquid type or key number, which is
+// what inventory searches match on. It is kept up to date by the object
+// operations in `operate.cc` (see `AddInventoryIndex`) and rebuilt whenever an
+// inventory is loaded directly.
+struct TInventoryCount {
+	int TypeID;
+	uint32 Value;
+	int Count;
+};
+
+struct TInventoryIndex {
+	NONCOPYABLE(TInventoryIndex)
+
+	TInventoryIndex(void);
+	~TInventoryIndex(void);
+	int get(int TypeID, uint32 Value);
+	void add(int TypeID, uint32 Value, int Count);
+	void clear(void);
+
+	// DATA
+	// =================
+	int Money;
+	int Count;
+	int Capacity;
+	TInventoryCount *Entry;
+};
+
 struct TCreature: TSkillBase {
 	// crmain.cc
 	TCreature(void);
@@ -545,6 +664,8 @@ struct TCreature: TSkillBase {
 	void ToDoWait(int Delay);
 	void ToDoWaitUntil(uint32 Time);
 	void ToDoGo(int DestX, int DestY, int DestZ, bool MustReach, int MaxSteps);
+	void ToDoGo(int DestX, int DestY, int DestZ, bool MustReach, int MaxSteps,
+				bool LongDistance);
 	void ToDoRotate(int Direction);
 	void ToDoMove(int ObjX, int ObjY, int ObjZ, ObjectType Type, uint8 RNum,
 				int DestX, int DestY, int DestZ, uint8 Count);
@@ -601,7 +722,6 @@ struct TCreature: TSkillBase {
 	//TSkillBase super_TSkillBase;	// IMPLICIT
 	TCombat Combat;
 	uint32 ID;
-	TCreature *NextHashEntry;
 	uint32 NextChainCreature;
 	char Name[31];
 	char Murderer[31];
@@ -636,14 +756,18 @@ struct TCreature: TSkillBase {
 	uint32 PoisonDamageOrigin;
 	uint32 EnergyDamageOrigin;
 	Object CrObject;
+	TInventoryIndex InventoryIndex;
 	vector<TToDoEntry> ToDoList;
 	int ActToDo;
 	int NrToDo;
 	uint32 NextWakeup;
+	uint32 ToDoGeneration;
 	bool Stop;
 	bool LockToDo;
 	uint8 Profession;
 	TConnection *Connection;
+	bool InCrList;
+	int CrListIndex;
 };
 
 // TNonPlayer
@@ -714,6 +838,25 @@ struct TBehaviour {
 	int Actions;
 };
 
+// NOTE(fusion): Conditions of every behaviour, flattened into a single array
+// by `TBehaviourDatabase::compile`. Situation properties become a mask test and
+// comparisons between plain NPC variables and numbers are evaluated in place,
+// without walking the expression tree. Anything else keeps its original form
+// and `Expression` still points into the behaviour that owns it.
+struct TBehaviourInstruction {
+	int Type;
+	int Data;
+	int Left;
+	int LeftData;
+	int Right;
+	int RightData;
+	TBehaviourNode *Expression;
+};
+
+// NOTE(fusion): Behaviours are indexed by the first two letters of their first
+// text condition, which has to match at the beginning of some word of the text.
+#define BEHAVIOUR_KEYWORD_BUCKETS 256
+
 struct TBehaviourDatabase {
 	TBehaviourDatabase(TReadScriptFile *Script);
 
@@ -723,12 +866,22 @@ struct TBehaviourDatabase {
 	TBehaviourNode *readTerm(TReadScriptFile *Script);
 	int evaluate(TNPC *Npc, TBehaviourNode *Node, int *Parameters);
 
+	void compile(void);
+	int operand(TNPC *Npc, TPlayer *Interlocutor, int Type, int Data);
+	int match(TNPC *Npc, TPlayer *Interlocutor,
+			const char *Text, SITUATION Situation, int *Parameters);
 	void react(TNPC *Npc, const char *Text, SITUATION Situation);
 
 	// DATA
 	// =================
 	vector<TBehaviour> Behaviour;
 	int Behaviours;
+	vector<TBehaviourInstruction> Instruction;
+	int Instructions;
+	vector<int> BehaviourStart;
+	vector<int> KeywordEntry;
+	int KeywordStart[BEHAVIOUR_KEYWORD_BUCKETS + 2];
+	vector<int> Candidate;
 };
 
 struct TNPC: TNonplayer {
@@ -764,6 +917,9 @@ struct TNPC: TNonplayer {
 	vector<uint32> QueuedAddresses;
 	int QueueLength;
 	TBehaviourDatabase *Behaviour;
+	uint32 Reactions;
+	int64 ReactionTimeTotal;
+	int64 ReactionTimeMax;
 };
 
 // TMonster
@@ -777,7 +933,22 @@ struct TMonsterhome {
 	int MaxMonsters;
 	int ActMonsters;
 	int RegenerationTime;
-	int Timer;
+	uint32 TimerRound;
+};
+
+// NOTE(fusion): Everything `TMonster::MovePossible` depends on, other than the
+// map itself, when checking a move without executing it. Monsters with equal
+// profiles will find the same fields passable.
+struct TMoveProfile {
+	uint32 Target;
+	uint32 Master;
+	uint32 Flags;
+
+	bool operator==(const TMoveProfile &Other) const {
+		return this->Target == Other.Target
+			&& this->Master == Other.Master
+			&& this->Flags == Other.Flags;
+	}
 };
 
 struct TMonster: TNonplayer {
@@ -789,6 +960,7 @@ struct TMonster: TNonplayer {
 	void SetTarget(TCreature *NewTarget);
 	bool IsPlayerControlled(void);
 	bool IsFleeing(void);
+	bool GetMoveProfile(TMoveProfile *Profile);
 
 	// VIRTUAL FUNCTIONS
 	// =================
@@ -809,24 +981,11 @@ struct TMonster: TNonplayer {
 
 // TPlayer
 // =============================================================================
-struct TPlayerIndexNode {
-	bool InternalNode;
-};
-
-struct TPlayerIndexInternalNode: TPlayerIndexNode {
-	TPlayerIndexNode *Child[27];
-};
-
 struct TPlayerIndexEntry {
 	char Name[30];
 	uint32 CharacterID;
 };
 
-struct TPlayerIndexLeafNode: TPlayerIndexNode {
-	int Count;
-	TPlayerIndexEntry Entry[10];
-};
-
 struct TPlayer: TCreature {
 	TPlayer(TConnection *Connection, uint32 CharacterID);
 	void SetInList(void);
@@ -901,6 +1060,8 @@ struct TPlayer: TCreature {
 	Object Depot;
 	int DepotNr;
 	int DepotSpace;
+	bool DepotMaterialized;
+	uint32 DepotIdleRound;
 	RESULT ConstructError;
 	TPlayerData *PlayerData;
 	Object TradeObject;
@@ -912,7 +1073,7 @@ struct TPlayer: TCreature {
 	uint32 RequestProcessingGamemaster;
 	int TutorActivities;
 	uint8 SpellList[256];
-	int QuestValues[500];
+	TQuestValues QuestValues;
 	Object OpenContainer[16];
 	vector<uint32> AttackedPlayers;
 	int NumberOfAttackedPlayers;
@@ -928,22 +1089,37 @@ struct TPlayer: TCreature {
 	int NumberOfMutings;
 	uint32 Addressees[20];
 	uint32 AddresseesTimes[20];
+	int PublishedLevel;
+	int PublishedProfession;
 };
 
+// cract.cc
+// =============================================================================
+void PathfindingSummary(void);
+
 // crmain.cc
 // =============================================================================
 #define MAX_RACES 512
 extern TRaceData RaceData[MAX_RACES];
-extern priority_queue<uint32, uint32> ToDoQueue;
+extern uint32 SkillTimerRound;
 
 bool IsCreaturePlayer(uint32 CreatureID);
 TCreature *GetCreature(uint32 CreatureID);
 TCreature *GetCreature(Object Obj);
+void GetCreatureTableStatistics(int *Entries, int *Capacity,
+		int *AverageProbe, int *MaxProbe);
+void CreatureTableSummary(void);
 void InsertChainCreature(TCreature *Creature, int CoordX, int CoordY);
 void DeleteChainCreature(TCreature *Creature);
 void MoveChainCreature(TCreature *Creature, int CoordX, int CoordY);
+void TargetCacheSummary(void);
+void GetMonsterActivity(int *Active, int *Dormant);
+void MonsterActivitySummary(void);
 void ProcessCreatures(void);
+void ScheduleSkillTimers(TCreature *Creature);
+void SkillTimerSummary(void);
 void ProcessSkills(void);
+void InsertToDoQueue(TCreature *Creature, uint32 Time);
 void MoveCreatures(int Delay);
 
 void AddKillStatistics(int AttackerRace, int DefenderRace);
@@ -983,6 +1159,11 @@ int GetSkillByName(const char *Name);
 // =============================================================================
 void StartMonsterhomeTimer(int Nr);
 void LoadMonsterhomes(void);
+void RefreshMonsterhomeCandidates(int SectorX, int SectorY, int SectorZ);
+void GetMonsterhomeStatistics(int *Homes, int *Running,
+		uint32 *Spawns, uint32 *Blocked, uint32 *NoField);
+void MonsterhomeSummary(void);
+void NpcReactionSummary(void);
 void ProcessMonsterhomes(void);
 void NotifyMonsterhomeOfDeath(int Nr);
 bool MonsterhomeInRange(int Nr, int x, int y, int z);
@@ -1012,9 +1193,13 @@ void CreatePlayerList(bool Online);
 void PrintPlayerPositions(void);
 void LoadDepot(TPlayerData *PlayerData, int DepotNr, Object Con);
 void SaveDepot(TPlayerData *PlayerData, int DepotNr, Object Con);
+int CountDepotObjects(TPlayerData *PlayerData, int DepotNr);
 void GetProfessionName(char *Buffer, int Profession, bool Article, bool Capitals);
 void SendExistingRequests(TConnection *Connection);
 
+bool LoadPlayerDepot(TPlayerData *Slot, int DepotNr);
+void ConvertPlayerData(bool Binary);
+
 void SavePlayerPoolSlot(TPlayerData *Slot);
 void FreePlayerPoolSlot(TPlayerData *Slot);
 TPlayerData *GetPlayerPoolSlot(uint32 CharacterID);
@@ -1025,13 +1210,15 @@ void IncreasePlayerPoolSlotSticky(TPlayerData *Slot);
 void DecreasePlayerPoolSlotSticky(TPlayerData *Slot);
 void DecreasePlayerPoolSlotSticky(uint32 CharacterID);
 void ReleasePlayerPoolSlot(TPlayerData *Slot);
+uint32 GetPlayerPoolReleaseGeneration(void);
+bool WaitPlayerPoolRelease(uint32 Generation, int Milliseconds);
 void SavePlayerPoolSlots(void);
+void GetPlayerPoolStatistics(int *Slots, int *Used, int *Sticky, uint32 *Evictions);
+void PlayerPoolSummary(void);
 void InitPlayerPool(void);
 void ExitPlayerPool(void);
 
-int GetPlayerIndexEntryNumber(const char *Name, int Position);
-void InsertPlayerIndex(TPlayerIndexInternalNode *Node,
-		int Position, const char *Name, uint32 CharacterID);
+void InsertPlayerIndex(const char *Name, uint32 CharacterID);
 TPlayerIndexEntry *SearchPlayerIndex(const char *Name);
 bool PlayerExists(const char *Name);
 uint32 GetCharacterID(const char *Name);
@@ -3,6 +3,7 @@
 #include "houses.hh"
 #include "info.hh"
 #include "operate.hh"
+#include "writer.hh"
 
 // TShortway
 // =============================================================================
@@ -261,6 +262,762 @@ bool TShortway::Calculate(int DestX, int DestY, bool MustReach, int MaxSteps){
 	return true;
 }
 
+// TFlowField
+// =============================================================================
+// NOTE(fusion): Monsters chasing the same target would each run `TShortway`
+// towards nearly the same destination every time the target moves. A flow field
+// is the complete reverse search from the destination over the area around it,
+// using the same costs as `TShortway`. It is computed with the movement rules of
+// the first chaser and shared with every chaser that has the same move profile,
+// which can then read its path straight from the field.
+//	Fields are dropped when the destination changes, when an object is changed
+// on one of its sectors (see `GetSectorRevision`), or after a short while, to
+// account for creatures moving around.
+#define FLOWFIELD_RADIUS 10
+#define FLOWFIELD_SIZE (2 * FLOWFIELD_RADIUS + 1)
+#define FLOWFIELD_LIFETIME 1000
+
+struct TFlowField {
+	int DestX;
+	int DestY;
+	int DestZ;
+	TMoveProfile Profile;
+	uint32 Expiry;
+	uint32 LastUse;
+	uint32 Revision[2][2];
+	int Waylength[FLOWFIELD_SIZE][FLOWFIELD_SIZE];
+	int NextX[FLOWFIELD_SIZE][FLOWFIELD_SIZE];
+	int NextY[FLOWFIELD_SIZE][FLOWFIELD_SIZE];
+};
+
+static TFlowField FlowField[64];
+static uint32 FlowFieldUseCounter;
+
+static void GetFlowFieldRevision(int DestX, int DestY, int DestZ, uint32 (*Revision)[2]){
+	int SectorX = (DestX - FLOWFIELD_RADIUS) / 32;
+	int SectorY = (DestY - FLOWFIELD_RADIUS) / 32;
+	for(int X = 0; X < 2; X += 1)
+	for(int Y = 0; Y < 2; Y += 1){
+		Revision[X][Y] = GetSectorRevision(SectorX + X, SectorY + Y, DestZ);
+	}
+}
+
+static void CalculateFlowField(TFlowField *Field, TMonster *Monster){
+	int Waypoints[FLOWFIELD_SIZE][FLOWFIELD_SIZE];
+	for(int X = 0; X < FLOWFIELD_SIZE; X += 1)
+	for(int Y = 0; Y < FLOWFIELD_SIZE; Y += 1){
+		int FieldX = Field->DestX + X - FLOWFIELD_RADIUS;
+		int FieldY = Field->DestY + Y - FLOWFIELD_RADIUS;
+		int FieldZ = Field->DestZ;
+
+		// NOTE(fusion): Same as `TShortway::FillMap`.
+		Waypoints[X][Y] = -1;
+		Object Obj = GetFirstObject(FieldX, FieldY, FieldZ);
+		if(Obj.exists()){
+			ObjectType ObjType = Obj.getObjectType();
+			if(ObjType.getFlag(BANK) && !ObjType.getFlag(UNPASS)
+					&& ObjType.getAttribute(WAYPOINTS) != 0
+					&& Monster->MovePossible(FieldX, FieldY, FieldZ, false, false)){
+				Waypoints[X][Y] = (int)ObjType.getAttribute(WAYPOINTS);
+			}
+		}
+
+		Field->Waylength[X][Y] = INT_MAX;
+		Field->NextX[X][Y] = 0;
+		Field->NextY[X][Y] = 0;
+	}
+
+	// NOTE(fusion): Same as `TShortway::Expand`, except that we don't stop
+	// when reaching the chaser's field since there is no single chaser.
+	priority_queue<int, int> Queue(FLOWFIELD_SIZE * FLOWFIELD_SIZE, FLOWFIELD_SIZE * FLOWFIELD_SIZE);
+	Field->Waylength[FLOWFIELD_RADIUS][FLOWFIELD_RADIUS] = 0;
+	Queue.insert(0, FLOWFIELD_RADIUS * FLOWFIELD_SIZE + FLOWFIELD_RADIUS);
+	while(Queue.Entries > 0){
+		priority_queue_entry<int, int> *Min = Queue.Entry->at(1);
+		int NodeWaylength = Min->Key;
+		int NodeX = Min->Data / FLOWFIELD_SIZE;
+		int NodeY = Min->Data % FLOWFIELD_SIZE;
+		Queue.deleteMin();
+
+		if(NodeWaylength != Field->Waylength[NodeX][NodeY]){
+			continue;
+		}
+
+		int NodeWaypoints = Waypoints[NodeX][NodeY];
+		for(int OffsetX = -1; OffsetX <= 1; OffsetX += 1)
+		for(int OffsetY = -1; OffsetY <= 1; OffsetY += 1){
+			if(OffsetX == 0 && OffsetY == 0){
+				continue;
+			}
+
+			int NeighborX = NodeX + OffsetX;
+			int NeighborY = NodeY + OffsetY;
+			if(NeighborX < 0 || NeighborX >= FLOWFIELD_SIZE
+					|| NeighborY < 0 || NeighborY >= FLOWFIELD_SIZE){
+				continue;
+			}
+
+			int NeighborWaylength = NodeWaylength + NodeWaypoints;
+			if(OffsetX != 0 && OffsetY != 0){
+				NeighborWaylength += NodeWaypoints * 2;
+			}
+
+			if(NeighborWaylength < Field->Waylength[NeighborX][NeighborY]){
+				Field->Waylength[NeighborX][NeighborY] = NeighborWaylength;
+				Field->NextX[NeighborX][NeighborY] = -OffsetX;
+				Field->NextY[NeighborX][NeighborY] = -OffsetY;
+				if(Waypoints[NeighborX][NeighborY] != -1){
+					Queue.insert(NeighborWaylength, NeighborX * FLOWFIELD_SIZE + NeighborY);
+				}
+			}
+		}
+	}
+}
+
+static TFlowField *GetFlowField(TMonster *Monster, TMoveProfile *Profile,
+		int DestX, int DestY, int DestZ){
+	uint32 Revision[2][2];
+	GetFlowFieldRevision(DestX, DestY, DestZ, Revision);
+
+	FlowFieldUseCounter += 1;
+	TFlowField *Oldest = &FlowField[0];
+	for(int i = 0; i < NARRAY(FlowField); i += 1){
+		TFlowField *Field = &FlowField[i];
+		if(Field->Expiry > ServerMilliseconds
+				&& Field->DestX == DestX
+				&& Field->DestY == DestY
+				&& Field->DestZ == DestZ
+				&& Field->Profile == *Profile
+				&& memcmp(Field->Revision, Revision, sizeof(Revision)) == 0){
+			Field->LastUse = FlowFieldUseCounter;
+			return Field;
+		}
+
+		if(Field->LastUse < Oldest->LastUse){
+			Oldest = Field;
+		}
+	}
+
+	TFlowField *Field = Oldest;
+	Field->DestX = DestX;
+	Field->DestY = DestY;
+	Field->DestZ = DestZ;
+	Field->Profile = *Profile;
+	Field->Expiry = ServerMilliseconds + FLOWFIELD_LIFETIME;
+	Field->LastUse = FlowFieldUseCounter;
+	memcpy(Field->Revision, Revision, sizeof(Revision));
+	CalculateFlowField(Field, Monster);
+	return Field;
+}
+
+// NOTE(fusion): Queues the path to the destination from a shared flow field,
+// the same way `TShortway::Calculate` would. Returns false if the flow field
+// can't be used, in which case the caller should fall back to `TShortway`.
+static bool FlowFieldGo(TCreature *Creature, int DestX, int DestY, int DestZ, int MaxSteps){
+	if(!ChaseFlowFields || Creature->Type != MONSTER){
+		return false;
+	}
+
+	TMoveProfile Profile;
+	TMonster *Monster = (TMonster*)Creature;
+	if(!Monster->GetMoveProfile(&Profile)){
+		return false;
+	}
+
+	int X = Creature->posx - DestX + FLOWFIELD_RADIUS;
+	int Y = Creature->posy - DestY + FLOWFIELD_RADIUS;
+	if(X < 0 || X >= FLOWFIELD_SIZE || Y < 0 || Y >= FLOWFIELD_SIZE){
+		return false;
+	}
+
+	TFlowField *Field = GetFlowField(Monster, &Profile, DestX, DestY, DestZ);
+	if(Field->Waylength[X][Y] == INT_MAX){
+		return false;
+	}
+
+	int CurDistance = std::max<int>(
+			std::abs(X - FLOWFIELD_RADIUS),
+			std::abs(Y - FLOWFIELD_RADIUS));
+	while(MaxSteps > 0 && CurDistance > 1){
+		int NextX = X + Field->NextX[X][Y];
+		int NextY = Y + Field->NextY[X][Y];
+		X = NextX;
+		Y = NextY;
+		if(X == FLOWFIELD_RADIUS && Y == FLOWFIELD_RADIUS){
+			break;
+		}
+
+		TToDoEntry TD = {};
+		TD.Code = TDGo;
+		TD.Go.x = DestX + X - FLOWFIELD_RADIUS;
+		TD.Go.y = DestY + Y - FLOWFIELD_RADIUS;
+		TD.Go.z = DestZ;
+		Creature->ToDoAdd(TD);
+
+		CurDistance = std::max<int>(
+			std::abs(X - FLOWFIELD_RADIUS),
+			std::abs(Y - FLOWFIELD_RADIUS));
+		MaxSteps -= 1;
+	}
+
+	return true;
+}
+
+// Long Distance Paths
+// =============================================================================
+// NOTE(fusion): `TShortway` only covers a small area around the creature, so
+// destinations outside of it would always fail. For those, we first search an
+// abstract graph whose nodes are portals between neighboring sectors (a pair of
+// passable fields across the sector border, one per run of such pairs) and whose
+// edges are the costs of walking between portals inside a sector. Then we use
+// `TShortway` to walk the part of the route that is inside the local area, which
+// takes care of creature specific rules. Only that first leg is queued, so this
+// is only used by callers that ask again on every decision, like monsters
+// chasing a target (see `ToDoGo`). Anything queued behind a walk would otherwise
+// run at the end of the first leg, still out of range.
+//	Sector data is computed when first needed and recomputed when the sector, or
+// one of its neighbors for portals, changes (see `GetSectorRevision`). It only
+// considers static passability: a walkable ground without any blocking objects
+// that can't be moved. Sectors that are swapped out are treated as impassable
+// rather than loaded back from disk, until they're loaded for some other reason.
+// Searches are limited to a single floor.
+#define PATH_SECTOR_CACHE 1024
+#define PATH_SIDE_PORTALS 8
+#define PATH_MAX_PORTALS (4 * PATH_SIDE_PORTALS)
+#define PATH_MAX_NODES 4096
+#define PATH_MAX_DISTANCE 256
+
+struct TPathSector {
+	bool Used;
+	bool Loaded;
+	bool PortalsValid;
+	int SectorX;
+	int SectorY;
+	int SectorZ;
+	uint32 Revision;
+	uint32 NeighborRevision[4];
+	bool NeighborLoaded[4];
+	uint16 Waypoints[32][32];
+	int Portals;
+	uint8 PortalX[PATH_MAX_PORTALS];
+	uint8 PortalY[PATH_MAX_PORTALS];
+	uint32 CostValid;
+	int Cost[PATH_MAX_PORTALS][PATH_MAX_PORTALS];
+};
+
+struct TPathNode {
+	int x;
+	int y;
+	int Waylength;
+	int Predecessor;
+	bool Expanded;
+};
+
+static TPathSector *PathSector;
+static int PathMinWaypoints = INT_MAX;
+
+static int PathSearches;
+static int PathFailures;
+static int PathExpandedNodes;
+static int64 PathTimeTotal;
+static int64 PathTimeMax;
+
+static const int PathSideOffsetX[4] = { 0, 1, 0, -1};
+static const int PathSideOffsetY[4] = {-1, 0, 1,  0};
+
+static int GetStaticWaypoints(int x, int y, int z){
+	Object Obj = GetFirstObject(x, y, z);
+	if(!Obj.exists()){
+		return 0;
+	}
+
+	ObjectType ObjType = Obj.getObjectType();
+	if(!ObjType.getFlag(BANK) || ObjType.getFlag(UNPASS)){
+		return 0;
+	}
+
+	int Waypoints = (int)ObjType.getAttribute(WAYPOINTS);
+	if(Waypoints <= 0){
+		return 0;
+	}
+
+	for(Obj = Obj.getNextObject(); Obj != NONE; Obj = Obj.getNextObject()){
+		ObjectType ObjType = Obj.getObjectType();
+		if(!ObjType.isCreatureContainer()
+				&& ObjType.getFlag(UNPASS)
+				&& ObjType.getFlag(UNMOVE)){
+			return 0;
+		}
+	}
+
+	return std::min<int>(Waypoints, UINT16_MAX);
+}
+
+// NOTE(fusion): Neighboring sectors in the same floor never share a slot, which
+// means fetching a neighbor won't evict the sector we're working on. The floor
+// is mixed in with an odd multiplier, which keeps that true for each floor while
+// spreading the same area of different floors over different slots.
+static TPathSector *GetPathSector(int SectorX, int SectorY, int SectorZ){
+	if(PathSector == NULL){
+		PathSector = (TPathSector*)calloc(PATH_SECTOR_CACHE, sizeof(TPathSector));
+	}
+
+	int Slot = ((SectorX & 31) | ((SectorY & 31) << 5))
+			^ ((SectorZ * 757) & (PATH_SECTOR_CACHE - 1));
+	TPathSector *Sec = &PathSector[Slot];
+	uint32 Revision = GetSectorRevision(SectorX, SectorY, SectorZ);
+	bool Loaded = SectorLoaded(SectorX, SectorY, SectorZ);
+	if(!Sec->Used || Sec->SectorX != SectorX || Sec->SectorY != SectorY
+			|| Sec->SectorZ != SectorZ || Sec->Revision != Revision
+			|| Sec->Loaded != Loaded){
+		Sec->Used = true;
+		Sec->Loaded = Loaded;
+		Sec->PortalsValid = false;
+		Sec->SectorX = SectorX;
+		Sec->SectorY = SectorY;
+		Sec->SectorZ = SectorZ;
+		Sec->Revision = Revision;
+		for(int X = 0; X < 32; X += 1)
+		for(int Y = 0; Y < 32; Y += 1){
+			int Waypoints = 0;
+			if(Loaded){
+				Waypoints = GetStaticWaypoints(SectorX * 32 + X, SectorY * 32 + Y, SectorZ);
+			}
+			if(Waypoints > 0 && Waypoints < PathMinWaypoints){
+				PathMinWaypoints = Waypoints;
+			}
+			Sec->Waypoints[X][Y] = (uint16)Waypoints;
+		}
+	}
+
+	return Sec;
+}
+
+static void GetBorderField(int Side, int Index, bool Inside, int *X, int *Y){
+	// NOTE(fusion): `Inside` selects the border of the sector itself, otherwise
+	// the facing border of the neighbor on `Side`.
+	switch(Side){
+		case 0:	*X = Index; *Y = (Inside ?  0 : 31); break;
+		case 1:	*X = (Inside ? 31 :  0); *Y = Index; break;
+		case 2:	*X = Index; *Y = (Inside ? 31 :  0); break;
+		default: *X = (Inside ?  0 : 31); *Y = Index; break;
+	}
+}
+
+static TPathSector *GetPathSectorPortals(int SectorX, int SectorY, int SectorZ){
+	TPathSector *Sec = GetPathSector(SectorX, SectorY, SectorZ);
+	uint32 NeighborRevision[4];
+	bool NeighborLoaded[4];
+	for(int Side = 0; Side < 4; Side += 1){
+		NeighborRevision[Side] = GetSectorRevision(
+				SectorX + PathSideOffsetX[Side],
+				SectorY + PathSideOffsetY[Side],
+				SectorZ);
+		NeighborLoaded[Side] = SectorLoaded(
+				SectorX + PathSideOffsetX[Side],
+				SectorY + PathSideOffsetY[Side],
+				SectorZ);
+	}
+
+	if(Sec->PortalsValid
+			&& memcmp(Sec->NeighborRevision, NeighborRevision, sizeof(NeighborRevision)) == 0
+			&& memcmp(Sec->NeighborLoaded, NeighborLoaded, sizeof(NeighborLoaded)) == 0){
+		return Sec;
+	}
+
+	Sec->Portals = 0;
+	for(int Side = 0; Side < 4; Side += 1){
+		TPathSector *Neighbor = GetPathSector(
+				SectorX + PathSideOffsetX[Side],
+				SectorY + PathSideOffsetY[Side],
+				SectorZ);
+
+		// NOTE(fusion): Both sectors see the same runs of passable pairs, so
+		// they will agree on where portals are.
+		int SidePortals = 0;
+		int RunStart = -1;
+		for(int Index = 0; Index <= 32; Index += 1){
+			bool Passable = false;
+			if(Index < 32){
+				int InsideX, InsideY, OutsideX, OutsideY;
+				GetBorderField(Side, Index, true, &InsideX, &InsideY);
+				GetBorderField(Side, Index, false, &OutsideX, &OutsideY);
+				Passable = Sec->Waypoints[InsideX][InsideY] != 0
+						&& Neighbor->Waypoints[OutsideX][OutsideY] != 0;
+			}
+
+			if(Passable && RunStart == -1){
+				RunStart = Index;
+			}else if(!Passable && RunStart != -1){
+				if(SidePortals < PATH_SIDE_PORTALS){
+					int PortalX, PortalY;
+					GetBorderField(Side, (RunStart + Index - 1) / 2, true, &PortalX, &PortalY);
+					Sec->PortalX[Sec->Portals] = (uint8)PortalX;
+					Sec->PortalY[Sec->Portals] = (uint8)PortalY;
+					Sec->Portals += 1;
+					SidePortals += 1;
+				}
+				RunStart = -1;
+			}
+		}
+	}
+
+	Sec->PortalsValid = true;
+	Sec->CostValid = 0;
+	memcpy(Sec->NeighborRevision, NeighborRevision, sizeof(NeighborRevision));
+	memcpy(Sec->NeighborLoaded, NeighborLoaded, sizeof(NeighborLoaded));
+	return Sec;
+}
+
+// NOTE(fusion): Shortest paths from a single field to the rest of the sector,
+// using the same step costs as `TShortway`.
+static void CalculateSectorPaths(TPathSector *Sec, int StartX, int StartY,
+		int (*Waylength)[32], int (*Predecessor)[32]){
+	for(int X = 0; X < 32; X += 1)
+	for(int Y = 0; Y < 32; Y += 1){
+		Waylength[X][Y] = INT_MAX;
+		if(Predecessor != NULL){
+			Predecessor[X][Y] = -1;
+		}
+	}
+
+	priority_queue<int, int> Queue(1024, 1024);
+	Waylength[StartX][StartY] = 0;
+	Queue.insert(0, StartX * 32 + StartY);
+	while(Queue.Entries > 0){
+		priority_queue_entry<int, int> *Min = Queue.Entry->at(1);
+		int NodeWaylength = Min->Key;
+		int NodeX = Min->Data / 32;
+		int NodeY = Min->Data % 32;
+		Queue.deleteMin();
+
+		if(NodeWaylength != Waylength[NodeX][NodeY]){
+			continue;
+		}
+
+		for(int OffsetX = -1; OffsetX <= 1; OffsetX += 1)
+		for(int OffsetY = -1; OffsetY <= 1; OffsetY += 1){
+			int NeighborX = NodeX + OffsetX;
+			int NeighborY = NodeY + OffsetY;
+			if((OffsetX == 0 && OffsetY == 0)
+					|| NeighborX < 0 || NeighborX >= 32
+					|| NeighborY < 0 || NeighborY >= 32
+					|| Sec->Waypoints[NeighborX][NeighborY] == 0){
+				continue;
+			}
+
+			int NeighborWaylength = NodeWaylength + Sec->Waypoints[NeighborX][NeighborY];
+			if(OffsetX != 0 && OffsetY != 0){
+				NeighborWaylength += Sec->Waypoints[NeighborX][NeighborY] * 2;
+			}
+
+			if(NeighborWaylength < Waylength[NeighborX][NeighborY]){
+				Waylength[NeighborX][NeighborY] = NeighborWaylength;
+				if(Predecessor != NULL){
+					Predecessor[NeighborX][NeighborY] = NodeX * 32 + NodeY;
+				}
+				Queue.insert(NeighborWaylength, NeighborX * 32 + NeighborY);
+			}
+		}
+	}
+}
+
+static int *GetPortalCosts(TPathSector *Sec, int Portal){
+	if((Sec->CostValid & ((uint32)1 << Portal)) == 0){
+		int Waylength[32][32];
+		CalculateSectorPaths(Sec, Sec->PortalX[Portal], Sec->PortalY[Portal], Waylength, NULL);
+		for(int Other = 0; Other < Sec->Portals; Other += 1){
+			Sec->Cost[Portal][Other] = Waylength[Sec->PortalX[Other]][Sec->PortalY[Other]];
+		}
+		Sec->CostValid |= ((uint32)1 << Portal);
+	}
+
+	return Sec->Cost[Portal];
+}
+
+static int FindPortal(TPathSector *Sec, int OffsetX, int OffsetY){
+	for(int Portal = 0; Portal < Sec->Portals; Portal += 1){
+		if(Sec->PortalX[Portal] == OffsetX && Sec->PortalY[Portal] == OffsetY){
+			return Portal;
+		}
+	}
+	return -1;
+}
+
+struct TPathSearch {
+	TPathNode Node[PATH_MAX_NODES];
+	int Nodes;
+	int Slot[2 * PATH_MAX_NODES];
+	priority_queue<int, int> *Queue;
+	int GoalX;
+	int GoalY;
+};
+
+static int GetPathNode(TPathSearch *Search, int x, int y){
+	uint32 Hash = ((uint32)x * 73856093U) ^ ((uint32)y * 19349663U);
+	int Index = (int)(Hash % NARRAY(Search->Slot));
+	while(Search->Slot[Index] != -1){
+		TPathNode *Node = &Search->Node[Search->Slot[Index]];
+		if(Node->x == x && Node->y == y){
+			return Search->Slot[Index];
+		}
+		Index = (Index + 1) % NARRAY(Search->Slot);
+	}
+
+	if(Search->Nodes >= PATH_MAX_NODES){
+		return -1;
+	}
+
+	int Result = Search->Nodes;
+	Search->Slot[Index] = Result;
+	Search->Node[Result].x = x;
+	Search->Node[Result].y = y;
+	Search->Node[Result].Waylength = INT_MAX;
+	Search->Node[Result].Predecessor = -1;
+	Search->Node[Result].Expanded = false;
+	Search->Nodes += 1;
+	return Result;
+}
+
+static void RelaxPathNode(TPathSearch *Search, int From, int x, int y, int Cost){
+	if(Cost == INT_MAX){
+		return;
+	}
+
+	int To = GetPathNode(Search, x, y);
+	if(To == -1){
+		return;
+	}
+
+	int Waylength = Search->Node[From].Waylength + Cost;
+	if(Waylength < Search->Node[To].Waylength && !Search->Node[To].Expanded){
+		Search->Node[To].Waylength = Waylength;
+		Search->Node[To].Predecessor = From;
+		int Distance = std::abs(x - Search->GoalX) + std::abs(y - Search->GoalY);
+		int MinWaypoints = (PathMinWaypoints != INT_MAX) ? PathMinWaypoints : 0;
+		Search->Queue->insert(Waylength + Distance * MinWaypoints, To);
+	}
+}
+
+// NOTE(fusion): Returns the number of waypoints written to `PathX` and `PathY`,
+// from the first portal to the destination, or -1 if there is no route.
+static int SearchLongDistancePath(int StartX, int StartY, int DestX, int DestY, int z,
+		int (*StartPredecessor)[32], int *PathX, int *PathY, int MaxPath){
+	int StartSectorX = StartX / 32;
+	int StartSectorY = StartY / 32;
+	int DestSectorX = DestX / 32;
+	int DestSectorY = DestY / 32;
+
+	int StartWaylength[32][32];
+	int DestWaylength[32][32];
+	TPathSector *Sec = GetPathSector(DestSectorX, DestSectorY, z);
+	CalculateSectorPaths(Sec, DestX % 32, DestY % 32, DestWaylength, NULL);
+	Sec = GetPathSectorPortals(StartSectorX, StartSectorY, z);
+	CalculateSectorPaths(Sec, StartX % 32, StartY % 32, StartWaylength, StartPredecessor);
+
+	TPathSearch *Search = new TPathSearch;
+	priority_queue<int, int> Queue(1024, 1024);
+	memset(Search->Slot, -1, sizeof(Search->Slot));
+	Search->Nodes = 0;
+	Search->Queue = &Queue;
+	Search->GoalX = DestX;
+	Search->GoalY = DestY;
+
+	// NOTE(fusion): The start node is queued as well, in case it is a portal.
+	int Start = GetPathNode(Search, StartX, StartY);
+	Search->Node[Start].Waylength = 0;
+	Queue.insert(0, Start);
+	for(int Portal = 0; Portal < Sec->Portals; Portal += 1){
+		int PortalX = Sec->PortalX[Portal];
+		int PortalY = Sec->PortalY[Portal];
+		RelaxPathNode(Search, Start, StartSectorX * 32 + PortalX,
+				StartSectorY * 32 + PortalY, StartWaylength[PortalX][PortalY]);
+	}
+
+	if(StartSectorX == DestSectorX && StartSectorY == DestSectorY){
+		RelaxPathNode(Search, Start, DestX, DestY, StartWaylength[DestX % 32][DestY % 32]);
+	}
+
+	int Goal = -1;
+	while(Queue.Entries > 0){
+		int Current = Queue.Entry->at(1)->Data;
+		Queue.deleteMin();
+
+		TPathNode *Node = &Search->Node[Current];
+		if(Node->Expanded){
+			continue;
+		}
+
+		Node->Expanded = true;
+		PathExpandedNodes += 1;
+		if(Node->x == DestX && Node->y == DestY){
+			Goal = Current;
+			break;
+		}
+
+		int NodeX = Node->x;
+		int NodeY = Node->y;
+		int SectorX = NodeX / 32;
+		int SectorY = NodeY / 32;
+		if(std::abs(NodeX - StartX) > PATH_MAX_DISTANCE
+				|| std::abs(NodeY - StartY) > PATH_MAX_DISTANCE){
+			continue;
+		}
+
+		Sec = GetPathSectorPortals(SectorX, SectorY, z);
+		int Portal = FindPortal(Sec, NodeX % 32, NodeY % 32);
+		if(Portal == -1){
+			continue;
+		}
+
+		if(SectorX == DestSectorX && SectorY == DestSectorY){
+			RelaxPathNode(Search, Current, DestX, DestY, DestWaylength[NodeX % 32][NodeY % 32]);
+		}
+
+		int *Cost = GetPortalCosts(Sec, Portal);
+		for(int Other = 0; Other < Sec->Portals; Other += 1){
+			if(Other != Portal){
+				RelaxPathNode(Search, Current,
+						SectorX * 32 + Sec->PortalX[Other],
+						SectorY * 32 + Sec->PortalY[Other],
+						Cost[Other]);
+			}
+		}
+
+		// NOTE(fusion): Cross the border. Portals are always on the border so
+		// exactly one neighbor field is outside of the sector, except for corners
+		// where we'll check both.
+		for(int Side = 0; Side < 4; Side += 1){
+			int OtherX = NodeX + PathSideOffsetX[Side];
+			int OtherY = NodeY + PathSideOffsetY[Side];
+			if(OtherX / 32 == SectorX && OtherY / 32 == SectorY){
+				continue;
+			}
+
+			TPathSector *Other = GetPathSectorPortals(OtherX / 32, OtherY / 32, z);
+			if(FindPortal(Other, OtherX % 32, OtherY % 32) != -1){
+				RelaxPathNode(Search, Current, OtherX, OtherY,
+						Other->Waypoints[OtherX % 32][OtherY % 32]);
+			}
+		}
+	}
+
+	int Result = -1;
+	if(Goal != -1){
+		int Count = 0;
+		for(int Cur = Goal; Cur != Start; Cur = Search->Node[Cur].Predecessor){
+			Count += 1;
+		}
+
+		if(Count <= MaxPath){
+			int Index = Count;
+			for(int Cur = Goal; Cur != Start; Cur = Search->Node[Cur].Predecessor){
+				Index -= 1;
+				PathX[Index] = Search->Node[Cur].x;
+				PathY[Index] = Search->Node[Cur].y;
+			}
+			Result = Count;
+		}
+	}
+
+	delete Search;
+	return Result;
+}
+
+static bool LongDistanceGo(TCreature *Creature, int VisibleX, int VisibleY,
+		int DestX, int DestY, int DestZ, bool MustReach, int MaxSteps){
+	int StartX = Creature->posx;
+	int StartY = Creature->posy;
+	if(std::abs(DestX - StartX) > PATH_MAX_DISTANCE
+			|| std::abs(DestY - StartY) > PATH_MAX_DISTANCE){
+		return false;
+	}
+
+	int64 StartTime = GetMonotonicMicroseconds();
+	int StartPredecessor[32][32];
+	int PathX[256];
+	int PathY[256];
+	int PathLength = SearchLongDistancePath(StartX, StartY, DestX, DestY, DestZ,
+			StartPredecessor, PathX, PathY, NARRAY(PathX));
+
+	int64 Time = GetMonotonicMicroseconds() - StartTime;
+	PathSearches += 1;
+	PathTimeTotal += Time;
+	if(PathTimeMax < Time){
+		PathTimeMax = Time;
+	}
+
+	if(PathLength <= 0){
+		PathFailures += 1;
+		return false;
+	}
+
+	// NOTE(fusion): Pick the furthest point of the route that is still inside
+	// the local area. The route up to the first waypoint is known field by field
+	// because it is inside the start sector, after that we only know waypoints.
+	int LegX = StartX;
+	int LegY = StartY;
+	{
+		int SectorOriginX = (StartX / 32) * 32;
+		int SectorOriginY = (StartY / 32) * 32;
+		int RouteX[1024];
+		int RouteY[1024];
+		int Route = 0;
+		int Current = (PathX[0] - SectorOriginX) * 32 + (PathY[0] - SectorOriginY);
+		if(PathX[0] / 32 == StartX / 32 && PathY[0] / 32 == StartY / 32){
+			while(Current != -1 && Route < NARRAY(RouteX)){
+				RouteX[Route] = SectorOriginX + Current / 32;
+				RouteY[Route] = SectorOriginY + Current % 32;
+				Route += 1;
+				Current = StartPredecessor[Current / 32][Current % 32];
+			}
+		}
+
+		bool Inside = true;
+		for(int i = Route - 1; i >= 0 && Inside; i -= 1){
+			Inside = std::abs(RouteX[i] - StartX) <= VisibleX
+				&& std::abs(RouteY[i] - StartY) <= VisibleY;
+			if(Inside){
+				LegX = RouteX[i];
+				LegY = RouteY[i];
+			}
+		}
+
+		for(int i = 1; i < PathLength && Inside; i += 1){
+			Inside = std::abs(PathX[i] - StartX) <= VisibleX
+				&& std::abs(PathY[i] - StartY) <= VisibleY;
+			if(Inside){
+				LegX = PathX[i];
+				LegY = PathY[i];
+			}
+		}
+	}
+
+	if(LegX == StartX && LegY == StartY){
+		PathFailures += 1;
+		return false;
+	}
+
+	bool FinalLeg = (LegX == DestX && LegY == DestY);
+	TShortway Shortway(Creature, VisibleX, VisibleY);
+	return Shortway.Calculate(LegX, LegY, (FinalLeg ? MustReach : true), MaxSteps);
+}
+
+void PathfindingSummary(void){
+	if(PathSearches > 0){
+		Log("game", "Long distance paths: %d searches, %d failed, %d nodes expanded.\n",
+				PathSearches, PathFailures, PathExpandedNodes);
+		Log("game", "Long distance paths: average %d usec, max %d usec.\n",
+				(int)(PathTimeTotal / PathSearches), (int)PathTimeMax);
+	}
+
+	PathSearches = 0;
+	PathFailures = 0;
+	PathExpandedNodes = 0;
+	PathTimeTotal = 0;
+	PathTimeMax = 0;
+}
+
 // TCreature
 // =============================================================================
 bool TCreature::SetOnMap(void){
@@ -637,20 +1394,9 @@ void TCreature::Trade(Object Obj, uint32 PartnerID){
 
 	// NOTE(fusion): Check if one object is contained by the other.
 	if(Partner->TradeObject != NONE){
-		Object Help = Partner->TradeObject;
-		while(Help != NONE && !Help.getObjectType().isMapContainer()){
-			if(Help == Obj){
-				throw NOTACCESSIBLE;
-			}
-			Help = Help.getContainer();
-		}
-
-		Help = Obj;
-		while(Help != NONE && !Help.getObjectType().isMapContainer()){
-			if(Help == Partner->TradeObject){
-				throw NOTACCESSIBLE;
-			}
-			Help = Help.getContainer();
+		if(IsHeldByContainer(Partner->TradeObject, Obj)
+				|| IsHeldByContainer(Obj, Partner->TradeObject)){
+			throw NOTACCESSIBLE;
 		}
 	}
 
@@ -746,7 +1492,7 @@ void TCreature::Execute(void){
 				}
 			}else{
 				this->NextWakeup = ServerMilliseconds + Delay;
-				ToDoQueue.insert(this->NextWakeup, this->ID);
+				InsertToDoQueue(this, this->NextWakeup);
 			}
 			break;
 		}
@@ -930,6 +1676,7 @@ bool TCreature::ToDoClear(void){
 	this->ActToDo = 0;
 	this->NrToDo = 0;
 	this->Stop = false;
+	this->ToDoGeneration += 1;
 	return SnapbackNecessary;
 }
 
@@ -963,7 +1710,7 @@ void TCreature::ToDoStart(void){
 		}
 
 		uint32 NextWakeup = ServerMilliseconds + Delay;
-		ToDoQueue.insert(NextWakeup, this->ID);
+		InsertToDoQueue(this, NextWakeup);
 		this->NextWakeup = NextWakeup;
 	}
 }
@@ -990,6 +1737,11 @@ void TCreature::ToDoWaitUntil(uint32 Time){
 }
 
 void TCreature::ToDoGo(int DestX, int DestY, int DestZ, bool MustReach, int MaxSteps){
+	this->ToDoGo(DestX, DestY, DestZ, MustReach, MaxSteps, false);
+}
+
+void TCreature::ToDoGo(int DestX, int DestY, int DestZ, bool MustReach, int MaxSteps,
+		bool LongDistance){
 	if(this->posz > DestZ){
 		throw UPSTAIRS;
 	}else if(this->posz < DestZ){
@@ -1024,11 +1776,19 @@ void TCreature::ToDoGo(int DestX, int DestY, int DestZ, bool MustReach, int MaxS
 		TD.Go.y = DestY;
 		TD.Go.z = DestZ;
 		this->ToDoAdd(TD);
-	}else{
+	}else if(MustReach || !FlowFieldGo(this, DestX, DestY, DestZ, MaxSteps)){
 		int VisibleX = (this->Type == PLAYER) ? 7 : 10;
 		int VisibleY = (this->Type == PLAYER) ? 7 : 10;
-		TShortway Shortway(this, VisibleX, VisibleY);
-		if(!Shortway.Calculate(DestX, DestY, MustReach, MaxSteps)){
+		bool Found = false;
+		if(LongDistance && (DistanceX > VisibleX || DistanceY > VisibleY)){
+			Found = LongDistanceGo(this, VisibleX, VisibleY,
+					DestX, DestY, DestZ, MustReach, MaxSteps);
+		}else{
+			TShortway Shortway(this, VisibleX, VisibleY);
+			Found = Shortway.Calculate(DestX, DestY, MustReach, MaxSteps);
+		}
+
+		if(!Found){
 			this->ToDoClear();
 			if(this->Type == PLAYER){
 				SendSnapback(this->Connection);
@@ -495,11 +495,11 @@ void TCombat::CanToDoAttack(void){
 
 	if(ChaseMode == CHASE_MODE_CLOSE){
 		if(Distance > 1){
-			Master->ToDoGo(Target->posx, Target->posy, Target->posz, false, 3);
+			Master->ToDoGo(Target->posx, Target->posy, Target->posz, false, 3, true);
 		}
 	}else if(ChaseMode == CHASE_MODE_RANGE){
 		if(Distance > 4){
-			Master->ToDoGo(Target->posx, Target->posy, Target->posz, false, Distance - 4);
+			Master->ToDoGo(Target->posx, Target->posy, Target->posz, false, Distance - 4, true);
 		}else if(Distance < 4){
 			int DestX, DestY, DestZ;
 			if(SearchFlightField(Master->ID, Target->ID, &DestX, &DestY, &DestZ)){
@@ -3,19 +3,74 @@
 #include "config.hh"
 #include "enums.hh"
 #include "info.hh"
+#include "moveuse.hh"
 #include "operate.hh"
 #include "writer.hh"
 
 #include <dirent.h>
 
 TRaceData RaceData[MAX_RACES];
-priority_queue<uint32, uint32> ToDoQueue(5000, 1000);
-
-static TCreature *HashList[1000];
+uint32 SkillTimerRound;
+
+// NOTE(fusion): Creature wakeups are kept in a calendar queue. Those within
+// `TODO_QUEUE_WINDOW` milliseconds of `ToDoQueueCursor` go into one bucket per
+// millisecond, which is a FIFO list of nodes taken from `ToDoQueueNodes`, and
+// anything further goes into `ToDoQueueFar` until the window reaches it. Far
+// entries are keyed by time and insertion sequence and are moved into their
+// bucket as soon as the window covers them, before any direct insertion for
+// the same millisecond can happen, so wakeups for the same millisecond always
+// run in insertion order.
+#define TODO_QUEUE_WINDOW 4096
+
+struct TToDoQueueRef{
+	uint32 CreatureID;
+	uint32 Generation;
+};
+
+struct TToDoQueueNode{
+	TToDoQueueRef Ref;
+	int Next;
+};
+
+static uint32 ToDoQueueCursor;
+static uint32 ToDoQueueSequence;
+static int ToDoQueueNear;
+static int ToDoQueueHead[TODO_QUEUE_WINDOW];
+static int ToDoQueueTail[TODO_QUEUE_WINDOW];
+static TToDoQueueNode *ToDoQueueNodes;
+static int ToDoQueueCapacity;
+static int ToDoQueueFreeNode = -1;
+static priority_queue<uint64, TToDoQueueRef> ToDoQueueFar(1000, 1000);
+
+// NOTE(fusion): Creatures are indexed by ID with an open addressed table using
+// linear probing. Deletion shifts following entries back instead of leaving
+// tombstones, so probe sequences only depend on the current population. The
+// table doubles whenever it would be more than half full. Duplicate IDs, which
+// `SetID` tolerates, are stored in different slots with the newest one first in
+// probe order, so `GetCreature` returns the newest creature like the old hash
+// chains did.
+static TCreature **CreatureTable;
+static int CreatureTableSize;
+static int CreatureTableShift;
+static int CreatureTableEntries;
+static uint32 CreatureTableLookups;
+static uint32 CreatureTableProbes;
 static matrix<uint32> *FirstChainCreature;
+static matrix<uint32> *ChainRevision;
+static uint32 NextChainRevision;
 static vector<TCreature*> CreatureList(0, 10000, 1000, NULL);
 static int FirstFreeCreature;
 static uint32 NextCreatureID;
+static int ActiveMonsters;
+static int DormantMonsters;
+static uint32 DormantVisitsSkipped;
+static priority_queue<uint32, uint32> SkillTimerQueue(1000, 1000);
+static vector<uint64> SkillTimerBatch(0, 1000, 1000);
+static bool SkillTimerPass;
+static TCreature *SkillTimerCreature;
+static uint32 SkillTimerRounds;
+static uint32 SkillTimerVisits;
+static uint32 SkillTimerTicks;
 
 static int KilledCreatures[MAX_RACES];
 static int KilledPlayers[MAX_RACES];
@@ -115,16 +170,304 @@ uint32 TFindCreatures::getNext(void){
 	}
 }
 
+// TFindTargets
+// =============================================================================
+// NOTE(fusion): Direct mapped cache of target candidates for each 16x16 block
+// of the creature chain. Every change to a block's chain, including creatures
+// moving inside it, gives the block a new revision. A cached entry is only
+// valid while it holds the block's current revision, so the candidates always
+// show the same positions and chain order `TFindCreatures` would. Crowded
+// blocks don't fit into an entry and are walked directly instead.
+#define TARGET_BLOCK_CACHE_SIZE 256
+#define TARGET_BLOCK_CANDIDATES 32
+struct TTargetBlock {
+	int BlockX;
+	int BlockY;
+	uint32 Revision;
+	int Candidates;
+	TTargetCandidate Candidate[TARGET_BLOCK_CANDIDATES];
+};
+
+static TTargetBlock TargetBlockCache[TARGET_BLOCK_CACHE_SIZE];
+static uint32 TargetBlockHits;
+static uint32 TargetBlockMisses;
+static uint32 TargetBlockOverflows;
+
+static void TouchChainBlock(int ChainX, int ChainY){
+	uint32 *Revision = ChainRevision->boundedAt(ChainX, ChainY);
+	if(Revision != NULL){
+		NextChainRevision += 1;
+		if(NextChainRevision == 0){
+			NextChainRevision = 1;
+		}
+		*Revision = NextChainRevision;
+	}
+}
+
+static bool GetTargetCandidate(TCreature *Creature, TTargetCandidate *Candidate){
+	if(Creature->Type != PLAYER && Creature->Type != MONSTER){
+		return false;
+	}
+
+	Candidate->ID = Creature->ID;
+	Candidate->x = Creature->posx;
+	Candidate->y = Creature->posy;
+	Candidate->z = Creature->posz;
+	Candidate->Type = Creature->Type;
+	Candidate->Protected = IsProtectionZone(Creature->posx, Creature->posy, Creature->posz)
+						|| IsHouse(Creature->posx, Creature->posy, Creature->posz);
+	Candidate->Ignored = Creature->Type == PLAYER
+						&& CheckRight(Creature->ID, IGNORED_BY_MONSTERS);
+	return true;
+}
+
+static TTargetBlock *GetTargetBlock(int BlockX, int BlockY){
+	uint32 *Revision = ChainRevision->boundedAt(BlockX, BlockY);
+	if(Revision == NULL){
+		return NULL;
+	}
+
+	int Slot = (BlockX & 15) | ((BlockY & 15) << 4);
+	TTargetBlock *Block = &TargetBlockCache[Slot];
+	if(Block->Revision == *Revision && Block->BlockX == BlockX && Block->BlockY == BlockY){
+		TargetBlockHits += 1;
+		return Block;
+	}
+
+	TargetBlockMisses += 1;
+	Block->BlockX = BlockX;
+	Block->BlockY = BlockY;
+	Block->Revision = 0;
+	Block->Candidates = 0;
+	uint32 CreatureID = *FirstChainCreature->at(BlockX, BlockY);
+	while(CreatureID != 0){
+		TCreature *Creature = GetCreature(CreatureID);
+		if(Creature == NULL){
+			error("GetTargetBlock: Creature does not exist.\n");
+			break;
+		}
+
+		CreatureID = Creature->NextChainCreature;
+		if(Creature->Type != PLAYER && Creature->Type != MONSTER){
+			continue;
+		}
+
+		if(Block->Candidates >= TARGET_BLOCK_CANDIDATES){
+			TargetBlockOverflows += 1;
+			return NULL;
+		}
+
+		GetTargetCandidate(Creature, &Block->Candidate[Block->Candidates]);
+		Block->Candidates += 1;
+	}
+
+	Block->Revision = *Revision;
+	return Block;
+}
+
+TFindTargets::TFindTargets(int RadiusX, int RadiusY, uint32 CreatureID){
+	this->ActID = 0;
+	this->SkipID = 0;
+	this->Block = NULL;
+	this->BlockCandidates = 0;
+	this->BlockIndex = 0;
+	this->Uncached = false;
+	this->Current = {};
+	this->finished = false;
+
+	TCreature *Creature = GetCreature(CreatureID);
+	if(Creature == NULL){
+		error("TFindTargets::TFindTargets: Creature does not exist.\n");
+		this->finished = true;
+		return;
+	}
+
+	this->startx = Creature->posx - RadiusX;
+	this->starty = Creature->posy - RadiusY;
+	this->endx = Creature->posx + RadiusX;
+	this->endy = Creature->posy + RadiusY;
+	// NOTE(fusion): Same traversal as `TFindCreatures`.
+	this->blockx = (this->startx / 16) - 1;
+	this->blocky = (this->starty / 16);
+	this->SkipID = Creature->ID;
+}
+
+TTargetCandidate *TFindTargets::getNext(void){
+	if(this->finished){
+		return NULL;
+	}
+
+	int StartBlockX = this->startx / 16;
+	int EndBlockX = this->endx / 16;
+	int EndBlockY = this->endy / 16;
+	while(true){
+		TTargetCandidate *Candidate = NULL;
+		if(this->Uncached){
+			if(this->ActID == 0){
+				this->Uncached = false;
+				continue;
+			}
+
+			TCreature *Creature = GetCreature(this->ActID);
+			if(Creature == NULL){
+				error("TFindTargets::getNext: Creature does not exist.\n");
+				this->ActID = 0;
+				continue;
+			}
+
+			this->ActID = Creature->NextChainCreature;
+			if(!GetTargetCandidate(Creature, &this->Current)){
+				continue;
+			}
+			Candidate = &this->Current;
+		}else if(this->BlockIndex < this->BlockCandidates){
+			Candidate = &this->Block[this->BlockIndex];
+			this->BlockIndex += 1;
+		}else{
+			this->blockx += 1;
+			if(this->blockx > EndBlockX){
+				this->blockx = StartBlockX;
+				this->blocky += 1;
+				if(this->blocky > EndBlockY){
+					this->finished = true;
+					return NULL;
+				}
+			}
+
+			TTargetBlock *Cached = GetTargetBlock(this->blockx, this->blocky);
+			this->BlockIndex = 0;
+			if(Cached != NULL){
+				this->Block = Cached->Candidate;
+				this->BlockCandidates = Cached->Candidates;
+			}else{
+				this->Block = NULL;
+				this->BlockCandidates = 0;
+				uint32 *FirstID = FirstChainCreature->boundedAt(this->blockx, this->blocky);
+				if(FirstID != NULL){
+					this->ActID = *FirstID;
+					this->Uncached = true;
+				}
+			}
+			continue;
+		}
+
+		if(Candidate->ID == this->SkipID
+				|| Candidate->x < this->startx || Candidate->x > this->endx
+				|| Candidate->y < this->starty || Candidate->y > this->endy){
+			continue;
+		}
+
+		return Candidate;
+	}
+}
+
+void TargetCacheSummary(void){
+	uint32 Lookups = TargetBlockHits + TargetBlockMisses;
+	if(Lookups > 0){
+		Log("game", "Target cache: %u block lookups, %u%% hits, %u overflows.\n",
+				Lookups, (TargetBlockHits * 100) / Lookups, TargetBlockOverflows);
+	}
+	TargetBlockHits = 0;
+	TargetBlockMisses = 0;
+	TargetBlockOverflows = 0;
+}
+
+// TInventoryIndex
+// =============================================================================
+TInventoryIndex::TInventoryIndex(void){
+	this->Money = 0;
+	this->Count = 0;
+	this->Capacity = 0;
+	this->Entry = NULL;
+}
+
+TInventoryIndex::~TInventoryIndex(void){
+	free(this->Entry);
+}
+
+static int FindInventoryCount(TInventoryIndex *Index, int TypeID, uint32 Value){
+	int Low = 0;
+	int High = Index->Count;
+	while(Low < High){
+		int Mid = (Low + High) / 2;
+		TInventoryCount *Entry = &Index->Entry[Mid];
+		if(Entry->TypeID < TypeID || (Entry->TypeID == TypeID && Entry->Value < Value)){
+			Low = Mid + 1;
+		}else{
+			High = Mid;
+		}
+	}
+	return Low;
+}
+
+int TInventoryIndex::get(int TypeID, uint32 Value){
+	int Index = FindInventoryCount(this, TypeID, Value);
+	if(Index < this->Count
+			&& this->Entry[Index].TypeID == TypeID
+			&& this->Entry[Index].Value == Value){
+		return this->Entry[Index].Count;
+	}
+	return 0;
+}
+
+void TInventoryIndex::add(int TypeID, uint32 Value, int Count){
+	if(Count == 0){
+		return;
+	}
+
+	int Index = FindInventoryCount(this, TypeID, Value);
+	bool Found = Index < this->Count
+			&& this->Entry[Index].TypeID == TypeID
+			&& this->Entry[Index].Value == Value;
+	if(Found){
+		this->Entry[Index].Count += Count;
+		if(this->Entry[Index].Count <= 0){
+			if(this->Entry[Index].Count < 0){
+				error("TInventoryIndex::add: Negative count for object type %d.\n", TypeID);
+			}
+
+			memmove(&this->Entry[Index], &this->Entry[Index + 1],
+					(this->Count - Index - 1) * sizeof(TInventoryCount));
+			this->Count -= 1;
+		}
+	}else if(Count > 0){
+		if(this->Count >= this->Capacity){
+			int Capacity = std::max<int>(this->Capacity * 2, 16);
+			TInventoryCount *Entry = (TInventoryCount*)realloc(this->Entry,
+					Capacity * sizeof(TInventoryCount));
+			if(Entry == NULL){
+				throw std::bad_alloc();
+			}
+			this->Entry = Entry;
+			this->Capacity = Capacity;
+		}
+
+		memmove(&this->Entry[Index + 1], &this->Entry[Index],
+				(this->Count - Index) * sizeof(TInventoryCount));
+		this->Entry[Index].TypeID = TypeID;
+		this->Entry[Index].Value = Value;
+		this->Entry[Index].Count = Count;
+		this->Count += 1;
+	}else{
+		error("TInventoryIndex::add: Removing absent object type %d.\n", TypeID);
+	}
+}
+
+void TInventoryIndex::clear(void){
+	this->Money = 0;
+	this->Count = 0;
+}
+
 // TCreature
 // =============================================================================
 TCreature::TCreature(void) :
 		TSkillBase(),
 		Combat(),
+		InventoryIndex(),
 		ToDoList(0, 20, 10)
 {
 	this->Combat.Master = this;
 	this->ID = 0;
-	this->NextHashEntry = NULL;
 	this->NextChainCreature =  0;
 	this->Name[0] = 0;
 	this->Murderer[0] = 0;
@@ -161,9 +504,12 @@ TCreature::TCreature(void) :
 	this->ActToDo = 0;
 	this->NrToDo = 0;
 	this->NextWakeup = 0;
+	this->ToDoGeneration = 0;
 	this->Stop = false;
 	this->LockToDo = false;
 	this->Connection = NULL;
+	this->InCrList = false;
+	this->CrListIndex = -1;
 
 	for(int i = 0; i < NARRAY(this->Skills); i += 1){
 		this->NewSkill((uint16)i, this);
@@ -284,6 +630,94 @@ TCreature::~TCreature(void){
 	}
 }
 
+static uint32 CreatureTableHome(uint32 CreatureID){
+	// NOTE(fusion): Fibonacci hashing, which takes the top bits of the product
+	// and spreads mostly sequential player and monster IDs across the table.
+	return (CreatureID * 2654435761U) >> CreatureTableShift;
+}
+
+// NOTE(fusion): With `Newest` set, `Creature` takes the place of the first
+// entry with the same ID, which is then pushed further along the probe sequence.
+// Otherwise it is appended after any such entries, which keeps their order when
+// rehashing.
+static void PutCreatureTable(TCreature *Creature, bool Newest){
+	uint32 Mask = (uint32)CreatureTableSize - 1;
+	uint32 Index = CreatureTableHome(Creature->ID);
+	while(CreatureTable[Index] != NULL){
+		if(Newest && CreatureTable[Index]->ID == Creature->ID){
+			std::swap(CreatureTable[Index], Creature);
+		}
+		Index = (Index + 1) & Mask;
+	}
+	CreatureTable[Index] = Creature;
+}
+
+static void InsertCreatureTable(TCreature *Creature){
+	if(CreatureTable == NULL || (CreatureTableEntries + 1) * 2 > CreatureTableSize){
+		TCreature **OldTable = CreatureTable;
+		int OldSize = CreatureTableSize;
+		CreatureTableSize = (OldSize > 0) ? (OldSize * 2) : 2048;
+		CreatureTableShift = 32;
+		while((1 << (32 - CreatureTableShift)) < CreatureTableSize){
+			CreatureTableShift -= 1;
+		}
+		CreatureTable = (TCreature**)calloc(CreatureTableSize, sizeof(TCreature*));
+
+		// NOTE(fusion): Start right after an empty slot, so no cluster wraps
+		// around and duplicates are visited in their probe order.
+		int Start = 0;
+		while(Start < OldSize && OldTable[Start] != NULL){
+			Start += 1;
+		}
+
+		for(int Offset = 0; Offset < OldSize; Offset += 1){
+			int Index = (Start + Offset) % OldSize;
+			if(OldTable[Index] != NULL){
+				PutCreatureTable(OldTable[Index], false);
+			}
+		}
+		free(OldTable);
+
+		if(OldSize > 0){
+			print(2, "Creature table enlarged to %d entries.\n", CreatureTableSize);
+		}
+	}
+
+	PutCreatureTable(Creature, true);
+	CreatureTableEntries += 1;
+}
+
+static bool RemoveCreatureTable(TCreature *Creature){
+	if(CreatureTable == NULL){
+		return false;
+	}
+
+	uint32 Mask = (uint32)CreatureTableSize - 1;
+	uint32 Index = CreatureTableHome(Creature->ID);
+	while(CreatureTable[Index] != Creature){
+		if(CreatureTable[Index] == NULL){
+			return false;
+		}
+		Index = (Index + 1) & Mask;
+	}
+
+	// NOTE(fusion): Backward shift deletion. Move following entries into the
+	// hole unless that would put them before the slot they hash to.
+	uint32 Hole = Index;
+	Index = (Index + 1) & Mask;
+	while(CreatureTable[Index] != NULL){
+		uint32 Home = CreatureTableHome(CreatureTable[Index]->ID);
+		if(((Index - Home) & Mask) >= ((Index - Hole) & Mask)){
+			CreatureTable[Hole] = CreatureTable[Index];
+			Hole = Index;
+		}
+		Index = (Index + 1) & Mask;
+	}
+	CreatureTable[Hole] = NULL;
+	CreatureTableEntries -= 1;
+	return true;
+}
+
 void TCreature::SetID(uint32 CharacterID){
 	if(this->ID != 0){
 		error("TCreature::SetID: ID is already set.\n");
@@ -311,48 +745,43 @@ void TCreature::SetID(uint32 CharacterID){
 		}
 	}
 
-	uint32 ListIndex = CreatureID % NARRAY(HashList);
 	this->ID = CreatureID;
-	this->NextHashEntry = HashList[ListIndex];
-	HashList[ListIndex] = this;
+	InsertCreatureTable(this);
 }
 
 void TCreature::DelID(void){
-	uint32 ListIndex = this->ID % NARRAY(HashList);
-	TCreature *First = HashList[ListIndex];
-	if(First == NULL){
-		error("TCreature::DelID: Hash entry not found id = %d\n", this->ID);
-		return;
-	}
-
-	if(First->ID == this->ID){
-		HashList[ListIndex] = this->NextHashEntry;
-	}else{
-		TCreature *Prev = First;
-		TCreature *Current = First->NextHashEntry;
-		while(true){
-			if(Current == NULL){
-				error("TCreature::DelID: id=%d not found.\n", this->ID);
-				return;
-			}
-
-			if(Current->ID == this->ID){
-				Prev->NextHashEntry = this->NextHashEntry;
-				break;
-			}
-
-			Prev = Current;
-			Current = Current->NextHashEntry;
-		}
+	if(!RemoveCreatureTable(this)){
+		error("TCreature::DelID: id=%d not found.\n", this->ID);
 	}
 }
 
 void TCreature::SetInCrList(void){
 	*CreatureList.at(FirstFreeCreature) = this;
+	this->CrListIndex = FirstFreeCreature;
 	FirstFreeCreature += 1;
+
+	// NOTE(fusion): Skill timers don't run while the creature is out of the
+	// list so whatever was set before only starts counting down from here.
+	this->InCrList = true;
+	this->TimerDueRound = 0;
+	for(int Index = 0; Index < this->FirstFreeTimer; Index += 1){
+		if(this->TimerList[Index] != NULL){
+			this->TimerList[Index]->CountRound = SkillTimerRound;
+		}
+	}
+	ScheduleSkillTimers(this);
 }
 
 void TCreature::DelInCrList(void){
+	for(int Index = 0; Index < this->FirstFreeTimer; Index += 1){
+		if(this->TimerList[Index] != NULL){
+			this->TimerList[Index]->SyncCount();
+		}
+	}
+	this->InCrList = false;
+	this->CrListIndex = -1;
+	this->TimerDueRound = 0;
+
 	// TODO(fusion): See note in `ProcessCreatures`.
 	for(int Index = 0; Index < FirstFreeCreature; Index += 1){
 		TCreature **Current = CreatureList.at(Index);
@@ -361,6 +790,9 @@ void TCreature::DelInCrList(void){
 			*Current = *Last;
 			*Last = NULL;
 			FirstFreeCreature -= 1;
+			if(*Current != NULL){
+				(*Current)->CrListIndex = Index;
+			}
 
 			// TODO(fusion): The original function wouldn't break here. Maybe it
 			// is possible to have duplicates in `CreatureList`?
@@ -944,12 +1376,59 @@ TCreature *GetCreature(uint32 CreatureID){
 		return NULL;
 	}
 
-	TCreature *Creature = HashList[CreatureID % NARRAY(HashList)];
-	while(Creature != NULL && Creature->ID != CreatureID){
-		Creature = Creature->NextHashEntry;
+	if(CreatureTable == NULL){
+		return NULL;
+	}
+
+	uint32 Mask = (uint32)CreatureTableSize - 1;
+	uint32 Index = CreatureTableHome(CreatureID);
+	CreatureTableLookups += 1;
+	while(true){
+		CreatureTableProbes += 1;
+		TCreature *Creature = CreatureTable[Index];
+		if(Creature == NULL || Creature->ID == CreatureID){
+			return Creature;
+		}
+		Index = (Index + 1) & Mask;
+	}
+}
+
+void GetCreatureTableStatistics(int *Entries, int *Capacity,
+		int *AverageProbe, int *MaxProbe){
+	// NOTE(fusion): The probe length of an entry is its distance from the slot
+	// it hashes to, plus one. `AverageProbe` is given in hundredths.
+	int64 ProbeTotal = 0;
+	int ProbeMax = 0;
+	uint32 Mask = (uint32)CreatureTableSize - 1;
+	for(int Index = 0; Index < CreatureTableSize; Index += 1){
+		TCreature *Creature = CreatureTable[Index];
+		if(Creature != NULL){
+			int Probe = (int)(((uint32)Index - CreatureTableHome(Creature->ID)) & Mask) + 1;
+			ProbeTotal += Probe;
+			ProbeMax = std::max<int>(ProbeMax, Probe);
+		}
 	}
 
-	return Creature;
+	*Entries = CreatureTableEntries;
+	*Capacity = CreatureTableSize;
+	*AverageProbe = (CreatureTableEntries > 0) ?
+			(int)((ProbeTotal * 100) / CreatureTableEntries) : 0;
+	*MaxProbe = ProbeMax;
+}
+
+void CreatureTableSummary(void){
+	int Entries, Capacity, AverageProbe, MaxProbe;
+	GetCreatureTableStatistics(&Entries, &Capacity, &AverageProbe, &MaxProbe);
+	Log("game", "Creature table: %d/%d entries (load %d%%), probe length avg %d.%02d, max %d.\n",
+			Entries, Capacity, (Entries * 100) / std::max<int>(Capacity, 1),
+			AverageProbe / 100, AverageProbe % 100, MaxProbe);
+	if(CreatureTableLookups > 0){
+		uint32 LookupProbes = (uint32)(((uint64)CreatureTableProbes * 100) / CreatureTableLookups);
+		Log("game", "Creature table: %u lookups, %u.%02u probes per lookup.\n",
+				CreatureTableLookups, LookupProbes / 100, LookupProbes % 100);
+	}
+	CreatureTableLookups = 0;
+	CreatureTableProbes = 0;
 }
 
 TCreature *GetCreature(Object Obj){
@@ -978,6 +1457,7 @@ void InsertChainCreature(TCreature *Creature, int CoordX, int CoordY){
 	uint32 *FirstID = FirstChainCreature->at(ChainX, ChainY);
 	Creature->NextChainCreature = *FirstID;
 	*FirstID = Creature->ID;
+	TouchChainBlock(ChainX, ChainY);
 }
 
 void DeleteChainCreature(TCreature *Creature){
@@ -992,6 +1472,7 @@ void DeleteChainCreature(TCreature *Creature){
 	int ChainX = Creature->posx / 16;
 	int ChainY = Creature->posy / 16;
 	uint32 *FirstID = FirstChainCreature->at(ChainX, ChainY);
+	TouchChainBlock(ChainX, ChainY);
 
 	if(*FirstID == Creature->ID){
 		*FirstID = Creature->NextChainCreature;
@@ -1033,10 +1514,51 @@ void MoveChainCreature(TCreature *Creature, int CoordX, int CoordY){
 	if(NewChainX != OldChainX || NewChainY != OldChainY){
 		DeleteChainCreature(Creature);
 		InsertChainCreature(Creature, CoordX, CoordY);
+	}else{
+		// NOTE(fusion): The chain is the same but cached target candidates
+		// still hold the old position.
+		TouchChainBlock(OldChainX, OldChainY);
 	}
 }
 
+static bool IsMonsterDormant(TCreature *Creature){
+	// NOTE(fusion): A monster falls asleep in `TMonster::IdleStimulus` when there
+	// is no player that could see it, and from then on it is out of the ToDo
+	// queue until `TMonster::CreatureMoveStimulus` wakes it up, which happens
+	// whenever a player moves into the area searched by `TFindCreatures`. If it
+	// also has full health and mana, no running skill timers, and isn't about
+	// to logout, a pass of `ProcessCreatures` would be a no-op so we may skip it
+	// without changing anything a player could observe.
+	if(Creature->Type != MONSTER || ((TMonster*)Creature)->State != SLEEPING
+			|| Creature->IsDead || Creature->LoggingOut
+			|| Creature->FirstFreeTimer != 0){
+		return false;
+	}
+
+	TSkill *Hitpoints = Creature->Skills[SKILL_HITPOINTS];
+	TSkill *Mana = Creature->Skills[SKILL_MANA];
+	return Hitpoints->Act >= Hitpoints->Max
+		&& Hitpoints->Act > 0
+		&& Mana->Act >= Mana->Max;
+}
+
+void GetMonsterActivity(int *Active, int *Dormant){
+	*Active = ActiveMonsters;
+	*Dormant = DormantMonsters;
+}
+
+void MonsterActivitySummary(void){
+	int Total = ActiveMonsters + DormantMonsters;
+	Log("game", "Monsters: %d active, %d dormant (%d%%), %u dormant visits skipped.\n",
+			ActiveMonsters, DormantMonsters,
+			(DormantMonsters * 100) / std::max<int>(Total, 1),
+			DormantVisitsSkipped);
+	DormantVisitsSkipped = 0;
+}
+
 void ProcessCreatures(void){
+	int Active = 0;
+	int Dormant = 0;
 	for(int Index = 0; Index < FirstFreeCreature; Index += 1){
 		TCreature *Creature = *CreatureList.at(Index);
 		if(Creature == NULL){
@@ -1044,6 +1566,14 @@ void ProcessCreatures(void){
 			continue;
 		}
 
+		if(Creature->Type == MONSTER){
+			if(IsMonsterDormant(Creature)){
+				Dormant += 1;
+				continue;
+			}
+			Active += 1;
+		}
+
 		// TODO(fusion): I'm almost sure this is processing ITEM regen rather
 		// FOOD regen. It wouldn't make a lot of sense to have this plus what
 		// happens in `TSkillFed::Event` if we didn't consider things like the
@@ -1063,6 +1593,8 @@ void ProcessCreatures(void){
 				((TPlayer*)Creature)->CheckState();
 			}
 
+			CheckDepotIdle((TPlayer*)Creature);
+
 			if(Creature->EarliestLogoutRound != 0 && Creature->EarliestLogoutRound <= RoundNr){
 				((TPlayer*)Creature)->ClearPlayerkillingMarks();
 				Creature->EarliestLogoutRound = 0;
@@ -1089,35 +1621,223 @@ void ProcessCreatures(void){
 			Index -= 1;
 		}
 	}
+
+	ActiveMonsters = Active;
+	DormantMonsters = Dormant;
+	DormantVisitsSkipped += (uint32)Dormant;
+}
+
+void ScheduleSkillTimers(TCreature *Creature){
+	// NOTE(fusion): The creature being processed is rescheduled afterwards. Any
+	// older queue entry is left behind and skipped once it no longer matches
+	// `TimerDueRound`. Creatures scheduled while a round is being processed
+	// wait for the next one, since the round's batch is already taken.
+	if(Creature == NULL || !Creature->InCrList || Creature == SkillTimerCreature){
+		return;
+	}
+
+	uint32 Round = Creature->NextTimerRound();
+	if(Round == 0){
+		return;
+	}
+
+	uint32 MinRound = SkillTimerRound + 1;
+	if(SkillTimerPass){
+		MinRound += 1;
+	}
+
+	if(Round < MinRound){
+		Round = MinRound;
+	}
+
+	if(Creature->TimerDueRound == 0 || Round < Creature->TimerDueRound){
+		Creature->TimerDueRound = Round;
+		SkillTimerQueue.insert(Round, Creature->ID);
+	}
+}
+
+void SkillTimerSummary(void){
+	if(SkillTimerRounds > 0){
+		uint32 VisitsPerRound = (uint32)(((uint64)SkillTimerVisits * 100) / SkillTimerRounds);
+		uint32 TicksPerRound = (uint32)(((uint64)SkillTimerTicks * 100) / SkillTimerRounds);
+		Log("game", "Skill timers: %u rounds, %u.%02u creatures and %u.%02u timers processed per round.\n",
+				SkillTimerRounds, VisitsPerRound / 100, VisitsPerRound % 100,
+				TicksPerRound / 100, TicksPerRound % 100);
+	}
+	SkillTimerRounds = 0;
+	SkillTimerVisits = 0;
+	SkillTimerTicks = 0;
 }
 
 void ProcessSkills(void){
-	for(int Index = 0; Index < FirstFreeCreature; Index += 1){
-		TCreature *Creature = *CreatureList.at(Index);
-		if(Creature == NULL){
-			error("ProcessSkills: Creature %d does not exist.\n", Index);
+	// NOTE(fusion): Skill timers are kept in `SkillTimerQueue` keyed by the next
+	// round where one of them is due, so creatures with nothing to do aren't
+	// touched at all. Rounds still happen once per call, which keeps the same
+	// timer granularity as iterating over the whole `CreatureList`. Creatures
+	// due on a round are taken out of the queue first and processed in their
+	// `CreatureList` order, which is the order that iteration had.
+	uint32 Round = SkillTimerRound + 1;
+	int BatchSize = 0;
+	while(SkillTimerQueue.Entries > 0){
+		auto Entry = *SkillTimerQueue.Entry->at(1);
+		if(Entry.Key > Round){
+			break;
+		}
+
+		SkillTimerQueue.deleteMin();
+		TCreature *Creature = GetCreature(Entry.Data);
+		if(Creature == NULL || !Creature->InCrList || Creature->TimerDueRound != Entry.Key){
+			continue;
+		}
+
+		*SkillTimerBatch.at(BatchSize) = ((uint64)Creature->CrListIndex << 32) | (uint64)Creature->ID;
+		BatchSize += 1;
+	}
+
+	if(BatchSize > 1){
+		uint64 *First = SkillTimerBatch.at(0);
+		std::sort(First, First + BatchSize);
+	}
+
+	SkillTimerPass = true;
+	for(int BatchNr = 0; BatchNr < BatchSize; BatchNr += 1){
+		uint32 CreatureID = (uint32)*SkillTimerBatch.at(BatchNr);
+		TCreature *Creature = GetCreature(CreatureID);
+		if(Creature == NULL || !Creature->InCrList || Creature->TimerDueRound != Round){
 			continue;
 		}
 
+		SkillTimerVisits += 1;
+		SkillTimerTicks += Creature->FirstFreeTimer;
+		Creature->TimerDueRound = 0;
+		SkillTimerCreature = Creature;
 		Creature->ProcessSkills();
+		SkillTimerCreature = NULL;
+
+		// NOTE(fusion): Processing skills could have caused the creature to be
+		// removed, in which case it is no longer in the creature table.
+		Creature = GetCreature(CreatureID);
+		if(Creature != NULL){
+			ScheduleSkillTimers(Creature);
+		}
+	}
+	SkillTimerPass = false;
+
+	SkillTimerRound = Round;
+	SkillTimerRounds += 1;
+}
+
+static void AppendToDoQueue(uint32 Time, TToDoQueueRef Ref){
+	if(ToDoQueueFreeNode == -1){
+		if(ToDoQueueCapacity == 0){
+			for(int Bucket = 0; Bucket < TODO_QUEUE_WINDOW; Bucket += 1){
+				ToDoQueueHead[Bucket] = -1;
+				ToDoQueueTail[Bucket] = -1;
+			}
+		}
+
+		int OldCapacity = ToDoQueueCapacity;
+		int NewCapacity = std::max<int>(OldCapacity * 2, 4096);
+		TToDoQueueNode *NewNodes = new TToDoQueueNode[NewCapacity];
+		if(OldCapacity > 0){
+			memcpy(NewNodes, ToDoQueueNodes, OldCapacity * sizeof(TToDoQueueNode));
+			delete[] ToDoQueueNodes;
+		}
+
+		for(int Index = NewCapacity - 1; Index >= OldCapacity; Index -= 1){
+			NewNodes[Index].Next = ToDoQueueFreeNode;
+			ToDoQueueFreeNode = Index;
+		}
+
+		ToDoQueueNodes = NewNodes;
+		ToDoQueueCapacity = NewCapacity;
+	}
+
+	int Node = ToDoQueueFreeNode;
+	ToDoQueueFreeNode = ToDoQueueNodes[Node].Next;
+	ToDoQueueNodes[Node].Ref = Ref;
+	ToDoQueueNodes[Node].Next = -1;
+
+	int Bucket = (int)(Time % TODO_QUEUE_WINDOW);
+	if(ToDoQueueTail[Bucket] == -1){
+		ToDoQueueHead[Bucket] = Node;
+	}else{
+		ToDoQueueNodes[ToDoQueueTail[Bucket]].Next = Node;
+	}
+	ToDoQueueTail[Bucket] = Node;
+	ToDoQueueNear += 1;
+}
+
+static void MigrateToDoQueue(void){
+	while(ToDoQueueFar.Entries > 0){
+		auto Entry = *ToDoQueueFar.Entry->at(1);
+		uint32 Time = (uint32)(Entry.Key >> 32);
+		if((Time - ToDoQueueCursor) >= TODO_QUEUE_WINDOW){
+			break;
+		}
+
+		ToDoQueueFar.deleteMin();
+		AppendToDoQueue(Time, Entry.Data);
+	}
+}
+
+void InsertToDoQueue(TCreature *Creature, uint32 Time){
+	// NOTE(fusion): Each insertion supersedes whatever wakeup the creature had
+	// pending, which is dropped when it comes up. `TCreature::Execute` would be
+	// a no-op for these anyway since `NextWakeup` always refers to the latest.
+	Creature->ToDoGeneration += 1;
+	TToDoQueueRef Ref = {Creature->ID, Creature->ToDoGeneration};
+	if(Time < ToDoQueueCursor){
+		Time = ToDoQueueCursor;
+	}
+
+	if((Time - ToDoQueueCursor) < TODO_QUEUE_WINDOW){
+		AppendToDoQueue(Time, Ref);
+	}else{
+		uint64 Key = ((uint64)Time << 32) | (uint64)ToDoQueueSequence;
+		ToDoQueueSequence += 1;
+		ToDoQueueFar.insert(Key, Ref);
 	}
 }
 
 void MoveCreatures(int Delay){
 	ServerMilliseconds += Delay;
-	while(ToDoQueue.Entries > 0){
-		auto Entry = *ToDoQueue.Entry->at(1);
-		uint32 ExecutionTime = Entry.Key;
-		uint32 CreatureID = Entry.Data;
-		if(ExecutionTime > ServerMilliseconds){
-			break;
+	while(ToDoQueueCursor <= ServerMilliseconds){
+		if(ToDoQueueNear == 0){
+			// NOTE(fusion): Skip straight to the current time or to where the
+			// window starts covering the next far entry, whichever comes first.
+			uint32 Next = ServerMilliseconds + 1;
+			if(ToDoQueueFar.Entries > 0){
+				uint32 FarTime = (uint32)(ToDoQueueFar.Entry->at(1)->Key >> 32);
+				if((FarTime - TODO_QUEUE_WINDOW + 1) < Next){
+					Next = FarTime - TODO_QUEUE_WINDOW + 1;
+				}
+			}
+			ToDoQueueCursor = Next;
+			MigrateToDoQueue();
+			continue;
 		}
 
-		ToDoQueue.deleteMin();
-		TCreature *Creature = GetCreature(CreatureID);
-		if(Creature != NULL){
-			Creature->Execute();
+		int Bucket = (int)(ToDoQueueCursor % TODO_QUEUE_WINDOW);
+		while(ToDoQueueHead[Bucket] != -1){
+			int Node = ToDoQueueHead[Bucket];
+			TToDoQueueRef Ref = ToDoQueueNodes[Node].Ref;
+			ToDoQueueHead[Bucket] = ToDoQueueNodes[Node].Next;
+			if(ToDoQueueHead[Bucket] == -1){
+				ToDoQueueTail[Bucket] = -1;
+			}
+			ToDoQueueNodes[Node].Next = ToDoQueueFreeNode;
+			ToDoQueueFreeNode = Node;
+			ToDoQueueNear -= 1;
+
+			TCreature *Creature = GetCreature(Ref.CreatureID);
+			if(Creature != NULL && Creature->ToDoGeneration == Ref.Generation){
+				Creature->Execute();
+			}
 		}
+
+		ToDoQueueCursor += 1;
+		MigrateToDoQueue();
 	}
 }
 
@@ -2121,6 +2841,11 @@ void InitCr(void){
 				SectorXMin * 2, SectorXMax * 2 + 1,
 				SectorYMin * 2, SectorYMax * 2 + 1,
 				0);
+	ChainRevision = new matrix<uint32>(
+				SectorXMin * 2, SectorXMax * 2 + 1,
+				SectorYMin * 2, SectorYMax * 2 + 1,
+				1);
+	NextChainRevision = 1;
 
 	LoadRaces();
 	LoadMonsterRaids();
@@ -2137,4 +2862,16 @@ void ExitCr(void){
 	ExitCrskill();
 
 	delete FirstChainCreature;
+	delete ChainRevision;
+
+	free(CreatureTable);
+	CreatureTable = NULL;
+	CreatureTableSize = 0;
+	CreatureTableEntries = 0;
+
+	delete[] ToDoQueueNodes;
+	ToDoQueueNodes = NULL;
+	ToDoQueueCapacity = 0;
+	ToDoQueueFreeNode = -1;
+	ToDoQueueNear = 0;
 }
@@ -14,6 +14,16 @@ static int FirstFreeNonplayer;
 static vector<TMonsterhome> Monsterhome(1, 5000, 1000);
 static int Monsterhomes;
 
+// NOTE(fusion): Running monsterhome timers are kept in `MonsterhomeQueue` keyed
+// by the round they expire in and the monsterhome number, so homes expiring on
+// the same round are still processed in the same order as before.
+static priority_queue<uint64, int> MonsterhomeQueue(1000, 1000);
+static uint32 MonsterhomeRound;
+static TSpawnCandidates *MonsterhomeCandidates;
+static uint32 MonsterhomeSpawns;
+static uint32 MonsterhomeBlocked;
+static uint32 MonsterhomeNoField;
+
 static store<TBehaviourNode, 256> BehaviourNodeTable;
 
 // Behaviour Database
@@ -273,7 +283,11 @@ void TBehaviour::operator=(const TBehaviour &Other){
 
 
 TBehaviourDatabase::TBehaviourDatabase(TReadScriptFile *Script) :
-		Behaviour(0, 50, 25)
+		Behaviour(0, 50, 25),
+		Instruction(0, 100, 100),
+		BehaviourStart(0, 50, 25),
+		KeywordEntry(0, 50, 25),
+		Candidate(0, 50, 25)
 {
 	this->Behaviours = 0;
 	Script->readSymbol('{');
@@ -521,6 +535,8 @@ TBehaviourDatabase::TBehaviourDatabase(TReadScriptFile *Script) :
 
 		this->Behaviours += 1;
 	}
+
+	this->compile();
 }
 
 TBehaviourNode *TBehaviourDatabase::readValue(TReadScriptFile *Script){
@@ -970,47 +986,260 @@ static bool FormatNpcResponse(char *Buffer, int BufferSize,
 	}
 }
 
-void TBehaviourDatabase::react(TNPC *Npc, const char *Text, SITUATION Situation){
-	if(Npc == NULL){
-		error("TBehaviourDatabase::react: NPC does not exist.\n");
-		return;
+// NOTE(fusion): Expressions that may be skipped without anyone noticing. Random
+// numbers would advance the generator and parameters log errors when not set.
+static bool BehaviourExpressionPure(TBehaviourNode *Node){
+	if(Node == NULL){
+		return true;
 	}
 
-	if(Text == NULL){
-		error("TBehaviourDatabase::react: Passed text does not exist.\n");
-		return;
+	if(Node->Type == BEHAVIOUR_NODE_RANDOM || Node->Type == BEHAVIOUR_NODE_PARAMETER){
+		return false;
 	}
 
-	uint32 InterlocutorID = Npc->Interlocutor;
-	TPlayer *Interlocutor = GetPlayer(InterlocutorID);
-	if(Interlocutor == NULL){
-		error("TBehaviourDatabase::react: Interlocutor does not exist"
-				" (Text=%s, Situation=%d).\n", Text, Situation);
-		return;
+	return BehaviourExpressionPure(Node->Left)
+		&& BehaviourExpressionPure(Node->Right);
+}
+
+static bool BehaviourOperandCompilable(TBehaviourNode *Node){
+	if(Node == NULL || Node->Left != NULL || Node->Right != NULL){
+		return false;
 	}
 
-	int Parameters[2] = {-1, -1};
-	int BestMatch = -1;
-	int MaxConditions = -1;
+	return Node->Type == BEHAVIOUR_NODE_NUMBER
+		|| Node->Type == BEHAVIOUR_NODE_TOPIC
+		|| Node->Type == BEHAVIOUR_NODE_PRICE
+		|| Node->Type == BEHAVIOUR_NODE_AMOUNT
+		|| Node->Type == BEHAVIOUR_NODE_TYPE
+		|| Node->Type == BEHAVIOUR_NODE_DATA
+		|| Node->Type == BEHAVIOUR_NODE_COUNTMONEY;
+}
+
+static int GetKeywordBucket(int First, int Second){
+	return (int)(((uint8)toLower(First) * 31 + (uint8)toLower(Second))
+			% BEHAVIOUR_KEYWORD_BUCKETS);
+}
+
+// NOTE(fusion): Returns the bucket of the behaviour's first text condition or
+// `BEHAVIOUR_KEYWORD_BUCKETS` if it must always be considered. The text is only
+// a valid key if nothing before it could move the text pointer, write to the
+// parameters, select the behaviour, or have any other side effect.
+static int GetBehaviourKeyword(TBehaviour *Behaviour){
+	for(int ConditionNr = 0;
+			ConditionNr < Behaviour->Conditions;
+			ConditionNr += 1){
+		TBehaviourCondition *Condition = Behaviour->Condition.at(ConditionNr);
+		if(Condition->Type == BEHAVIOUR_CONDITION_TEXT){
+			const char *Pattern = GetDynamicString(Condition->Text);
+			int PatternLength = (int)strlen(Pattern);
+			if(PatternLength > 0 && Pattern[PatternLength - 1] == '$'){
+				PatternLength -= 1;
+			}
+
+			if(PatternLength == 0){
+				break;
+			}else if(PatternLength == 1){
+				return GetKeywordBucket(Pattern[0], 0);
+			}else{
+				return GetKeywordBucket(Pattern[0], Pattern[1]);
+			}
+		}else if(Condition->Type == BEHAVIOUR_CONDITION_EXPRESSION){
+			if(!BehaviourExpressionPure(Condition->Expression)){
+				break;
+			}
+		}else if(Condition->Type != BEHAVIOUR_CONDITION_PROPERTY){
+			break;
+		}
+	}
+	return BEHAVIOUR_KEYWORD_BUCKETS;
+}
+
+void TBehaviourDatabase::compile(void){
+	this->Instructions = 0;
 	for(int BehaviourNr = 0;
 			BehaviourNr < this->Behaviours;
 			BehaviourNr += 1){
 		TBehaviour *Behaviour = this->Behaviour.at(BehaviourNr);
-		bool Match = true;
-		bool ShortCircuit = false;
-		const char *TextPtr = Text;
+		*this->BehaviourStart.at(BehaviourNr) = this->Instructions;
 		for(int ConditionNr = 0;
-				ConditionNr < Behaviour->Conditions && Match;
+				ConditionNr < Behaviour->Conditions;
 				ConditionNr += 1){
 			TBehaviourCondition *Condition = Behaviour->Condition.at(ConditionNr);
-			if(Condition->Type == BEHAVIOUR_CONDITION_SHORTCIRCUIT){
+			TBehaviourInstruction *Instruction = this->Instruction.at(this->Instructions);
+			Instruction->Type = Condition->Type;
+			Instruction->Data = 0;
+			Instruction->Left = BEHAVIOUR_NODE_NONE;
+			Instruction->LeftData = 0;
+			Instruction->Right = BEHAVIOUR_NODE_NONE;
+			Instruction->RightData = 0;
+			Instruction->Expression = NULL;
+			this->Instructions += 1;
+
+			switch(Condition->Type){
+				case BEHAVIOUR_CONDITION_TEXT:{
+					Instruction->Data = (int)Condition->Text;
+					break;
+				}
+
+				case BEHAVIOUR_CONDITION_PROPERTY:{
+					if(Condition->Property == BEHAVIOUR_PROPERTY_ADDRESS){
+						Instruction->Type = BEHAVIOUR_CONDITION_SITUATION;
+						Instruction->Data = (1 << ADDRESS) | (1 << ADDRESSQUEUE);
+					}else if(Condition->Property == BEHAVIOUR_PROPERTY_BUSY){
+						Instruction->Type = BEHAVIOUR_CONDITION_SITUATION;
+						Instruction->Data = (1 << BUSY);
+					}else if(Condition->Property == BEHAVIOUR_PROPERTY_VANISH){
+						Instruction->Type = BEHAVIOUR_CONDITION_SITUATION;
+						Instruction->Data = (1 << VANISH);
+					}else{
+						Instruction->Data = Condition->Property;
+					}
+					break;
+				}
+
+				case BEHAVIOUR_CONDITION_PARAMETER:{
+					Instruction->Data = Condition->Number;
+					break;
+				}
+
+				case BEHAVIOUR_CONDITION_EXPRESSION:{
+					TBehaviourNode *Node = Condition->Expression;
+					if(Node != NULL
+							&& Node->Type >= BEHAVIOUR_NODE_CMP_LT
+							&& Node->Type <= BEHAVIOUR_NODE_CMP_GE
+							&& BehaviourOperandCompilable(Node->Left)
+							&& BehaviourOperandCompilable(Node->Right)){
+						Instruction->Type = BEHAVIOUR_CONDITION_COMPARE;
+						Instruction->Data = Node->Type;
+						Instruction->Left = Node->Left->Type;
+						Instruction->LeftData = Node->Left->Data;
+						Instruction->Right = Node->Right->Type;
+						Instruction->RightData = Node->Right->Data;
+					}else{
+						Instruction->Expression = Node;
+					}
+					break;
+				}
+			}
+		}
+	}
+	*this->BehaviourStart.at(this->Behaviours) = this->Instructions;
+
+	// NOTE(fusion): Bucket entries are kept in behaviour order so candidates
+	// can be merged back into it with a single sort.
+	int Cursor[BEHAVIOUR_KEYWORD_BUCKETS + 1] = {};
+	for(int BehaviourNr = 0;
+			BehaviourNr < this->Behaviours;
+			BehaviourNr += 1){
+		Cursor[GetBehaviourKeyword(this->Behaviour.at(BehaviourNr))] += 1;
+	}
+
+	int Start = 0;
+	for(int Bucket = 0; Bucket <= BEHAVIOUR_KEYWORD_BUCKETS; Bucket += 1){
+		int Count = Cursor[Bucket];
+		this->KeywordStart[Bucket] = Start;
+		Cursor[Bucket] = Start;
+		Start += Count;
+	}
+	this->KeywordStart[BEHAVIOUR_KEYWORD_BUCKETS + 1] = Start;
+
+	for(int BehaviourNr = 0;
+			BehaviourNr < this->Behaviours;
+			BehaviourNr += 1){
+		int Bucket = GetBehaviourKeyword(this->Behaviour.at(BehaviourNr));
+		*this->KeywordEntry.at(Cursor[Bucket]) = BehaviourNr;
+		Cursor[Bucket] += 1;
+	}
+}
+
+int TBehaviourDatabase::operand(TNPC *Npc, TPlayer *Interlocutor, int Type, int Data){
+	int Result = 0;
+	switch(Type){
+		case BEHAVIOUR_NODE_NUMBER:		Result = Data; break;
+		case BEHAVIOUR_NODE_TOPIC:		Result = Npc->Topic; break;
+		case BEHAVIOUR_NODE_PRICE:		Result = Npc->Price; break;
+		case BEHAVIOUR_NODE_AMOUNT:		Result = Npc->Amount; break;
+		case BEHAVIOUR_NODE_TYPE:		Result = Npc->TypeID; break;
+		case BEHAVIOUR_NODE_DATA:		Result = (int)Npc->Data; break;
+		case BEHAVIOUR_NODE_COUNTMONEY:	Result = CountInventoryMoney(Interlocutor->ID); break;
+		default:{
+			error("TBehaviourDatabase::operand: Invalid operand type %d.\n", Type);
+			break;
+		}
+	}
+	return Result;
+}
+
+// NOTE(fusion): Picks the first behaviour with the most conditions that match,
+// unless a short circuit is reached first, exactly like the original linear
+// scan. Only behaviours whose keyword starts some word of the text, plus the
+// ones that couldn't be indexed, are visited at all.
+int TBehaviourDatabase::match(TNPC *Npc, TPlayer *Interlocutor,
+		const char *Text, SITUATION Situation, int *Parameters){
+	uint32 BucketSeen[(BEHAVIOUR_KEYWORD_BUCKETS + 31) / 32] = {};
+	int Candidates = 0;
+	bool WordStart = true;
+	for(int i = 0; Text[i] != 0; i += 1){
+		// NOTE(fusion): Same word boundaries as `SearchForWord`.
+		if(!isAlpha(Text[i]) && !isDigit(Text[i])){
+			WordStart = true;
+		}else if(WordStart){
+			int Bucket[2] = {
+				GetKeywordBucket(Text[i], 0),
+				GetKeywordBucket(Text[i], Text[i + 1]),
+			};
+
+			for(int j = 0; j < NARRAY(Bucket); j += 1){
+				uint32 Bit = (uint32)1 << (Bucket[j] % 32);
+				if((BucketSeen[Bucket[j] / 32] & Bit) == 0){
+					BucketSeen[Bucket[j] / 32] |= Bit;
+					for(int Entry = this->KeywordStart[Bucket[j]];
+							Entry < this->KeywordStart[Bucket[j] + 1];
+							Entry += 1){
+						*this->Candidate.at(Candidates) = *this->KeywordEntry.at(Entry);
+						Candidates += 1;
+					}
+				}
+			}
+			WordStart = false;
+		}
+	}
+
+	for(int Entry = this->KeywordStart[BEHAVIOUR_KEYWORD_BUCKETS];
+			Entry < this->KeywordStart[BEHAVIOUR_KEYWORD_BUCKETS + 1];
+			Entry += 1){
+		*this->Candidate.at(Candidates) = *this->KeywordEntry.at(Entry);
+		Candidates += 1;
+	}
+
+	if(Candidates > 1){
+		int *First = this->Candidate.at(0);
+		std::sort(First, First + Candidates);
+	}
+
+	int BestMatch = -1;
+	int MaxConditions = -1;
+	for(int CandidateNr = 0;
+			CandidateNr < Candidates;
+			CandidateNr += 1){
+		int BehaviourNr = *this->Candidate.at(CandidateNr);
+		int Start = *this->BehaviourStart.at(BehaviourNr);
+		int End = *this->BehaviourStart.at(BehaviourNr + 1);
+		bool Match = true;
+		bool ShortCircuit = false;
+		const char *TextPtr = Text;
+		for(int InstructionNr = Start;
+				InstructionNr < End && Match;
+				InstructionNr += 1){
+			TBehaviourInstruction *Instruction = this->Instruction.at(InstructionNr);
+			if(Instruction->Type == BEHAVIOUR_CONDITION_SHORTCIRCUIT){
 				ShortCircuit = true;
 				break;
 			}
 
-			switch(Condition->Type){
+			switch(Instruction->Type){
 				case BEHAVIOUR_CONDITION_TEXT:{
-					const char *Pattern = GetDynamicString(Condition->Text);
+					const char *Pattern = GetDynamicString((uint32)Instruction->Data);
 					const char *Word = SearchForWord(Pattern, TextPtr);
 					if(Word != NULL){
 						TextPtr = Word + strlen(Pattern);
@@ -1020,8 +1249,15 @@ void TBehaviourDatabase::react(TNPC *Npc, const char *Text, SITUATION Situation)
 					break;
 				}
 
+				case BEHAVIOUR_CONDITION_SITUATION:{
+					if((Instruction->Data & (1 << Situation)) == 0){
+						Match = false;
+					}
+					break;
+				}
+
 				case BEHAVIOUR_CONDITION_PROPERTY:{
-					if(!CheckBehaviourProperty(Condition->Property, Situation, Interlocutor)){
+					if(!CheckBehaviourProperty(Instruction->Data, Situation, Interlocutor)){
 						Match = false;
 					}
 					break;
@@ -1030,13 +1266,12 @@ void TBehaviourDatabase::react(TNPC *Npc, const char *Text, SITUATION Situation)
 				case BEHAVIOUR_CONDITION_PARAMETER:{
 					// TODO(fusion): The original function wouldn't check before
 					// writing to `Parameters` which could be a problem.
-					const char *Parameter = SearchForNumber(Condition->Number, TextPtr);
-					if(Parameter != NULL
-							&& Condition->Number >= 1
-							&& Condition->Number <= NARRAY(Parameters)){
-						Parameters[Condition->Number - 1] = atoi(Parameter);
-						if(Parameters[Condition->Number - 1] > 500){
-							Parameters[Condition->Number - 1] = 500;
+					int Number = Instruction->Data;
+					const char *Parameter = SearchForNumber(Number, TextPtr);
+					if(Parameter != NULL && Number >= 1 && Number <= 2){
+						Parameters[Number - 1] = atoi(Parameter);
+						if(Parameters[Number - 1] > 500){
+							Parameters[Number - 1] = 500;
 						}
 
 						// TODO(fusion): This could be problematic if the number
@@ -1048,30 +1283,82 @@ void TBehaviourDatabase::react(TNPC *Npc, const char *Text, SITUATION Situation)
 					break;
 				}
 
-				case BEHAVIOUR_CONDITION_EXPRESSION:{
-					if(this->evaluate(Npc, Condition->Expression, Parameters) == 0){
+				case BEHAVIOUR_CONDITION_COMPARE:{
+					int Left = this->operand(Npc, Interlocutor,
+							Instruction->Left, Instruction->LeftData);
+					int Right = this->operand(Npc, Interlocutor,
+							Instruction->Right, Instruction->RightData);
+					bool Result = false;
+					switch(Instruction->Data){
+						case BEHAVIOUR_NODE_CMP_LT:		Result = Left < Right; break;
+						case BEHAVIOUR_NODE_CMP_GT:		Result = Left > Right; break;
+						case BEHAVIOUR_NODE_CMP_EQ:		Result = Left == Right; break;
+						case BEHAVIOUR_NODE_CMP_NEQ:	Result = Left != Right; break;
+						case BEHAVIOUR_NODE_CMP_LE:		Result = Left <= Right; break;
+						case BEHAVIOUR_NODE_CMP_GE:		Result = Left >= Right; break;
+					}
+
+					if(!Result){
 						Match = false;
 					}
 					break;
 				}
 
-				case BEHAVIOUR_CONDITION_SHORTCIRCUIT:{
-					// TODO(fusion): Select current and stop loop.
+				case BEHAVIOUR_CONDITION_EXPRESSION:{
+					if(this->evaluate(Npc, Instruction->Expression, Parameters) == 0){
+						Match = false;
+					}
 					break;
 				}
 			}
 		}
 
-		if(ShortCircuit || (Match && Behaviour->Conditions > MaxConditions)){
+		int Conditions = End - Start;
+		if(ShortCircuit || (Match && Conditions > MaxConditions)){
 			BestMatch = BehaviourNr;
-			MaxConditions = Behaviour->Conditions;
+			MaxConditions = Conditions;
 			if(ShortCircuit){
 				break;
 			}
 		}
 	}
 
+	return BestMatch;
+}
+
+static void RecordNpcReaction(TNPC *Npc, int64 StartTime){
+	int64 Time = GetMonotonicMicroseconds() - StartTime;
+	Npc->Reactions += 1;
+	Npc->ReactionTimeTotal += Time;
+	if(Npc->ReactionTimeMax < Time){
+		Npc->ReactionTimeMax = Time;
+	}
+}
+
+void TBehaviourDatabase::react(TNPC *Npc, const char *Text, SITUATION Situation){
+	if(Npc == NULL){
+		error("TBehaviourDatabase::react: NPC does not exist.\n");
+		return;
+	}
+
+	if(Text == NULL){
+		error("TBehaviourDatabase::react: Passed text does not exist.\n");
+		return;
+	}
+
+	uint32 InterlocutorID = Npc->Interlocutor;
+	TPlayer *Interlocutor = GetPlayer(InterlocutorID);
+	if(Interlocutor == NULL){
+		error("TBehaviourDatabase::react: Interlocutor does not exist"
+				" (Text=%s, Situation=%d).\n", Text, Situation);
+		return;
+	}
+
+	int64 StartTime = GetMonotonicMicroseconds();
+	int Parameters[2] = {-1, -1};
+	int BestMatch = this->match(Npc, Interlocutor, Text, Situation, Parameters);
 	if(BestMatch == -1){
+		RecordNpcReaction(Npc, StartTime);
 		return;
 	}
 
@@ -1286,6 +1573,8 @@ void TBehaviourDatabase::react(TNPC *Npc, const char *Text, SITUATION Situation)
 			Npc->LastTalk = (TalkDelay / 1000) + RoundNr;
 		}
 	}
+
+	RecordNpcReaction(Npc, StartTime);
 }
 
 // Monster Homes
@@ -1297,7 +1586,7 @@ void StartMonsterhomeTimer(int Nr){
 	}
 
 	TMonsterhome *MH = Monsterhome.at(Nr);
-	if(MH->Timer > 0){
+	if(MH->TimerRound != 0){
 		error("StartMonsterhomeTimer: Counter is already running.\n");
 		return;
 	}
@@ -1316,7 +1605,67 @@ void StartMonsterhomeTimer(int Nr){
 		MaxTimer = (MaxTimer * 200) / ((NumPlayers / 2) + 100);
 	}
 
-	MH->Timer = random(MaxTimer / 2, MaxTimer);
+	// NOTE(fusion): A zero timer is never started, as before, which leaves the
+	// monsterhome idle until one of its monsters dies.
+	int Timer = random(MaxTimer / 2, MaxTimer);
+	if(Timer > 0){
+		MH->TimerRound = MonsterhomeRound + (uint32)Timer;
+		MonsterhomeQueue.insert(((uint64)MH->TimerRound << 32) | (uint64)Nr, Nr);
+	}
+}
+
+// NOTE(fusion): Recompute spawn candidates of monsterhomes that may reach into
+// the given sector, or all of them if `SectorZ` is negative. This must be called
+// whenever houses or protection zones change, which is after loading houses and
+// patches at startup and after each patch.
+void RefreshMonsterhomeCandidates(int SectorX, int SectorY, int SectorZ){
+	if(MonsterhomeCandidates == NULL){
+		return;
+	}
+
+	for(int i = 1; i <= Monsterhomes; i += 1){
+		TMonsterhome *MH = Monsterhome.at(i);
+		if(SectorZ >= 0){
+			if(MH->z != SectorZ
+					|| (MH->x + SPAWN_CANDIDATE_DISTANCE) < SectorX * 32
+					|| (MH->x - SPAWN_CANDIDATE_DISTANCE) >= (SectorX + 1) * 32
+					|| (MH->y + SPAWN_CANDIDATE_DISTANCE) < SectorY * 32
+					|| (MH->y - SPAWN_CANDIDATE_DISTANCE) >= (SectorY + 1) * 32){
+				continue;
+			}
+		}
+
+		GetSpawnCandidates(MH->x, MH->y, MH->z, false, &MonsterhomeCandidates[i]);
+		if(SectorZ < 0 && MonsterhomeCandidates[i].Count == 0){
+			print(1, "WARNING: Monsterhome [%d,%d,%d] has no spawn fields.\n", MH->x, MH->y, MH->z);
+		}
+	}
+}
+
+static const TSpawnCandidates *GetMonsterhomeCandidates(int Nr){
+	if(MonsterhomeCandidates == NULL || Nr < 1 || Nr > Monsterhomes){
+		return NULL;
+	}
+	return &MonsterhomeCandidates[Nr];
+}
+
+void GetMonsterhomeStatistics(int *Homes, int *Running,
+		uint32 *Spawns, uint32 *Blocked, uint32 *NoField){
+	*Homes = Monsterhomes;
+	*Running = MonsterhomeQueue.Entries;
+	*Spawns = MonsterhomeSpawns;
+	*Blocked = MonsterhomeBlocked;
+	*NoField = MonsterhomeNoField;
+}
+
+void MonsterhomeSummary(void){
+	Log("game", "Monsterhomes: %d homes, %d timers running, %u spawns,"
+			" %u attempts blocked by players, %u attempts without free field.\n",
+			Monsterhomes, MonsterhomeQueue.Entries, MonsterhomeSpawns,
+			MonsterhomeBlocked, MonsterhomeNoField);
+	MonsterhomeSpawns = 0;
+	MonsterhomeBlocked = 0;
+	MonsterhomeNoField = 0;
 }
 
 void LoadMonsterhomes(void){
@@ -1345,7 +1694,7 @@ void LoadMonsterhomes(void){
 		MH->MaxMonsters = Script.readNumber();
 		MH->ActMonsters = 0;
 		MH->RegenerationTime = Script.readNumber();
-		MH->Timer = 0;
+		MH->TimerRound = 0;
 
 		if(!IsOnMap(MH->x, MH->y, MH->z)){
 			print(1, "WARNING: Monsterhome [%d,%d,%d] located outside the map.\n", MH->x, MH->y, MH->z);
@@ -1355,6 +1704,14 @@ void LoadMonsterhomes(void){
 	print(1, "%d Monsterhomes loaded.\n", Monsterhomes);
 	Script.close();
 
+	// NOTE(fusion): Houses and patches aren't loaded yet, so these are computed
+	// again by `RefreshMonsterhomeCandidates` once they are.
+	MonsterhomeCandidates = new TSpawnCandidates[Monsterhomes + 1];
+	for(int i = 1; i <= Monsterhomes; i += 1){
+		TMonsterhome *MH = Monsterhome.at(i);
+		GetSpawnCandidates(MH->x, MH->y, MH->z, false, &MonsterhomeCandidates[i]);
+	}
+
 	for(int i = 0; i < Monsterhomes; i += 1){
 		TMonsterhome *MH = Monsterhome.at(i);
 		for (int j = 0; j < MH->MaxMonsters; j += 1){
@@ -1377,13 +1734,14 @@ void LoadMonsterhomes(void){
 				SpawnRadius = -SpawnRadius;
 			}
 
-			if(SearchSpawnField(&SpawnX, &SpawnY, &SpawnZ, SpawnRadius, false)){
+			if(SearchSpawnField(&SpawnX, &SpawnY, &SpawnZ, SpawnRadius,
+					false, GetMonsterhomeCandidates(i))){
 				CreateMonster(MH->Race, SpawnX, SpawnY, SpawnZ, i, 0, false);
 				MH->ActMonsters += 1;
 			}
 		}
 
-		if(MH->Timer > 0){
+		if(MH->TimerRound != 0){
 			error("LoadMonsterhomes: Timer is already running (Race %d at [%d,%d,%d]).\n",
 					MH->Race, MH->x, MH->y, MH->z);
 		}else if(MH->ActMonsters < MH->MaxMonsters){
@@ -1393,19 +1751,24 @@ void LoadMonsterhomes(void){
 }
 
 void ProcessMonsterhomes(void){
-	for(int i = 1; i <= Monsterhomes; i += 1){
-		TMonsterhome *MH = Monsterhome.at(i);
-
-		ASSERT(MH->Timer >= 0);
-		if(MH->Timer == 0){
-			continue;
+	MonsterhomeRound += 1;
+	while(MonsterhomeQueue.Entries > 0){
+		auto Entry = *MonsterhomeQueue.Entry->at(1);
+		uint32 Round = (uint32)(Entry.Key >> 32);
+		if(Round > MonsterhomeRound){
+			break;
 		}
 
-		MH->Timer -= 1;
-		if(MH->Timer > 0){
+		MonsterhomeQueue.deleteMin();
+		int i = Entry.Data;
+		TMonsterhome *MH = Monsterhome.at(i);
+		if(MH->TimerRound != Round){
+			error("ProcessMonsterhomes: Timer of monsterhome %d is out of sync.\n", i);
 			continue;
 		}
 
+		MH->TimerRound = 0;
+
 		int MaxRadius = MH->Radius;
 		if(MaxRadius > 10){
 			MaxRadius = 10;
@@ -1436,7 +1799,12 @@ void ProcessMonsterhomes(void){
 			}
 		}
 
-		if(MaxRadius >= 0){
+		const TSpawnCandidates *Candidates = GetMonsterhomeCandidates(i);
+		if(MaxRadius < 0){
+			MonsterhomeBlocked += 1;
+		}else if(Candidates != NULL && Candidates->Count == 0){
+			MonsterhomeNoField += 1;
+		}else{
 			int SpawnX = MH->x;
 			int SpawnY = MH->y;
 			int SpawnZ = MH->z;
@@ -1452,15 +1820,18 @@ void ProcessMonsterhomes(void){
 				SpawnRadius = -SpawnRadius;
 			}
 
-			if(SearchSpawnField(&SpawnX, &SpawnY, &SpawnZ, SpawnRadius, false)){
+			if(SearchSpawnField(&SpawnX, &SpawnY, &SpawnZ, SpawnRadius, false, Candidates)){
 				CreateMonster(MH->Race, SpawnX, SpawnY, SpawnZ, i, 0, false);
 				MH->ActMonsters += 1;
+				MonsterhomeSpawns += 1;
 
 				// TODO(fusion): Not sure why this check is here.
-				if(MH->Timer > 0){
+				if(MH->TimerRound != 0){
 					error("ProcessMonsterhomes: Timer is already running (Race %d at [%d,%d,%d]).\n",
 							MH->Race, SpawnX, SpawnY, SpawnZ);
 				}
+			}else{
+				MonsterhomeNoField += 1;
 			}
 		}
 
@@ -1489,7 +1860,7 @@ void NotifyMonsterhomeOfDeath(int Nr){
 		return;
 	}
 
-	if(MH->Timer == 0){
+	if(MH->TimerRound == 0){
 		StartMonsterhomeTimer(Nr);
 	}
 }
@@ -1561,6 +1932,9 @@ TNPC::TNPC(const char *FileName) :
 	this->LastTalk = 0;
 	this->QueueLength = 0;
 	this->Behaviour = NULL;
+	this->Reactions = 0;
+	this->ReactionTimeTotal = 0;
+	this->ReactionTimeMax = 0;
 
 	TReadScriptFile Script;
 	Script.open(FileName);
@@ -2257,6 +2631,32 @@ bool TMonster::MovePossible(int x, int y, int z, bool Execute, bool Jump){
 	return false;
 }
 
+bool TMonster::GetMoveProfile(TMoveProfile *Profile){
+	// NOTE(fusion): Outside of combat, `MovePossible` also depends on the home
+	// and current position of the monster, which can't be shared.
+	if(this->State != ATTACKING && this->State != PANIC){
+		return false;
+	}
+
+	if(this->Skills[SKILL_GO_STRENGTH]->Act < 0){
+		return false;
+	}
+
+	uint32 Flags = 0;
+	if(this->State == PANIC)				Flags |= 0x01;
+	if(this->CanKickBoxes())				Flags |= 0x02;
+	if(RaceData[this->Race].KickCreatures)	Flags |= 0x04;
+	if(RaceData[this->Race].SeeInvisible)	Flags |= 0x08;
+	if(RaceData[this->Race].NoPoison)		Flags |= 0x10;
+	if(RaceData[this->Race].NoBurning)		Flags |= 0x20;
+	if(RaceData[this->Race].NoEnergy)		Flags |= 0x40;
+
+	Profile->Target = this->Target;
+	Profile->Master = this->Master;
+	Profile->Flags = Flags;
+	return true;
+}
+
 bool TMonster::IsPeaceful(void){
 	return this->Master != 0
 		&& IsCreaturePlayer(this->Master);
@@ -2424,13 +2824,14 @@ void TMonster::IdleStimulus(void){
 
 			int BestStrategyParam = INT_MIN;
 			int BestTieBreaker = 0;
-			TFindCreatures Search(12, 12, this->ID, FIND_PLAYERS | FIND_MONSTERS);
+			TFindTargets Search(12, 12, this->ID);
 			while(true){
-				uint32 TargetID = Search.getNext();
-				if(TargetID == 0){
+				TTargetCandidate *Candidate = Search.getNext();
+				if(Candidate == NULL){
 					break;
 				}
 
+				uint32 TargetID = Candidate->ID;
 				TCreature *Target = GetCreature(TargetID);
 				if(Target == NULL){
 					error("TMonster::IdleStimulus: Creature does not exist.\n");
@@ -2447,15 +2848,14 @@ void TMonster::IdleStimulus(void){
 
 				// TODO(fusion): This is quite similar to the conditions for losing
 				// the target. Perhaps there is some common inlined function.
-				int DistanceX = std::abs(Target->posx - this->posx);
-				int DistanceY = std::abs(Target->posy - this->posy);
-				if((Target->posz != this->posz || DistanceX > 10 || DistanceY > 10)
-						||(Target->Type == PLAYER && CheckRight(Target->ID, IGNORED_BY_MONSTERS))
+				// NOTE(fusion): Protection zones, houses, and the IGNORED_BY_MONSTERS
+				// right were precomputed by `TFindTargets`.
+				int DistanceX = std::abs(Candidate->x - this->posx);
+				int DistanceY = std::abs(Candidate->y - this->posy);
+				if((Candidate->z != this->posz || DistanceX > 10 || DistanceY > 10)
+						|| Candidate->Ignored
 						|| (Target->IsInvisible() && !RaceData[this->Race].SeeInvisible)
-						|| IsProtectionZone(Target->posx, Target->posy, Target->posz)
-						|| IsHouse(Target->posx, Target->posy, Target->posz)
-						|| std::abs(Target->posx - this->posx) > 10
-						|| std::abs(Target->posy - this->posy) > 10){
+						|| Candidate->Protected){
 					continue;
 				}
 
@@ -2682,7 +3082,7 @@ void TMonster::IdleStimulus(void){
 						if(Distance == 3){
 							this->ToDoWait(1000);
 						}
-						this->ToDoGo(Target->posx, Target->posy, Target->posz, false, 3);
+						this->ToDoGo(Target->posx, Target->posy, Target->posz, false, 3, true);
 					}
 					this->ToDoStart();
 					return;
@@ -2715,7 +3115,7 @@ void TMonster::IdleStimulus(void){
 						// it's because `ToDoAttack` with `CHASE_MODE_CLOSE` will
 						// already take care of walking to the target?
 						if(this->State != ATTACKING && this->State != PANIC){
-							this->ToDoGo(Target->posx, Target->posy, Target->posz, false, 3);
+							this->ToDoGo(Target->posx, Target->posy, Target->posz, false, 3, true);
 						}
 					}else{
 						int DestX = this->posx;
@@ -2749,7 +3149,7 @@ void TMonster::IdleStimulus(void){
 							this->ToDoWait(1000);
 						}
 					}else if(Distance > 4){
-						this->ToDoGo(Target->posx, Target->posy, Target->posz, false, Distance - 4);
+						this->ToDoGo(Target->posx, Target->posy, Target->posz, false, Distance - 4, true);
 					}else{
 						int DestX = this->posx;
 						int DestY = this->posy;
@@ -3125,6 +3525,48 @@ void InitNPCs(void){
 	closedir(NpcDir);
 }
 
+void NpcReactionSummary(void){
+	uint32 Reactions = 0;
+	int64 TimeTotal = 0;
+	int64 TimeMax = 0;
+	TNPC *Busiest = NULL;
+	for(int i = 0; i < FirstFreeNonplayer; i += 1){
+		TNonplayer *Nonplayer = *NonplayerList.at(i);
+		if(Nonplayer == NULL || Nonplayer->Type != NPC){
+			continue;
+		}
+
+		TNPC *Npc = (TNPC*)Nonplayer;
+		if(Busiest == NULL || Npc->ReactionTimeTotal > Busiest->ReactionTimeTotal){
+			Busiest = Npc;
+		}
+
+		Reactions += Npc->Reactions;
+		TimeTotal += Npc->ReactionTimeTotal;
+		TimeMax = std::max<int64>(TimeMax, Npc->ReactionTimeMax);
+	}
+
+	if(Reactions > 0 && Busiest != NULL){
+		Log("game", "NPC reactions: %u reactions, average %d usec, max %d usec.\n",
+				Reactions, (int)(TimeTotal / Reactions), (int)TimeMax);
+		Log("game", "NPC reactions: busiest NPC %s with %u reactions,"
+				" average %d usec, max %d usec.\n",
+				Busiest->Name, Busiest->Reactions,
+				(int)(Busiest->ReactionTimeTotal / std::max<uint32>(Busiest->Reactions, 1)),
+				(int)Busiest->ReactionTimeMax);
+	}
+
+	for(int i = 0; i < FirstFreeNonplayer; i += 1){
+		TNonplayer *Nonplayer = *NonplayerList.at(i);
+		if(Nonplayer != NULL && Nonplayer->Type == NPC){
+			TNPC *Npc = (TNPC*)Nonplayer;
+			Npc->Reactions = 0;
+			Npc->ReactionTimeTotal = 0;
+			Npc->ReactionTimeMax = 0;
+		}
+	}
+}
+
 void InitNonplayer(void){
 	print(1, "Initializing Nonplayers ...\n");
 	FirstFreeNonplayer = 0;
@@ -3140,6 +3582,9 @@ void ExitNonplayer(void){
 		delete Nonplayer;
 	}
 
+	delete[] MonsterhomeCandidates;
+	MonsterhomeCandidates = NULL;
+
 	// TODO(fusion): For any reason `BehaviourNodeTable` was originally a
 	// pointer and it was deleted here. I doesn't really make a difference
 	// because we'd usually exit after calling this function but if we wanted
@@ -8,16 +8,146 @@
 #include "threads.hh"
 #include "writer.hh"
 
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
 static Semaphore PlayerMutex(1);
 static vector<TPlayer*> PlayerList(0, 100, 10, NULL);
 static int FirstFreePlayer;
 
+// NOTE(fusion): The online list is published as a delta of joins, leaves, and
+// level or profession changes since the last publish, with a complete list
+// every `PLAYERLIST_RESYNC_INTERVAL` publishes. Players remember what was last
+// published for them, and published players that leave are queued here until
+// the next publish. See `CreatePlayerList`.
+#define PLAYERLIST_RESYNC_INTERVAL 6
+static vector<TPlayerIndexEntry> PlayerlistLeave(0, 100, 100);
+static int PlayerlistLeaves;
+static int PlayerlistPublishes;
+
+static void RecordPlayerlistLeave(TPlayer *Player){
+	if(Player->PublishedLevel == 0){
+		return;
+	}
+
+	TPlayerIndexEntry *Leave = PlayerlistLeave.at(PlayerlistLeaves);
+	strcpy(Leave->Name, Player->Name);
+	Leave->CharacterID = Player->ID;
+	PlayerlistLeaves += 1;
+	Player->PublishedLevel = 0;
+}
+
+// NOTE(fusion): Slots are found through an open addressed CharacterID index,
+// holding slot numbers plus one, and empty slots are kept on a stack so that
+// neither lookups nor assignments have to scan the pool while holding
+// `PlayerDataPoolMutex`. Only evictions still do.
 static Semaphore PlayerDataPoolMutex(1);
-static TPlayerData PlayerDataPool[2000];
+static TPlayerData *PlayerDataPool;
+static int PlayerDataPoolSlots;
+static int *PlayerDataPoolIndex;
+static int PlayerDataPoolIndexSize;
+static int PlayerDataPoolIndexShift;
+static int *PlayerDataPoolFree;
+static int PlayerDataPoolFreeSlots;
+static uint32 PlayerDataPoolEvictions;
+static uint32 PlayerDataPoolDirtyEvictions;
+
+// NOTE(fusion): Advanced whenever a locked slot is released, so threads that
+// need a slot held by someone else can block until that happens instead of
+// polling the pool.
+static Event PlayerDataPoolReleased;
+
+// TQuestValues
+// =============================================================================
+static int FindQuestValue(TQuestValues *Values, int QuestNr){
+	// NOTE(fusion): Returns the index of `QuestNr` if present, or the index
+	// where it would have to be inserted otherwise.
+	int Low = 0;
+	int High = Values->Count;
+	while(Low < High){
+		int Mid = (Low + High) / 2;
+		if((int)Values->Entry[Mid].QuestNr < QuestNr){
+			Low = Mid + 1;
+		}else{
+			High = Mid;
+		}
+	}
+	return Low;
+}
+
+int TQuestValues::get(int QuestNr){
+	int Index = FindQuestValue(this, QuestNr);
+	if(Index < this->Count && (int)this->Entry[Index].QuestNr == QuestNr){
+		return this->Entry[Index].Value;
+	}
+	return 0;
+}
+
+void TQuestValues::set(int QuestNr, int Value){
+	if(QuestNr < 0 || QuestNr >= MAX_QUESTS){
+		error("TQuestValues::set: Invalid number %d.\n", QuestNr);
+		return;
+	}
+
+	int Index = FindQuestValue(this, QuestNr);
+	bool Found = Index < this->Count && (int)this->Entry[Index].QuestNr == QuestNr;
+	if(Found){
+		if(Value != 0){
+			this->Entry[Index].Value = Value;
+		}else{
+			memmove(&this->Entry[Index], &this->Entry[Index + 1],
+					(this->Count - Index - 1) * sizeof(TQuestValue));
+			this->Count -= 1;
+		}
+	}else if(Value != 0){
+		if(this->Count >= this->Capacity){
+			int Capacity = std::max<int>(this->Capacity * 2, 16);
+			TQuestValue *Entry = (TQuestValue*)realloc(this->Entry,
+					Capacity * sizeof(TQuestValue));
+			if(Entry == NULL){
+				throw std::bad_alloc();
+			}
+			this->Entry = Entry;
+			this->Capacity = Capacity;
+		}
+
+		memmove(&this->Entry[Index + 1], &this->Entry[Index],
+				(this->Count - Index) * sizeof(TQuestValue));
+		this->Entry[Index].QuestNr = (uint16)QuestNr;
+		this->Entry[Index].Value = Value;
+		this->Count += 1;
+	}
+}
+
+void TQuestValues::copy(TQuestValues *Other){
+	if(this->Capacity < Other->Count){
+		TQuestValue *Entry = (TQuestValue*)realloc(this->Entry,
+				Other->Count * sizeof(TQuestValue));
+		if(Entry == NULL){
+			throw std::bad_alloc();
+		}
+		this->Entry = Entry;
+		this->Capacity = Other->Count;
+	}
+
+	if(Other->Count > 0){
+		memcpy(this->Entry, Other->Entry, Other->Count * sizeof(TQuestValue));
+	}
+	this->Count = Other->Count;
+}
+
+void TQuestValues::clear(void){
+	this->Count = 0;
+}
 
-static TPlayerIndexInternalNode PlayerIndexHead;
-static store<TPlayerIndexInternalNode, 100> PlayerIndexInternalNodes;
-static store<TPlayerIndexLeafNode, 100> PlayerIndexLeafNodes;
+void TQuestValues::release(void){
+	free(this->Entry);
+	this->Entry = NULL;
+	this->Count = 0;
+	this->Capacity = 0;
+}
 
 // TPlayer
 // =============================================================================
@@ -37,6 +167,8 @@ TPlayer::TPlayer(TConnection *Connection, uint32 CharacterID):
 	this->Depot = NONE;
 	this->DepotNr = 0;
 	this->DepotSpace = 0;
+	this->DepotMaterialized = false;
+	this->DepotIdleRound = 0;
 	this->ConstructError = NOERROR;
 	this->PlayerData = NULL;
 	this->TradeObject = NONE;
@@ -57,6 +189,8 @@ TPlayer::TPlayer(TConnection *Connection, uint32 CharacterID):
 	this->TalkBufferFullTime = 0;
 	this->MutingEndRound = 0;
 	this->NumberOfMutings = 0;
+	this->PublishedLevel = 0;
+	this->PublishedProfession = 0;
 
 	memset(this->Rights, 0, sizeof(this->Rights));
 
@@ -66,11 +200,9 @@ TPlayer::TPlayer(TConnection *Connection, uint32 CharacterID):
 		this->SpellList[SpellNr] = 0;
 	}
 
-	for(int QuestNr = 0;
-			QuestNr < NARRAY(this->QuestValues);
-			QuestNr += 1){
-		this->QuestValues[QuestNr] = 0;
-	}
+	this->QuestValues.Count = 0;
+	this->QuestValues.Capacity = 0;
+	this->QuestValues.Entry = NULL;
 
 	for(int ContainerNr = 0;
 			ContainerNr < NARRAY(this->OpenContainer);
@@ -104,7 +236,7 @@ TPlayer::TPlayer(TConnection *Connection, uint32 CharacterID):
 	//	I couldn't find any functions here with unhandled exceptions so we might
 	// want to keep an eye out.
 	this->SetID(CharacterID);
-	InsertPlayerIndex(&PlayerIndexHead, 0, this->Name, CharacterID);
+	InsertPlayerIndex(this->Name, CharacterID);
 	this->LoadData();
 	this->AccountID = PlayerData->AccountID;
 	strcpy(this->IPAddress, Connection->GetIPAddress());
@@ -227,6 +359,7 @@ TPlayer::TPlayer(TConnection *Connection, uint32 CharacterID):
 TPlayer::~TPlayer(void){
 	LogoutOrder(this);
 	if(this->ConstructError != NOERROR){
+		this->QuestValues.release();
 		this->DelInList();
 		return;
 	}
@@ -275,11 +408,7 @@ TPlayer::~TPlayer(void){
 				PlayerData->SpellList[SpellNr] = 0;
 			}
 
-			for(int QuestNr = 0;
-					QuestNr < NARRAY(PlayerData->QuestValues);
-					QuestNr += 1){
-				PlayerData->QuestValues[QuestNr] = 0;
-			}
+			PlayerData->QuestValues.clear();
 
 			// NOTE(fusion): This is used to reset skills back to default. See
 			// `TPlayer::LoadData`.
@@ -313,12 +442,18 @@ TPlayer::~TPlayer(void){
 	}
 
 	this->ClearPlayerkillingMarks();
+	RecordPlayerlistLeave(this);
 	this->DelInList();
 
+	// NOTE(fusion): Most of the player data was just written back by `SaveData`
+	// and `SaveInventory`. Sections that didn't actually change are skipped when
+	// saving.
 	PlayerData->Dirty = true;
+	PlayerData->DirtySections |= PLAYER_DIRTY_ALL;
 	// TODO(fusion): Something is telling me that `PlayerData->Sticky` is also poorly managed.
 	DecreasePlayerPoolSlotSticky(PlayerData);
 	ReleasePlayerPoolSlot(PlayerData);
+	this->QuestValues.release();
 }
 
 void TPlayer::Death(void){
@@ -517,12 +652,7 @@ void TPlayer::LoadData(void){
 		this->SpellList[SpellNr] = PlayerData->SpellList[SpellNr];
 	}
 
-	STATIC_ASSERT(NARRAY(this->QuestValues) == NARRAY(PlayerData->QuestValues));
-	for(int QuestNr = 0;
-			QuestNr < NARRAY(this->QuestValues);
-			QuestNr += 1){
-		this->QuestValues[QuestNr] = PlayerData->QuestValues[QuestNr];
-	}
+	this->QuestValues.copy(&PlayerData->QuestValues);
 
 	// NOTE(fusion): `Minimum` is set to `INT_MIN` to skip loading a skill, and
 	// stick with the race's default.
@@ -586,12 +716,7 @@ void TPlayer::SaveData(void){
 		PlayerData->SpellList[SpellNr] = this->SpellList[SpellNr];
 	}
 
-	STATIC_ASSERT(NARRAY(this->QuestValues) == NARRAY(PlayerData->QuestValues));
-	for(int QuestNr = 0;
-			QuestNr < NARRAY(this->QuestValues);
-			QuestNr += 1){
-		PlayerData->QuestValues[QuestNr] = this->QuestValues[QuestNr];
-	}
+	PlayerData->QuestValues.copy(&this->QuestValues);
 
 	STATIC_ASSERT(NARRAY(this->Skills) == NARRAY(PlayerData->Actual));
 	for(int SkillNr = 0;
@@ -671,6 +796,10 @@ void TPlayer::LoadInventory(bool SetStandardInventory){
 			error("TPlayer::LoadInventory: Exception %d while creating standard inventory.\n", r);
 		}
 	}
+
+	// NOTE(fusion): `LoadObjects` bypasses the object operations that keep
+	// the inventory index up to date.
+	RebuildInventoryIndex(this->ID);
 }
 
 void TPlayer::SaveInventory(void){
@@ -726,7 +855,9 @@ void TPlayer::TakeOver(TConnection *Connection){
 	this->Connection = Connection;
 	Connection->EnterGame();
 
+	PlayerDataPoolMutex.down();
 	TPlayerData *PlayerData = GetPlayerPoolSlot(this->ID);
+	PlayerDataPoolMutex.up();
 	if(PlayerData == NULL){
 		error("TPlayer::TakeOver: PlayerData-Slot not found.\n");
 		return;
@@ -743,7 +874,7 @@ void TPlayer::TakeOver(TConnection *Connection){
 	}
 
 	strcpy(this->Name, PlayerData->Name);
-	InsertPlayerIndex(&PlayerIndexHead, 0, this->Name, this->ID);
+	InsertPlayerIndex(this->Name, this->ID);
 	strcpy(this->IPAddress, Connection->GetIPAddress());
 	memcpy(this->Rights, PlayerData->Rights, sizeof(this->Rights));
 	this->Sex = PlayerData->Sex;
@@ -1152,25 +1283,26 @@ void TPlayer::LearnSpell(int SpellNr){
 }
 
 int TPlayer::GetQuestValue(int QuestNr){
-	if(QuestNr < 0 || QuestNr >= NARRAY(this->QuestValues)){
+	if(QuestNr < 0 || QuestNr >= MAX_QUESTS){
 		error("TPlayer::GetQuestValue: Invalid number %d.\n", QuestNr);
 		return 0;
 	}
 
+	int Value = this->QuestValues.get(QuestNr);
 	print(3, "Wert der Questvariablen %d von %s: %d.\n",
-			QuestNr, this->Name, this->QuestValues[QuestNr]);
-	return this->QuestValues[QuestNr];
+			QuestNr, this->Name, Value);
+	return Value;
 }
 
 void TPlayer::SetQuestValue(int QuestNr, int Value){
-	if(QuestNr < 0 || QuestNr >= NARRAY(this->QuestValues)){
+	if(QuestNr < 0 || QuestNr >= MAX_QUESTS){
 		error("TPlayer::SetQuestValue: Invalid number %d.\n", QuestNr);
 		return;
 	}
 
 	print(3, "New value for quest variable %d from %s: %d.\n",
 			QuestNr, this->Name, Value);
-	this->QuestValues[QuestNr] = Value;
+	this->QuestValues.set(QuestNr, Value);
 }
 
 void TPlayer::CheckOutfit(void){
@@ -1933,32 +2065,56 @@ void NotifyBuddies(uint32 CharacterID, const char *Name, bool Login){
 
 void CreatePlayerList(bool Online){
 	// TODO(fusion): Same as `WriteKillStatistics` for names.
+	bool Delta = Online && (PlayerlistPublishes % PLAYERLIST_RESYNC_INTERVAL) != 0;
+	PlayerlistPublishes += 1;
 
-	// TODO(fusion): We can avoid allocating these buffers when `Online` is false.
-	// We'll be sure when we dive into `writer.cc` and `reader.cc` and learn more
-	// about these "orders".
-
-	char *PlayerNames = new char[FirstFreePlayer * 30];
-	int *PlayerLevels = new int[FirstFreePlayer];
-	int *PlayerProfessions = new int[FirstFreePlayer];
+	int MaxPlayers = FirstFreePlayer + (Delta ? PlayerlistLeaves : 0);
+	char *PlayerNames = new char[MaxPlayers * 30];
+	int *PlayerLevels = new int[MaxPlayers];
+	int *PlayerProfessions = new int[MaxPlayers];
 	int NumberOfPlayers = -1;
 	if(Online){
 		NumberOfPlayers = 0;
+		if(Delta){
+			for(int LeaveNr = 0; LeaveNr < PlayerlistLeaves; LeaveNr += 1){
+				strcpy(&PlayerNames[NumberOfPlayers * 30], PlayerlistLeave.at(LeaveNr)->Name);
+				PlayerLevels[NumberOfPlayers] = 0;
+				PlayerProfessions[NumberOfPlayers] = 0;
+				NumberOfPlayers += 1;
+			}
+		}
+
 		for(int Index = 0; Index < FirstFreePlayer; Index += 1){
 			TPlayer *Player = *PlayerList.at(Index);
 			if(CheckRight(Player->ID, NO_STATISTICS)){
 				continue;
 			}
 
-			strcpy(&PlayerNames[Index * 30], Player->Name);
-			PlayerLevels[Index] = Player->Skills[SKILL_LEVEL]->Get();
-			PlayerProfessions[Index] = Player->GetActiveProfession();
-			NumberOfPlayers += 1;
+			int Level = Player->Skills[SKILL_LEVEL]->Get();
+			int Profession = Player->GetActiveProfession();
+			if(!Delta || Player->PublishedLevel != Level
+					|| Player->PublishedProfession != Profession){
+				strcpy(&PlayerNames[NumberOfPlayers * 30], Player->Name);
+				PlayerLevels[NumberOfPlayers] = Level;
+				PlayerProfessions[NumberOfPlayers] = Profession;
+				NumberOfPlayers += 1;
+			}
+
+			Player->PublishedLevel = Level;
+			Player->PublishedProfession = Profession;
 		}
 		Log("load", "%d %d\n", (int)time(NULL), FirstFreePlayer);
 	}
+	PlayerlistLeaves = 0;
 
-	PlayerlistOrder(NumberOfPlayers, PlayerNames, PlayerLevels, PlayerProfessions);
+	if(Delta && NumberOfPlayers == 0){
+		delete[] PlayerNames;
+		delete[] PlayerLevels;
+		delete[] PlayerProfessions;
+		return;
+	}
+
+	PlayerlistOrder(NumberOfPlayers, PlayerNames, PlayerLevels, PlayerProfessions, Delta);
 }
 
 void PrintPlayerPositions(void){
@@ -1992,6 +2148,12 @@ void LoadDepot(TPlayerData *PlayerData, int DepotNr, Object Con){
 		throw ERROR;
 	}
 
+	if(!LoadPlayerDepot(PlayerData, DepotNr)){
+		error("LoadDepot: Cannot read depot %d of player %u.\n",
+				DepotNr, PlayerData->CharacterID);
+		throw ERROR;
+	}
+
 	if(PlayerData->Depot[DepotNr] == NULL){
 		Create(Con, GetSpecialObject(DEPOT_CHEST), 0);
 	}else{
@@ -2028,28 +2190,78 @@ void SaveDepot(TPlayerData *PlayerData, int DepotNr, Object Con){
 		throw ERROR;
 	}
 
-	PlayerData->Dirty = true;
-	delete[] PlayerData->Depot[DepotNr];
-	PlayerData->Depot[DepotNr] = NULL;
-	PlayerData->DepotSize[DepotNr] = 0;
-
 	try{
 		TDynamicWriteBuffer HelpBuffer(KB(16));
 		SaveObjects(GetFirstContainerObject(Con), &HelpBuffer, false);
 
-		if(HelpBuffer.Position > 0){
-			int DepotSize = HelpBuffer.Position;
+		// NOTE(fusion): Most depots are closed without any changes, in which
+		// case the stored copy is still good and there is nothing to save.
+		int DepotSize = HelpBuffer.Position;
+		if(!PlayerData->DepotPending[DepotNr]
+				&& DepotSize == PlayerData->DepotSize[DepotNr]
+				&& (DepotSize == 0 || memcmp(PlayerData->Depot[DepotNr],
+						HelpBuffer.Data, DepotSize) == 0)){
+			return;
+		}
+
+		// NOTE(fusion): The depot is replaced as a whole so whatever is still on
+		// disk is now stale.
+		PlayerData->Dirty = true;
+		PlayerData->DirtyDepots |= (1 << DepotNr);
+		PlayerData->DepotPending[DepotNr] = false;
+		delete[] PlayerData->Depot[DepotNr];
+		PlayerData->Depot[DepotNr] = NULL;
+		PlayerData->DepotSize[DepotNr] = 0;
+
+		if(DepotSize > 0){
 			PlayerData->Depot[DepotNr] = new uint8[DepotSize];
 			PlayerData->DepotSize[DepotNr] = DepotSize;
 			memcpy(PlayerData->Depot[DepotNr], HelpBuffer.Data, DepotSize);
 		}
 	}catch(const char *str){
 		error("SaveDepot: Cannot write depot (%s).\n", str);
+		PlayerData->Dirty = true;
+		PlayerData->DirtyDepots |= (1 << DepotNr);
+		PlayerData->DepotPending[DepotNr] = false;
+		delete[] PlayerData->Depot[DepotNr];
 		PlayerData->Depot[DepotNr] = NULL;
 		PlayerData->DepotSize[DepotNr] = 0;
 	}
 }
 
+int CountDepotObjects(TPlayerData *PlayerData, int DepotNr){
+	if(PlayerData == NULL){
+		error("CountDepotObjects: PlayerData is NULL.\n");
+		throw ERROR;
+	}
+
+	if(DepotNr < 0 || DepotNr >= MAX_DEPOTS){
+		error("CountDepotObjects: Invalid depot number %d.\n", DepotNr);
+		throw ERROR;
+	}
+
+	if(!LoadPlayerDepot(PlayerData, DepotNr)){
+		error("CountDepotObjects: Cannot read depot %d of player %u.\n",
+				DepotNr, PlayerData->CharacterID);
+		throw ERROR;
+	}
+
+	// NOTE(fusion): An empty depot still gets its depot chest, see `LoadDepot`.
+	if(PlayerData->Depot[DepotNr] == NULL){
+		return 1;
+	}
+
+	try{
+		TReadBuffer ReadBuffer(
+				PlayerData->Depot[DepotNr],
+				PlayerData->DepotSize[DepotNr]);
+		return CountObjects(&ReadBuffer);
+	}catch(const char *str){
+		error("CountDepotObjects: Cannot read depot (%s).\n", str);
+		throw ERROR;
+	}
+}
+
 void GetProfessionName(char *Buffer, int Profession, bool Article, bool Capitals){
 	Buffer[0] = 0;
 
@@ -2126,509 +2338,1579 @@ void SendExistingRequests(TConnection *Connection){
 
 // Player Loader
 // =============================================================================
+// NOTE(fusion): Player data is stored either as a text script (`.usr`) or as
+// a binary file (`.usb`) made of a header, a section table, and the section
+// payloads themselves, each with its own checksum. Both formats are read so
+// that worlds can be migrated gradually but a binary file always takes over
+// its text counterpart, and saving removes whichever format isn't configured.
+//	The section table also allows depots to stay on disk until they're needed
+// which, for most logins, is never. The header also points at the table so
+// that changed sections can be appended, see `SavePlayerData`.
+#define PLAYERDATA_MAGIC 0x52594C50 // "PLYR"
+#define PLAYERDATA_VERSION 1
+#define PLAYERDATA_HEADER_SIZE 24
+#define PLAYERDATA_ENTRY_SIZE 16
+#define PLAYERDATA_MAX_SECTIONS 32
+#define PLAYERDATA_COMPACT_SLACK (16 * 1024)
+
+enum : int {
+	PLAYERDATA_SECTION_GENERAL		= 1,
+	PLAYERDATA_SECTION_SKILLS		= 2,
+	PLAYERDATA_SECTION_SPELLS		= 3,
+	PLAYERDATA_SECTION_QUESTS		= 4,
+	PLAYERDATA_SECTION_MURDERS		= 5,
+	PLAYERDATA_SECTION_INVENTORY	= 6,
+	PLAYERDATA_SECTION_DEPOT		= 7,
+};
+
+struct TPlayerDataSection {
+	int Type;
+	int Number;
+	int Offset;
+	int Size;
+	uint32 Checksum;
+};
+
+// NOTE(fusion): Save statistics for the current save interval. Saves happen
+// on the writer thread but also whenever a dirty slot is evicted, which may be
+// on any thread.
+static Semaphore PlayerDataSaveMutex(1);
+static int PlayerDataSaves;
+static int PlayerDataAppends;
+static int PlayerDataRewrites;
+static int64 PlayerDataBytesWritten;
+static int PlayerDataSaveStep;
+
+static uint32 PlayerDataChecksum(const uint8 *Data, int Size){
+	// NOTE(fusion): 32-bit FNV-1a.
+	uint32 Hash = 2166136261U;
+	for(int i = 0; i < Size; i += 1){
+		Hash = (Hash ^ Data[i]) * 16777619U;
+	}
+	return Hash;
+}
+
+static void RecordPlayerDataSave(int BytesWritten, bool Written, bool Rewrite){
+	PlayerDataSaveMutex.down();
+	PlayerDataSaves += 1;
+	if(Written){
+		if(Rewrite){
+			PlayerDataRewrites += 1;
+		}else{
+			PlayerDataAppends += 1;
+		}
+	}
+	PlayerDataBytesWritten += BytesWritten;
+	PlayerDataSaveMutex.up();
+}
+
+static void PlayerDataSaveSummary(void){
+	PlayerDataSaveMutex.down();
+	if(PlayerDataSaves > 0){
+		Log("game", "player data saves: %d (%d appended, %d rewritten, %d unchanged), %d KB written.\n",
+				PlayerDataSaves, PlayerDataAppends, PlayerDataRewrites,
+				(PlayerDataSaves - PlayerDataAppends - PlayerDataRewrites),
+				(int)(PlayerDataBytesWritten / 1024));
+	}
+	PlayerDataSaves = 0;
+	PlayerDataAppends = 0;
+	PlayerDataRewrites = 0;
+	PlayerDataBytesWritten = 0;
+	PlayerDataSaveMutex.up();
+}
+
 void PlayerDataPath(char *Buffer, int BufferSize, uint32 CharacterID){
 	snprintf(Buffer, BufferSize, "%s/%02u/%u.usr",
 			USERPATH, (CharacterID % 100), CharacterID);
 }
 
+void PlayerDataBinaryPath(char *Buffer, int BufferSize, uint32 CharacterID){
+	snprintf(Buffer, BufferSize, "%s/%02u/%u.usb",
+			USERPATH, (CharacterID % 100), CharacterID);
+}
+
 bool PlayerDataExists(uint32 CharacterID){
 	char FileName[4096];
+	PlayerDataBinaryPath(FileName, sizeof(FileName), CharacterID);
+	if(FileExists(FileName)){
+		return true;
+	}
+
 	PlayerDataPath(FileName, sizeof(FileName), CharacterID);
 	return FileExists(FileName);
 }
 
-bool LoadPlayerData(TPlayerData *Slot){
-	if(Slot == NULL){
-		error("LoadPlayerData: Slot is NULL.\n");
-		return false;
+static int ReadPlayerDataSections(TReadBinaryFile *File, uint32 CharacterID,
+		TPlayerDataSection *Sections, int MaxSections){
+	int FileSize = File->getSize();
+	if(FileSize < PLAYERDATA_HEADER_SIZE){
+		File->error("file too short");
 	}
 
-	if(Slot->CharacterID == 0){
-		error("LoadPlayerData: Slot contains no character.\n");
-		return false;
+	uint8 Header[PLAYERDATA_HEADER_SIZE];
+	File->readBytes(Header, PLAYERDATA_HEADER_SIZE);
+	TReadBuffer HeaderBuffer(Header, PLAYERDATA_HEADER_SIZE);
+	if(HeaderBuffer.readQuad() != PLAYERDATA_MAGIC){
+		File->error("invalid magic number");
 	}
 
-	// IMPORTANT(fusion): This function is only called from `AssignPlayerPoolSlot`
-	// which zero initializes it before hand. Note that it would be a problem
-	// otherwise, since we shouldn't write to `CharacterID`, `Locked`, or `Sticky`
-	// outside a critical section, making `memset` not viable and turning this
-	// into an assignment fiesta for no good reason.
-	Slot->Race = 1;
-	Slot->Profession = PROFESSION_NONE;
-	for(int SkillNr = 0;
-			SkillNr < NARRAY(Slot->Minimum);
-			SkillNr += 1){
-		// NOTE(fusion): See `TPlayer::LoadData`.
-		Slot->Minimum[SkillNr] = INT_MIN;
+	if(HeaderBuffer.readWord() != PLAYERDATA_VERSION){
+		File->error("unsupported version");
 	}
 
-	// NOTE(fusion): First login. Use defaults.
-	char FileName[4096];
-	PlayerDataPath(FileName, sizeof(FileName), Slot->CharacterID);
-	if(!FileExists(FileName)){
-		return true;
+	int NumSections = (int)HeaderBuffer.readWord();
+	if(NumSections <= 0 || NumSections > MaxSections){
+		File->error("invalid number of sections");
 	}
 
-	bool Result = false;
-	try{
-		// TODO(fusion): Same thing as house loaders. Data is expected to be in
-		// an exact order and we don't check identifiers
-		TDynamicWriteBuffer HelpBuffer(KB(16));
-		TReadScriptFile Script;
-		Script.open(FileName);
+	if(HeaderBuffer.readQuad() != CharacterID){
+		File->error("character id mismatch");
+	}
 
-		Script.readIdentifier(); // "id"
-		Script.readSymbol('=');
-		Script.readNumber();
+	uint32 TableChecksum = HeaderBuffer.readQuad();
+	int TableOffset = (int)HeaderBuffer.readQuad();
+	uint32 HeaderChecksum = PlayerDataChecksum(Header, HeaderBuffer.Position);
+	if(HeaderBuffer.readQuad() != HeaderChecksum){
+		File->error("header checksum mismatch");
+	}
 
-		Script.readIdentifier(); // "name"
-		Script.readSymbol('=');
-		strcpy(Slot->Name, Script.readString());
+	int TableSize = NumSections * PLAYERDATA_ENTRY_SIZE;
+	uint8 Table[PLAYERDATA_MAX_SECTIONS * PLAYERDATA_ENTRY_SIZE];
+	if(TableSize > (int)sizeof(Table) || TableOffset < PLAYERDATA_HEADER_SIZE
+			|| TableOffset > (FileSize - TableSize)){
+		File->error("section table out of bounds");
+	}
 
-		Script.readIdentifier(); // "race"
-		Script.readSymbol('=');
-		Slot->Race = Script.readNumber();
+	File->seek(TableOffset);
+	File->readBytes(Table, TableSize);
+	if(PlayerDataChecksum(Table, TableSize) != TableChecksum){
+		File->error("section table checksum mismatch");
+	}
 
-		Script.readIdentifier(); // "profession"
-		Script.readSymbol('=');
-		Slot->Profession = (uint8)Script.readNumber();
+	TReadBuffer TableBuffer(Table, TableSize);
+	for(int i = 0; i < NumSections; i += 1){
+		TPlayerDataSection *Section = &Sections[i];
+		Section->Type = (int)TableBuffer.readWord();
+		Section->Number = (int)TableBuffer.readWord();
+		Section->Offset = (int)TableBuffer.readQuad();
+		Section->Size = (int)TableBuffer.readQuad();
+		Section->Checksum = TableBuffer.readQuad();
+		if(Section->Offset < PLAYERDATA_HEADER_SIZE || Section->Size <= 0
+				|| Section->Offset > (FileSize - Section->Size)){
+			File->error("section out of bounds");
+		}
+	}
 
-		Script.readIdentifier(); // "originaloutfit"
-		Script.readSymbol('=');
-		Slot->OriginalOutfit = ReadOutfit(&Script);
+	return NumSections;
+}
 
-		Script.readIdentifier(); // "currentoutfit"
-		Script.readSymbol('=');
-		Slot->CurrentOutfit = ReadOutfit(&Script);
+static void ReadPlayerDataSection(TReadBinaryFile *File,
+		const TPlayerDataSection *Section, uint8 *Buffer, int BufferSize){
+	if(Section->Size > BufferSize){
+		File->error("section too large");
+	}
 
-		Script.readIdentifier(); // "lastlogin"
-		Script.readSymbol('=');
-		Slot->LastLoginTime = (time_t)Script.readNumber();
+	File->seek(Section->Offset);
+	File->readBytes(Buffer, Section->Size);
+	if(PlayerDataChecksum(Buffer, Section->Size) != Section->Checksum){
+		File->error("section checksum mismatch");
+	}
+}
 
-		Script.readIdentifier(); // "lastlogout"
-		Script.readSymbol('=');
-		Slot->LastLogoutTime = (time_t)Script.readNumber();
+static void ReadBinaryOutfit(TReadBuffer *Buffer, TOutfit *Outfit){
+	Outfit->OutfitID = (int)Buffer->readQuad();
+	Outfit->ObjectType = (int)Buffer->readQuad();
+}
 
-		Script.readIdentifier(); // "startposition"
-		Script.readSymbol('=');
-		Script.readCoordinate(&Slot->startx, &Slot->starty, &Slot->startz);
+static void WriteBinaryOutfit(TWriteBuffer *Buffer, TOutfit Outfit){
+	Buffer->writeQuad((uint32)Outfit.OutfitID);
+	Buffer->writeQuad((uint32)Outfit.ObjectType);
+}
 
-		Script.readIdentifier(); // "currentposition"
-		Script.readSymbol('=');
-		Script.readCoordinate(&Slot->posx, &Slot->posy, &Slot->posz);
+static void LoadPlayerDataText(TPlayerData *Slot, const char *FileName){
+	// TODO(fusion): Same thing as house loaders. Data is expected to be in
+	// an exact order and we don't check identifiers
+	TDynamicWriteBuffer HelpBuffer(KB(16));
+	TReadScriptFile Script;
+	Script.open(FileName);
 
-		Script.readIdentifier(); // "playerkillerend"
-		Script.readSymbol('=');
-		Slot->PlayerkillerEnd = Script.readNumber();
-
-		while(strcmp(Script.readIdentifier(), "skill") == 0){
-			Script.readSymbol('=');
-			Script.readSymbol('(');
-			int SkillNr = Script.readNumber();
-			if(SkillNr < 0 || SkillNr >= NARRAY(Slot->Minimum)){
-				Script.error("illegal skill number");
-			}
-			Script.readSymbol(',');
-			Slot->Actual[SkillNr] = Script.readNumber();
-			Script.readSymbol(',');
-			Slot->Maximum[SkillNr] = Script.readNumber();
-			Script.readSymbol(',');
-			Slot->Minimum[SkillNr] = Script.readNumber();
-			Script.readSymbol(',');
-			Slot->DeltaAct[SkillNr] = Script.readNumber();
-			Script.readSymbol(',');
-			Slot->MagicDeltaAct[SkillNr] = Script.readNumber();
-			Script.readSymbol(',');
-			Slot->Cycle[SkillNr] = Script.readNumber();
-			Script.readSymbol(',');
-			Slot->MaxCycle[SkillNr] = Script.readNumber();
-			Script.readSymbol(',');
-			Slot->Count[SkillNr] = Script.readNumber();
-			Script.readSymbol(',');
-			Slot->MaxCount[SkillNr] = Script.readNumber();
-			Script.readSymbol(',');
-			Slot->AddLevel[SkillNr] = Script.readNumber();
-			Script.readSymbol(',');
-			Slot->Experience[SkillNr] = Script.readNumber();
-			Script.readSymbol(',');
-			Slot->FactorPercent[SkillNr] = Script.readNumber();
-			Script.readSymbol(',');
-			Slot->NextLevel[SkillNr] = Script.readNumber();
-			Script.readSymbol(',');
-			Slot->Delta[SkillNr] = Script.readNumber();
-			Script.readSymbol(')');
-		}
-
-		// "spells", already primed in the loop condition above
-		Script.readSymbol('=');
-		Script.readSymbol('{');
-		while(true){
-			Script.nextToken();
-			if(Script.Token == SPECIAL){
-				if(Script.getSpecial() == '}'){
-					break;
-				}else if(Script.getSpecial() == ','){
-					continue;
-				}
-			}
+	Script.readIdentifier(); // "id"
+	Script.readSymbol('=');
+	Script.readNumber();
 
-			int SpellNr = Script.getNumber();
-			if(SpellNr < 0 || SpellNr >= NARRAY(Slot->SpellList)){
-				Script.error("illegal spell number");
-			}
+	Script.readIdentifier(); // "name"
+	Script.readSymbol('=');
+	strcpy(Slot->Name, Script.readString());
 
-			Slot->SpellList[SpellNr] = 1;
-		}
+	Script.readIdentifier(); // "race"
+	Script.readSymbol('=');
+	Slot->Race = Script.readNumber();
+
+	Script.readIdentifier(); // "profession"
+	Script.readSymbol('=');
+	Slot->Profession = (uint8)Script.readNumber();
+
+	Script.readIdentifier(); // "originaloutfit"
+	Script.readSymbol('=');
+	Slot->OriginalOutfit = ReadOutfit(&Script);
+
+	Script.readIdentifier(); // "currentoutfit"
+	Script.readSymbol('=');
+	Slot->CurrentOutfit = ReadOutfit(&Script);
+
+	Script.readIdentifier(); // "lastlogin"
+	Script.readSymbol('=');
+	Slot->LastLoginTime = (time_t)Script.readNumber();
+
+	Script.readIdentifier(); // "lastlogout"
+	Script.readSymbol('=');
+	Slot->LastLogoutTime = (time_t)Script.readNumber();
+
+	Script.readIdentifier(); // "startposition"
+	Script.readSymbol('=');
+	Script.readCoordinate(&Slot->startx, &Slot->starty, &Slot->startz);
 
-		Script.readIdentifier(); // "questvalues"
+	Script.readIdentifier(); // "currentposition"
+	Script.readSymbol('=');
+	Script.readCoordinate(&Slot->posx, &Slot->posy, &Slot->posz);
+
+	Script.readIdentifier(); // "playerkillerend"
+	Script.readSymbol('=');
+	Slot->PlayerkillerEnd = Script.readNumber();
+
+	while(strcmp(Script.readIdentifier(), "skill") == 0){
 		Script.readSymbol('=');
-		Script.readSymbol('{');
-		while(true){
-			char Special = Script.readSpecial();
-			if(Special == '}'){
+		Script.readSymbol('(');
+		int SkillNr = Script.readNumber();
+		if(SkillNr < 0 || SkillNr >= NARRAY(Slot->Minimum)){
+			Script.error("illegal skill number");
+		}
+		Script.readSymbol(',');
+		Slot->Actual[SkillNr] = Script.readNumber();
+		Script.readSymbol(',');
+		Slot->Maximum[SkillNr] = Script.readNumber();
+		Script.readSymbol(',');
+		Slot->Minimum[SkillNr] = Script.readNumber();
+		Script.readSymbol(',');
+		Slot->DeltaAct[SkillNr] = Script.readNumber();
+		Script.readSymbol(',');
+		Slot->MagicDeltaAct[SkillNr] = Script.readNumber();
+		Script.readSymbol(',');
+		Slot->Cycle[SkillNr] = Script.readNumber();
+		Script.readSymbol(',');
+		Slot->MaxCycle[SkillNr] = Script.readNumber();
+		Script.readSymbol(',');
+		Slot->Count[SkillNr] = Script.readNumber();
+		Script.readSymbol(',');
+		Slot->MaxCount[SkillNr] = Script.readNumber();
+		Script.readSymbol(',');
+		Slot->AddLevel[SkillNr] = Script.readNumber();
+		Script.readSymbol(',');
+		Slot->Experience[SkillNr] = Script.readNumber();
+		Script.readSymbol(',');
+		Slot->FactorPercent[SkillNr] = Script.readNumber();
+		Script.readSymbol(',');
+		Slot->NextLevel[SkillNr] = Script.readNumber();
+		Script.readSymbol(',');
+		Slot->Delta[SkillNr] = Script.readNumber();
+		Script.readSymbol(')');
+	}
+
+	// "spells", already primed in the loop condition above
+	Script.readSymbol('=');
+	Script.readSymbol('{');
+	while(true){
+		Script.nextToken();
+		if(Script.Token == SPECIAL){
+			if(Script.getSpecial() == '}'){
 				break;
-			}else if(Special == ','){
+			}else if(Script.getSpecial() == ','){
 				continue;
-			}else if(Special != '('){
-				Script.error("'(' expected");
-			}
-
-			int QuestNr = Script.readNumber();
-			if(QuestNr < 0 || QuestNr >= NARRAY(Slot->QuestValues)){
-				Script.error("illegal quest number");
 			}
-			Script.readSymbol(',');
-			Slot->QuestValues[QuestNr] = Script.readNumber();
-			Script.readSymbol(')');
 		}
 
-		Script.readIdentifier(); // "murders"
-		Script.readSymbol('=');
-		Script.readSymbol('{');
-		while(true){
-			Script.nextToken();
-			if(Script.Token == SPECIAL){
-				if(Script.getSpecial() == '}'){
-					break;
-				}else if(Script.getSpecial() == ','){
-					continue;
-				}
-			}
+		int SpellNr = Script.getNumber();
+		if(SpellNr < 0 || SpellNr >= NARRAY(Slot->SpellList)){
+			Script.error("illegal spell number");
+		}
 
-			for(int i = 1; i < NARRAY(Slot->MurderTimestamps); i += 1){
-				Slot->MurderTimestamps[i - 1] = Slot->MurderTimestamps[i];
-			}
+		Slot->SpellList[SpellNr] = 1;
+	}
 
-			Slot->MurderTimestamps[NARRAY(Slot->MurderTimestamps) - 1] = Script.getNumber();
+	Script.readIdentifier(); // "questvalues"
+	Script.readSymbol('=');
+	Script.readSymbol('{');
+	while(true){
+		char Special = Script.readSpecial();
+		if(Special == '}'){
+			break;
+		}else if(Special == ','){
+			continue;
+		}else if(Special != '('){
+			Script.error("'(' expected");
 		}
 
-		HelpBuffer.Position = 0;
-		Script.readIdentifier(); // "inventory"
-		Script.readSymbol('=');
-		Script.readSymbol('{');
-		while(true){
-			Script.nextToken();
-			if(Script.Token == SPECIAL){
-				if(Script.getSpecial() == '}'){
-					break;
-				}else if(Script.getSpecial() == ','){
-					continue;
-				}
-			}
+		int QuestNr = Script.readNumber();
+		if(QuestNr < 0 || QuestNr >= MAX_QUESTS){
+			Script.error("illegal quest number");
+		}
+		Script.readSymbol(',');
+		Slot->QuestValues.set(QuestNr, Script.readNumber());
+		Script.readSymbol(')');
+	}
 
-			int Position = Script.getNumber();
-			if(Position < INVENTORY_FIRST || Position > INVENTORY_LAST){
-				Script.error("illegal inventory position");
+	Script.readIdentifier(); // "murders"
+	Script.readSymbol('=');
+	Script.readSymbol('{');
+	while(true){
+		Script.nextToken();
+		if(Script.Token == SPECIAL){
+			if(Script.getSpecial() == '}'){
+				break;
+			}else if(Script.getSpecial() == ','){
+				continue;
 			}
+		}
 
-			Script.readIdentifier(); // "content"
-			Script.readSymbol('=');
-			HelpBuffer.writeByte((uint8)Position);
-			LoadObjects(&Script, &HelpBuffer, false);
+		for(int i = 1; i < NARRAY(Slot->MurderTimestamps); i += 1){
+			Slot->MurderTimestamps[i - 1] = Slot->MurderTimestamps[i];
 		}
-		HelpBuffer.writeByte(0xFF);
-		Slot->Inventory = new uint8[HelpBuffer.Position];
-		Slot->InventorySize = HelpBuffer.Position;
-		memcpy(Slot->Inventory, HelpBuffer.Data, HelpBuffer.Position);
 
-		Script.readIdentifier(); // "depots"
-		Script.readSymbol('=');
-		Script.readSymbol('{');
-		while(true){
-			Script.nextToken();
-			if(Script.Token == SPECIAL){
-				if(Script.getSpecial() == '}'){
-					break;
-				}else if(Script.getSpecial() == ','){
-					continue;
-				}
-			}
+		Slot->MurderTimestamps[NARRAY(Slot->MurderTimestamps) - 1] = Script.getNumber();
+	}
 
-			int DepotNr = Script.getNumber();
-			if(DepotNr < 0 || DepotNr >= MAX_DEPOTS){
-				Script.error("illegal depot number");
+	HelpBuffer.Position = 0;
+	Script.readIdentifier(); // "inventory"
+	Script.readSymbol('=');
+	Script.readSymbol('{');
+	while(true){
+		Script.nextToken();
+		if(Script.Token == SPECIAL){
+			if(Script.getSpecial() == '}'){
+				break;
+			}else if(Script.getSpecial() == ','){
+				continue;
 			}
-
-			Script.readIdentifier(); // "content"
-			Script.readSymbol('=');
-			HelpBuffer.Position = 0;
-			LoadObjects(&Script, &HelpBuffer, false);
-			Slot->Depot[DepotNr] = new uint8[HelpBuffer.Position];
-			Slot->DepotSize[DepotNr] = HelpBuffer.Position;
-			memcpy(Slot->Depot[DepotNr], HelpBuffer.Data, HelpBuffer.Position);
 		}
 
-		Script.nextToken();
-		if(Script.Token != ENDOFFILE){
-			Script.error("end of file expected");
+		int Position = Script.getNumber();
+		if(Position < INVENTORY_FIRST || Position > INVENTORY_LAST){
+			Script.error("illegal inventory position");
 		}
 
-		Script.close();
-		Result = true;
-	}catch(const char *str){
-		error("LoadPlayerData: Cannot load items of player %u.\n",
-				Slot->CharacterID);
-		error("# Error: %s\n", str);
-	}catch(const std::bad_alloc &e){
-		error("LoadPlayerData: No memory free while loading player %u.\n",
-				Slot->CharacterID);
+		Script.readIdentifier(); // "content"
+		Script.readSymbol('=');
+		HelpBuffer.writeByte((uint8)Position);
+		LoadObjects(&Script, &HelpBuffer, false);
 	}
+	HelpBuffer.writeByte(0xFF);
+	Slot->Inventory = new uint8[HelpBuffer.Position];
+	Slot->InventorySize = HelpBuffer.Position;
+	memcpy(Slot->Inventory, HelpBuffer.Data, HelpBuffer.Position);
 
-	if(!Result){
-		delete[] Slot->Inventory;
-		Slot->Inventory = NULL;
-		Slot->InventorySize = 0;
-
-		for(int DepotNr = 0; DepotNr < MAX_DEPOTS; DepotNr += 1){
-			delete[] Slot->Depot[DepotNr];
-			Slot->Depot[DepotNr] = NULL;
-			Slot->DepotSize[DepotNr] = 0;
+	Script.readIdentifier(); // "depots"
+	Script.readSymbol('=');
+	Script.readSymbol('{');
+	while(true){
+		Script.nextToken();
+		if(Script.Token == SPECIAL){
+			if(Script.getSpecial() == '}'){
+				break;
+			}else if(Script.getSpecial() == ','){
+				continue;
+			}
 		}
-	}
 
-	return Result;
-}
+		int DepotNr = Script.getNumber();
+		if(DepotNr < 0 || DepotNr >= MAX_DEPOTS){
+			Script.error("illegal depot number");
+		}
 
-void SavePlayerData(TPlayerData *Slot){
-	if(Slot == NULL){
-		error("SavePlayerData: Slot is NULL.\n");
-		return;
+		Script.readIdentifier(); // "content"
+		Script.readSymbol('=');
+		HelpBuffer.Position = 0;
+		LoadObjects(&Script, &HelpBuffer, false);
+		Slot->Depot[DepotNr] = new uint8[HelpBuffer.Position];
+		Slot->DepotSize[DepotNr] = HelpBuffer.Position;
+		memcpy(Slot->Depot[DepotNr], HelpBuffer.Data, HelpBuffer.Position);
 	}
 
-	if(Slot->CharacterID == 0){
-		error("SavePlayerData: Slot contains no character.\n");
-		return;
+	Script.nextToken();
+	if(Script.Token != ENDOFFILE){
+		Script.error("end of file expected");
 	}
 
-	// TODO(fusion): This is prone to problems if we don't backup user files.
-	// Even if we did automatic backups, would only this user get rolled back?
-	// This is probably one of the sources of whole day rollbacks.
-	char FileName[4096];
-	PlayerDataPath(FileName, sizeof(FileName), Slot->CharacterID);
-	try{
-		TWriteScriptFile Script;
-		Script.open(FileName);
+	Script.close();
+}
 
-		Script.writeText("ID              = ");
-		Script.writeNumber(Slot->CharacterID);
-		Script.writeLn();
+static void LoadPlayerDataBinary(TPlayerData *Slot, const char *FileName){
+	// NOTE(fusion): Sections like the quest values can grow well past a few
+	// kilobytes, so the buffer is sized for the largest section in the file.
+	TPlayerDataSection Sections[PLAYERDATA_MAX_SECTIONS];
+	uint8 *Buffer = NULL;
+	int BufferSize = 0;
+	TReadBinaryFile File;
+	File.open(FileName);
+	try{
+		int NumSections = ReadPlayerDataSections(&File,
+				Slot->CharacterID, Sections, NARRAY(Sections));
+		for(int i = 0; i < NumSections; i += 1){
+			TPlayerDataSection *Section = &Sections[i];
+			if(Section->Type == PLAYERDATA_SECTION_DEPOT){
+				if(Section->Number < 0 || Section->Number >= MAX_DEPOTS){
+					File.error("illegal depot number");
+				}
 
-		Script.writeText("Name            = ");
-		Script.writeString(Slot->Name);
-		Script.writeLn();
+				// NOTE(fusion): Depots are only read once they're opened, see
+				// `LoadPlayerDepot`.
+				Slot->DepotPending[Section->Number] = true;
+				continue;
+			}
 
-		Script.writeText("Race            = ");
-		Script.writeNumber(Slot->Race);
-		Script.writeLn();
+			if(Section->Type == PLAYERDATA_SECTION_INVENTORY){
+				Slot->Inventory = new uint8[Section->Size];
+				Slot->InventorySize = Section->Size;
+				ReadPlayerDataSection(&File, Section, Slot->Inventory, Slot->InventorySize);
+				if(Slot->Inventory[Slot->InventorySize - 1] != 0xFF){
+					File.error("inventory not terminated");
+				}
+				continue;
+			}
 
-		Script.writeText("Profession      = ");
-		Script.writeNumber(Slot->Profession);
-		Script.writeLn();
+			if(Section->Size > BufferSize){
+				delete[] Buffer;
+				Buffer = NULL;
+				Buffer = new uint8[Section->Size];
+				BufferSize = Section->Size;
+			}
 
-		Script.writeText("OriginalOutfit  = ");
-		WriteOutfit(&Script, Slot->OriginalOutfit);
-		Script.writeLn();
+			ReadPlayerDataSection(&File, Section, Buffer, BufferSize);
+			TReadBuffer Data(Buffer, Section->Size);
+			switch(Section->Type){
+				case PLAYERDATA_SECTION_GENERAL:{
+					Data.readString(Slot->Name, sizeof(Slot->Name));
+					Slot->Race = (int)Data.readQuad();
+					Slot->Profession = (int)Data.readQuad();
+					ReadBinaryOutfit(&Data, &Slot->OriginalOutfit);
+					ReadBinaryOutfit(&Data, &Slot->CurrentOutfit);
+					Slot->LastLoginTime = (time_t)(int)Data.readQuad();
+					Slot->LastLogoutTime = (time_t)(int)Data.readQuad();
+					Slot->startx = (int)Data.readQuad();
+					Slot->starty = (int)Data.readQuad();
+					Slot->startz = (int)Data.readQuad();
+					Slot->posx = (int)Data.readQuad();
+					Slot->posy = (int)Data.readQuad();
+					Slot->posz = (int)Data.readQuad();
+					Slot->PlayerkillerEnd = (int)Data.readQuad();
+					break;
+				}
 
-		Script.writeText("CurrentOutfit   = ");
-		WriteOutfit(&Script, Slot->CurrentOutfit);
-		Script.writeLn();
+				case PLAYERDATA_SECTION_SKILLS:{
+					int Skills = (int)Data.readWord();
+					for(int j = 0; j < Skills; j += 1){
+						int SkillNr = (int)Data.readWord();
+						if(SkillNr < 0 || SkillNr >= NARRAY(Slot->Minimum)){
+							File.error("illegal skill number");
+						}
+
+						Slot->Actual[SkillNr] = (int)Data.readQuad();
+						Slot->Maximum[SkillNr] = (int)Data.readQuad();
+						Slot->Minimum[SkillNr] = (int)Data.readQuad();
+						Slot->DeltaAct[SkillNr] = (int)Data.readQuad();
+						Slot->MagicDeltaAct[SkillNr] = (int)Data.readQuad();
+						Slot->Cycle[SkillNr] = (int)Data.readQuad();
+						Slot->MaxCycle[SkillNr] = (int)Data.readQuad();
+						Slot->Count[SkillNr] = (int)Data.readQuad();
+						Slot->MaxCount[SkillNr] = (int)Data.readQuad();
+						Slot->AddLevel[SkillNr] = (int)Data.readQuad();
+						Slot->Experience[SkillNr] = (int)Data.readQuad();
+						Slot->FactorPercent[SkillNr] = (int)Data.readQuad();
+						Slot->NextLevel[SkillNr] = (int)Data.readQuad();
+						Slot->Delta[SkillNr] = (int)Data.readQuad();
+					}
+					break;
+				}
+
+				case PLAYERDATA_SECTION_SPELLS:{
+					Data.readBytes(Slot->SpellList, sizeof(Slot->SpellList));
+					break;
+				}
+
+				case PLAYERDATA_SECTION_QUESTS:{
+					int Quests = (int)Data.readWord();
+					for(int j = 0; j < Quests; j += 1){
+						int QuestNr = (int)Data.readWord();
+						if(QuestNr < 0 || QuestNr >= MAX_QUESTS){
+							File.error("illegal quest number");
+						}
+
+						Slot->QuestValues.set(QuestNr, (int)Data.readQuad());
+					}
+					break;
+				}
+
+				case PLAYERDATA_SECTION_MURDERS:{
+					int Murders = (int)Data.readWord();
+					for(int j = 0; j < Murders; j += 1){
+						for(int k = 1; k < NARRAY(Slot->MurderTimestamps); k += 1){
+							Slot->MurderTimestamps[k - 1] = Slot->MurderTimestamps[k];
+						}
+
+						Slot->MurderTimestamps[NARRAY(Slot->MurderTimestamps) - 1] = (int)Data.readQuad();
+					}
+					break;
+				}
+
+				default:{
+					// NOTE(fusion): Unknown sections are skipped so that new
+					// ones can be added without bumping the version.
+					break;
+				}
+			}
+		}
+
+		File.close();
+	}catch(...){
+		delete[] Buffer;
+		if(File.File != NULL){
+			File.close();
+		}
+		throw;
+	}
+
+	delete[] Buffer;
+}
+
+bool LoadPlayerData(TPlayerData *Slot){
+	if(Slot == NULL){
+		error("LoadPlayerData: Slot is NULL.\n");
+		return false;
+	}
+
+	if(Slot->CharacterID == 0){
+		error("LoadPlayerData: Slot contains no character.\n");
+		return false;
+	}
 
-		Script.writeText("LastLogin       = ");
-		Script.writeNumber((int)Slot->LastLoginTime);
+	// IMPORTANT(fusion): This function is only called from `AssignPlayerPoolSlot`
+	// which zero initializes it before hand. Note that it would be a problem
+	// otherwise, since we shouldn't write to `CharacterID`, `Locked`, or `Sticky`
+	// outside a critical section, making `memset` not viable and turning this
+	// into an assignment fiesta for no good reason.
+	Slot->Race = 1;
+	Slot->Profession = PROFESSION_NONE;
+	for(int SkillNr = 0;
+			SkillNr < NARRAY(Slot->Minimum);
+			SkillNr += 1){
+		// NOTE(fusion): See `TPlayer::LoadData`.
+		Slot->Minimum[SkillNr] = INT_MIN;
+	}
+
+	char BinaryFileName[4096];
+	char TextFileName[4096];
+	PlayerDataBinaryPath(BinaryFileName, sizeof(BinaryFileName), Slot->CharacterID);
+	PlayerDataPath(TextFileName, sizeof(TextFileName), Slot->CharacterID);
+	bool Binary = FileExists(BinaryFileName);
+	if(!Binary && !FileExists(TextFileName)){
+		// NOTE(fusion): First login. Use defaults.
+		return true;
+	}
+
+	bool Result = false;
+	try{
+		if(Binary){
+			LoadPlayerDataBinary(Slot, BinaryFileName);
+		}else{
+			LoadPlayerDataText(Slot, TextFileName);
+		}
+		Result = true;
+	}catch(const char *str){
+		error("LoadPlayerData: Cannot load items of player %u.\n",
+				Slot->CharacterID);
+		error("# Error: %s\n", str);
+	}catch(const std::bad_alloc &e){
+		error("LoadPlayerData: No memory free while loading player %u.\n",
+				Slot->CharacterID);
+	}
+
+	if(!Result){
+		Slot->QuestValues.release();
+		delete[] Slot->Inventory;
+		Slot->Inventory = NULL;
+		Slot->InventorySize = 0;
+
+		for(int DepotNr = 0; DepotNr < MAX_DEPOTS; DepotNr += 1){
+			delete[] Slot->Depot[DepotNr];
+			Slot->Depot[DepotNr] = NULL;
+			Slot->DepotSize[DepotNr] = 0;
+			Slot->DepotPending[DepotNr] = false;
+		}
+	}
+
+	return Result;
+}
+
+bool LoadPlayerDepot(TPlayerData *Slot, int DepotNr){
+	if(Slot == NULL){
+		error("LoadPlayerDepot: Slot is NULL.\n");
+		return false;
+	}
+
+	if(DepotNr < 0 || DepotNr >= MAX_DEPOTS){
+		error("LoadPlayerDepot: Invalid depot number %d.\n", DepotNr);
+		return false;
+	}
+
+	if(!Slot->DepotPending[DepotNr]){
+		return true;
+	}
+
+	char FileName[4096];
+	PlayerDataBinaryPath(FileName, sizeof(FileName), Slot->CharacterID);
+
+	uint8 *Depot = NULL;
+	int DepotSize = 0;
+	try{
+		TPlayerDataSection Sections[PLAYERDATA_MAX_SECTIONS];
+		TReadBinaryFile File;
+		File.open(FileName);
+		int NumSections = ReadPlayerDataSections(&File,
+				Slot->CharacterID, Sections, NARRAY(Sections));
+		for(int i = 0; i < NumSections; i += 1){
+			if(Sections[i].Type == PLAYERDATA_SECTION_DEPOT
+					&& Sections[i].Number == DepotNr){
+				Depot = new uint8[Sections[i].Size];
+				DepotSize = Sections[i].Size;
+				ReadPlayerDataSection(&File, &Sections[i], Depot, DepotSize);
+				break;
+			}
+		}
+		File.close();
+	}catch(const char *str){
+		error("LoadPlayerDepot: Cannot load depot %d of player %u.\n",
+				DepotNr, Slot->CharacterID);
+		error("# Error: %s\n", str);
+		delete[] Depot;
+		return false;
+	}
+
+	if(Depot == NULL){
+		error("LoadPlayerDepot: Depot %d of player %u is missing.\n",
+				DepotNr, Slot->CharacterID);
+		return false;
+	}
+
+	Slot->Depot[DepotNr] = Depot;
+	Slot->DepotSize[DepotNr] = DepotSize;
+	Slot->DepotPending[DepotNr] = false;
+	return true;
+}
+
+static void SavePlayerDataText(TPlayerData *Slot, const char *FileName){
+	TWriteScriptFile Script;
+	Script.open(FileName);
+
+	Script.writeText("ID              = ");
+	Script.writeNumber(Slot->CharacterID);
+	Script.writeLn();
+
+	Script.writeText("Name            = ");
+	Script.writeString(Slot->Name);
+	Script.writeLn();
+
+	Script.writeText("Race            = ");
+	Script.writeNumber(Slot->Race);
+	Script.writeLn();
+
+	Script.writeText("Profession      = ");
+	Script.writeNumber(Slot->Profession);
+	Script.writeLn();
+
+	Script.writeText("OriginalOutfit  = ");
+	WriteOutfit(&Script, Slot->OriginalOutfit);
+	Script.writeLn();
+
+	Script.writeText("CurrentOutfit   = ");
+	WriteOutfit(&Script, Slot->CurrentOutfit);
+	Script.writeLn();
+
+	Script.writeText("LastLogin       = ");
+	Script.writeNumber((int)Slot->LastLoginTime);
+	Script.writeLn();
+
+	Script.writeText("LastLogout      = ");
+	Script.writeNumber((int)Slot->LastLogoutTime);
+	Script.writeLn();
+
+	Script.writeText("StartPosition   = ");
+	Script.writeCoordinate(Slot->startx, Slot->starty, Slot->startz);
+	Script.writeLn();
+
+	Script.writeText("CurrentPosition = ");
+	Script.writeCoordinate(Slot->posx, Slot->posy, Slot->posz);
+	Script.writeLn();
+
+	Script.writeText("PlayerkillerEnd = ");
+	Script.writeNumber(Slot->PlayerkillerEnd);
+	Script.writeLn();
+	Script.writeLn();
+
+	for(int SkillNr = 0;
+			SkillNr < NARRAY(Slot->Minimum);
+			SkillNr += 1){
+		if(Slot->Minimum[SkillNr] == INT_MIN){
+			continue;
+		}
+
+		Script.writeText("Skill = (");
+		Script.writeNumber(SkillNr);
+		Script.writeText(",");
+		Script.writeNumber(Slot->Actual[SkillNr]);
+		Script.writeText(",");
+		Script.writeNumber(Slot->Maximum[SkillNr]);
+		Script.writeText(",");
+		Script.writeNumber(Slot->Minimum[SkillNr]);
+		Script.writeText(",");
+		Script.writeNumber(Slot->DeltaAct[SkillNr]);
+		Script.writeText(",");
+		Script.writeNumber(Slot->MagicDeltaAct[SkillNr]);
+		Script.writeText(",");
+		Script.writeNumber(Slot->Cycle[SkillNr]);
+		Script.writeText(",");
+		Script.writeNumber(Slot->MaxCycle[SkillNr]);
+		Script.writeText(",");
+		Script.writeNumber(Slot->Count[SkillNr]);
+		Script.writeText(",");
+		Script.writeNumber(Slot->MaxCount[SkillNr]);
+		Script.writeText(",");
+		Script.writeNumber(Slot->AddLevel[SkillNr]);
+		Script.writeText(",");
+		Script.writeNumber(Slot->Experience[SkillNr]);
+		Script.writeText(",");
+		Script.writeNumber(Slot->FactorPercent[SkillNr]);
+		Script.writeText(",");
+		Script.writeNumber(Slot->NextLevel[SkillNr]);
+		Script.writeText(",");
+		Script.writeNumber(Slot->Delta[SkillNr]);
+		Script.writeText(")");
 		Script.writeLn();
+	}
+	Script.writeLn();
+
+	bool FirstSpell = true;
+	Script.writeText("Spells      = {");
+	for(int SpellNr = 0;
+			SpellNr < NARRAY(Slot->SpellList);
+			SpellNr += 1){
+		if(Slot->SpellList[SpellNr] != 0){
+			if(!FirstSpell){
+				Script.writeText(",");
+			}
+			Script.writeNumber(SpellNr);
+			FirstSpell = false;
+		}
+	}
+	Script.writeText("}");
+	Script.writeLn();
+
+	Script.writeText("QuestValues = {");
+	for(int i = 0; i < Slot->QuestValues.Count; i += 1){
+		TQuestValue *Quest = &Slot->QuestValues.Entry[i];
+		if(i > 0){
+			Script.writeText(",");
+		}
+		Script.writeText("(");
+		Script.writeNumber((int)Quest->QuestNr);
+		Script.writeText(",");
+		Script.writeNumber(Quest->Value);
+		Script.writeText(")");
+	}
+	Script.writeText("}");
+	Script.writeLn();
+
+	bool FirstMurder = true;
+	int Now = (int)time(NULL);
+	Script.writeText("Murders     = {");
+	for(int i = 0; i < NARRAY(Slot->MurderTimestamps); i += 1){
+		// NOTE(fusion): Save murder timestamps for up to a month.
+		if((Now - Slot->MurderTimestamps[i]) < (30 * 24 * 60 * 60)){
+			if(FirstMurder){
+				Script.writeText(",");
+			}
+			Script.writeNumber(Slot->MurderTimestamps[i]);
+			FirstMurder = false;
+		}
+	}
+	Script.writeText("}");
+	Script.writeLn();
+	Script.writeLn();
+
+	bool FirstPosition = true;
+	Script.writeText("Inventory   = {");
+	if(Slot->Inventory != NULL){
+		TReadBuffer Buffer(Slot->Inventory, Slot->InventorySize);
+		while(true){
+			int Position = (int)Buffer.readByte();
+			if(Position == 0xFF){
+				break;
+			}
+
+			if(!FirstPosition){
+				Script.writeText(",");
+				Script.writeLn();
+				Script.writeText("               ");
+			}
+			Script.writeNumber(Position);
+			Script.writeText(" Content=");
+			SaveObjects(&Buffer, &Script);
+			FirstPosition = false;
+		}
+	}
+	Script.writeText("}");
+	Script.writeLn();
+	Script.writeLn();
+
+	bool FirstDepot = true;
+	Script.writeText("Depots      = {");
+	for(int DepotNr = 0; DepotNr < MAX_DEPOTS; DepotNr += 1){
+		if(Slot->Depot[DepotNr] != NULL){
+			TReadBuffer Buffer(Slot->Depot[DepotNr], Slot->DepotSize[DepotNr]);
+			if(!FirstDepot){
+				Script.writeText(",");
+				Script.writeLn();
+				Script.writeText("               ");
+			}
+			Script.writeNumber(DepotNr);
+			Script.writeText(" Content=");
+			SaveObjects(&Buffer, &Script);
+			FirstDepot = false;
+		}
+	}
+	Script.writeText("}");
+	Script.writeLn();
+	Script.close();
+}
+
+static int PlayerDataDirtyFlag(int Type){
+	int Flag = 0;
+	switch(Type){
+		case PLAYERDATA_SECTION_GENERAL:	Flag = PLAYER_DIRTY_GENERAL; break;
+		case PLAYERDATA_SECTION_SKILLS:		Flag = PLAYER_DIRTY_SKILLS; break;
+		case PLAYERDATA_SECTION_SPELLS:		Flag = PLAYER_DIRTY_SPELLS; break;
+		case PLAYERDATA_SECTION_QUESTS:		Flag = PLAYER_DIRTY_QUESTS; break;
+		case PLAYERDATA_SECTION_MURDERS:	Flag = PLAYER_DIRTY_MURDERS; break;
+		case PLAYERDATA_SECTION_INVENTORY:	Flag = PLAYER_DIRTY_INVENTORY; break;
+	}
+	return Flag;
+}
+
+// NOTE(fusion): Appends the payload of a single section to `Body`. Nothing is
+// written for an empty inventory or depot, which then has no section at all.
+static void WritePlayerDataSection(TPlayerData *Slot, int Type, int Number, TWriteBuffer *Body){
+	switch(Type){
+		case PLAYERDATA_SECTION_GENERAL:{
+			Body->writeString(Slot->Name);
+			Body->writeQuad((uint32)Slot->Race);
+			Body->writeQuad((uint32)Slot->Profession);
+			WriteBinaryOutfit(Body, Slot->OriginalOutfit);
+			WriteBinaryOutfit(Body, Slot->CurrentOutfit);
+			Body->writeQuad((uint32)Slot->LastLoginTime);
+			Body->writeQuad((uint32)Slot->LastLogoutTime);
+			Body->writeQuad((uint32)Slot->startx);
+			Body->writeQuad((uint32)Slot->starty);
+			Body->writeQuad((uint32)Slot->startz);
+			Body->writeQuad((uint32)Slot->posx);
+			Body->writeQuad((uint32)Slot->posy);
+			Body->writeQuad((uint32)Slot->posz);
+			Body->writeQuad((uint32)Slot->PlayerkillerEnd);
+			break;
+		}
+
+		case PLAYERDATA_SECTION_SKILLS:{
+			int Skills = 0;
+			for(int SkillNr = 0; SkillNr < NARRAY(Slot->Minimum); SkillNr += 1){
+				if(Slot->Minimum[SkillNr] != INT_MIN){
+					Skills += 1;
+				}
+			}
+
+			Body->writeWord((uint16)Skills);
+			for(int SkillNr = 0; SkillNr < NARRAY(Slot->Minimum); SkillNr += 1){
+				if(Slot->Minimum[SkillNr] == INT_MIN){
+					continue;
+				}
+
+				Body->writeWord((uint16)SkillNr);
+				Body->writeQuad((uint32)Slot->Actual[SkillNr]);
+				Body->writeQuad((uint32)Slot->Maximum[SkillNr]);
+				Body->writeQuad((uint32)Slot->Minimum[SkillNr]);
+				Body->writeQuad((uint32)Slot->DeltaAct[SkillNr]);
+				Body->writeQuad((uint32)Slot->MagicDeltaAct[SkillNr]);
+				Body->writeQuad((uint32)Slot->Cycle[SkillNr]);
+				Body->writeQuad((uint32)Slot->MaxCycle[SkillNr]);
+				Body->writeQuad((uint32)Slot->Count[SkillNr]);
+				Body->writeQuad((uint32)Slot->MaxCount[SkillNr]);
+				Body->writeQuad((uint32)Slot->AddLevel[SkillNr]);
+				Body->writeQuad((uint32)Slot->Experience[SkillNr]);
+				Body->writeQuad((uint32)Slot->FactorPercent[SkillNr]);
+				Body->writeQuad((uint32)Slot->NextLevel[SkillNr]);
+				Body->writeQuad((uint32)Slot->Delta[SkillNr]);
+			}
+			break;
+		}
+
+		case PLAYERDATA_SECTION_SPELLS:{
+			Body->writeBytes(Slot->SpellList, sizeof(Slot->SpellList));
+			break;
+		}
+
+		case PLAYERDATA_SECTION_QUESTS:{
+			Body->writeWord((uint16)Slot->QuestValues.Count);
+			for(int i = 0; i < Slot->QuestValues.Count; i += 1){
+				TQuestValue *Quest = &Slot->QuestValues.Entry[i];
+				Body->writeWord(Quest->QuestNr);
+				Body->writeQuad((uint32)Quest->Value);
+			}
+			break;
+		}
+
+		case PLAYERDATA_SECTION_MURDERS:{
+			// NOTE(fusion): Save murder timestamps for up to a month, same as
+			// the text format.
+			int Now = (int)time(NULL);
+			int Murders = 0;
+			for(int i = 0; i < NARRAY(Slot->MurderTimestamps); i += 1){
+				if((Now - Slot->MurderTimestamps[i]) < (30 * 24 * 60 * 60)){
+					Murders += 1;
+				}
+			}
+
+			Body->writeWord((uint16)Murders);
+			for(int i = 0; i < NARRAY(Slot->MurderTimestamps); i += 1){
+				if((Now - Slot->MurderTimestamps[i]) < (30 * 24 * 60 * 60)){
+					Body->writeQuad((uint32)Slot->MurderTimestamps[i]);
+				}
+			}
+			break;
+		}
+
+		case PLAYERDATA_SECTION_INVENTORY:{
+			if(Slot->Inventory != NULL && Slot->InventorySize > 0){
+				Body->writeBytes(Slot->Inventory, Slot->InventorySize);
+			}
+			break;
+		}
+
+		case PLAYERDATA_SECTION_DEPOT:{
+			if(Slot->Depot[Number] != NULL && Slot->DepotSize[Number] > 0){
+				Body->writeBytes(Slot->Depot[Number], Slot->DepotSize[Number]);
+			}
+			break;
+		}
+	}
+}
+
+static void AddPlayerDataSection(TDynamicWriteBuffer *Body, int Start,
+		int Type, int Number, TPlayerDataSection *Sections, int *NumSections){
+	int Size = Body->Position - Start;
+	if(Size <= 0){
+		return;
+	}
+
+	if(*NumSections >= PLAYERDATA_MAX_SECTIONS){
+		throw "too many sections";
+	}
+
+	TPlayerDataSection *Section = &Sections[*NumSections];
+	Section->Type = Type;
+	Section->Number = Number;
+	Section->Offset = Start;
+	Section->Size = Size;
+	Section->Checksum = PlayerDataChecksum(&Body->Data[Start], Size);
+	*NumSections += 1;
+}
+
+static void WritePlayerDataHeader(uint8 *Header, uint32 CharacterID,
+		const TPlayerDataSection *Sections, int NumSections, int TableOffset, uint8 *Table){
+	int TableSize = NumSections * PLAYERDATA_ENTRY_SIZE;
+	TWriteBuffer TableBuffer(Table, TableSize);
+	for(int i = 0; i < NumSections; i += 1){
+		TableBuffer.writeWord((uint16)Sections[i].Type);
+		TableBuffer.writeWord((uint16)Sections[i].Number);
+		TableBuffer.writeQuad((uint32)Sections[i].Offset);
+		TableBuffer.writeQuad((uint32)Sections[i].Size);
+		TableBuffer.writeQuad(Sections[i].Checksum);
+	}
+
+	TWriteBuffer HeaderBuffer(Header, PLAYERDATA_HEADER_SIZE);
+	HeaderBuffer.writeQuad(PLAYERDATA_MAGIC);
+	HeaderBuffer.writeWord(PLAYERDATA_VERSION);
+	HeaderBuffer.writeWord((uint16)NumSections);
+	HeaderBuffer.writeQuad(CharacterID);
+	HeaderBuffer.writeQuad(PlayerDataChecksum(Table, TableSize));
+	HeaderBuffer.writeQuad((uint32)TableOffset);
+	HeaderBuffer.writeQuad(PlayerDataChecksum(Header, HeaderBuffer.Position));
+}
+
+// NOTE(fusion): Copies a section that couldn't be loaded from the old file as
+// it is, along with its old checksum, so whatever is wrong with it doesn't get
+// any worse and everything else can still be saved.
+static void CopyPlayerDataSection(const char *OldFileName, uint32 CharacterID,
+		int Type, int Number, TDynamicWriteBuffer *Body,
+		TPlayerDataSection *Sections, int *NumSections){
+	if(OldFileName == NULL){
+		throw "no file to copy section from";
+	}
+
+	if(*NumSections >= PLAYERDATA_MAX_SECTIONS){
+		throw "too many sections";
+	}
+
+	TPlayerDataSection Old[PLAYERDATA_MAX_SECTIONS];
+	TReadBinaryFile File;
+	File.open(OldFileName);
+	int OldSections = ReadPlayerDataSections(&File, CharacterID, Old, NARRAY(Old));
+	TPlayerDataSection *Section = NULL;
+	for(int i = 0; i < OldSections; i += 1){
+		if(Old[i].Type == Type && Old[i].Number == Number){
+			Section = &Old[i];
+			break;
+		}
+	}
+
+	if(Section == NULL){
+		File.close();
+		throw "section to copy is missing";
+	}
+
+	uint8 *Data = new uint8[Section->Size];
+	try{
+		File.seek(Section->Offset);
+		File.readBytes(Data, Section->Size);
+	}catch(const char *str){
+		delete[] Data;
+		throw;
+	}
+	File.close();
+
+	int Start = Body->Position;
+	Body->writeBytes(Data, Section->Size);
+	delete[] Data;
+
+	Sections[*NumSections] = *Section;
+	Sections[*NumSections].Offset = Start;
+	*NumSections += 1;
+}
+
+static int SavePlayerDataBinary(TPlayerData *Slot, const char *FileName,
+		const char *OldFileName){
+	TPlayerDataSection Sections[PLAYERDATA_MAX_SECTIONS];
+	int NumSections = 0;
+	TDynamicWriteBuffer Body(KB(16));
+	for(int Type = PLAYERDATA_SECTION_GENERAL;
+			Type <= PLAYERDATA_SECTION_INVENTORY;
+			Type += 1){
+		int Start = Body.Position;
+		WritePlayerDataSection(Slot, Type, 0, &Body);
+		AddPlayerDataSection(&Body, Start, Type, 0, Sections, &NumSections);
+	}
+
+	for(int DepotNr = 0; DepotNr < MAX_DEPOTS; DepotNr += 1){
+		if(Slot->DepotPending[DepotNr]){
+			CopyPlayerDataSection(OldFileName, Slot->CharacterID,
+					PLAYERDATA_SECTION_DEPOT, DepotNr, &Body, Sections, &NumSections);
+			continue;
+		}
+
+		int Start = Body.Position;
+		WritePlayerDataSection(Slot, PLAYERDATA_SECTION_DEPOT, DepotNr, &Body);
+		AddPlayerDataSection(&Body, Start, PLAYERDATA_SECTION_DEPOT, DepotNr, Sections, &NumSections);
+	}
+
+	int TableSize = NumSections * PLAYERDATA_ENTRY_SIZE;
+	int DataStart = PLAYERDATA_HEADER_SIZE + TableSize;
+	for(int i = 0; i < NumSections; i += 1){
+		Sections[i].Offset += DataStart;
+	}
+
+	uint8 Header[PLAYERDATA_HEADER_SIZE];
+	uint8 Table[PLAYERDATA_MAX_SECTIONS * PLAYERDATA_ENTRY_SIZE];
+	WritePlayerDataHeader(Header, Slot->CharacterID,
+			Sections, NumSections, PLAYERDATA_HEADER_SIZE, Table);
+
+	TWriteBinaryFile File;
+	File.open(FileName);
+	File.writeBytes(Header, PLAYERDATA_HEADER_SIZE);
+	File.writeBytes(Table, TableSize);
+	File.writeBytes(Body.Data, Body.Position);
+	File.close();
+	return DataStart + Body.Position;
+}
+
+#if ENABLE_ASSERTIONS
+// NOTE(fusion): Load a file that was just written into a scratch slot and check
+// that its quest values come back unchanged. They're the one section that can
+// grow with the number of quests, so they're the first to outgrow any limit on
+// the loading side.
+static void CheckPlayerDataQuests(TPlayerData *Slot, const char *FileName){
+	TPlayerData *Check = (TPlayerData*)calloc(1, sizeof(TPlayerData));
+	ASSERT(Check != NULL);
+	Check->CharacterID = Slot->CharacterID;
+
+	bool Loaded = true;
+	try{
+		LoadPlayerDataBinary(Check, FileName);
+	}catch(const char *str){
+		error("CheckPlayerDataQuests: Cannot load %s.\n", FileName);
+		error("# Error: %s\n", str);
+		Loaded = false;
+	}
+
+	ASSERT(Loaded);
+	ASSERT(Check->QuestValues.Count == Slot->QuestValues.Count);
+	for(int i = 0; i < Slot->QuestValues.Count; i += 1){
+		TQuestValue *Entry = &Slot->QuestValues.Entry[i];
+		ASSERT(Check->QuestValues.get(Entry->QuestNr) == Entry->Value);
+	}
+
+	Check->QuestValues.release();
+	delete[] Check->Inventory;
+	free(Check);
+}
+
+// NOTE(fusion): Same as above but with a synthetic character carrying far more
+// quest values than fit in a single kilobyte sized buffer.
+static void CheckPlayerDataQuestLimit(void){
+	char FileName[4096];
+	snprintf(FileName, sizeof(FileName), "%s/questcheck.tmp", SAVEPATH);
+
+	TPlayerData *Slot = (TPlayerData*)calloc(1, sizeof(TPlayerData));
+	ASSERT(Slot != NULL);
+	Slot->CharacterID = 0xFFFFFFFF;
+	strcpy(Slot->Name, "Quest Check");
+	for(int QuestNr = 0; QuestNr < MAX_QUESTS; QuestNr += 13){
+		Slot->QuestValues.set(QuestNr, QuestNr + 1);
+	}
+
+	try{
+		SavePlayerDataBinary(Slot, FileName, NULL);
+		CheckPlayerDataQuests(Slot, FileName);
+	}catch(const char *str){
+		error("CheckPlayerDataQuestLimit: Cannot write %s.\n", FileName);
+		error("# Error: %s\n", str);
+	}
+
+	unlink(FileName);
+	Slot->QuestValues.release();
+	free(Slot);
+}
+#endif
+
+static bool PlayerDataSectionEqual(TReadBinaryFile *File,
+		const TPlayerDataSection *Section, const uint8 *Data, int Size){
+	if(Section->Size != Size || Section->Checksum != PlayerDataChecksum(Data, Size)){
+		return false;
+	}
+
+	uint8 *Old = new uint8[Size];
+	try{
+		File->seek(Section->Offset);
+		File->readBytes(Old, Size);
+	}catch(const char *str){
+		delete[] Old;
+		throw;
+	}
+
+	bool Result = (memcmp(Old, Data, Size) == 0);
+	delete[] Old;
+	return Result;
+}
+
+// NOTE(fusion): Sections that changed are appended to the end of the existing
+// file, followed by a new section table, and only then is the header pointed
+// at that table. Up until the header is rewritten, the file still describes
+// its previous state in full, making it a simple journal. Dirty sections whose
+// content turns out to be the same as on disk are left alone. Returns the
+// number of bytes written or -1 if the file should be rewritten as a whole,
+// either because it has too many stale sections or there is no room left in
+// the section table.
+static int AppendPlayerDataBinary(TPlayerData *Slot, const char *FileName,
+		int DirtySections, int DirtyDepots){
+	TPlayerDataSection Sections[PLAYERDATA_MAX_SECTIONS];
+	int NumSections = 0;
+	int FileSize = 0;
+	bool Changed = false;
+	TDynamicWriteBuffer Body(KB(16));
+
+	TReadBinaryFile File;
+	File.open(FileName);
+	NumSections = ReadPlayerDataSections(&File, Slot->CharacterID,
+			Sections, PLAYERDATA_MAX_SECTIONS);
+	FileSize = File.getSize();
+	int OldSections = NumSections;
+	for(int Type = PLAYERDATA_SECTION_GENERAL;
+			Type <= PLAYERDATA_SECTION_DEPOT;
+			Type += 1){
+		int Count = (Type == PLAYERDATA_SECTION_DEPOT ? MAX_DEPOTS : 1);
+		for(int Number = 0; Number < Count; Number += 1){
+			if(Type == PLAYERDATA_SECTION_DEPOT){
+				if((DirtyDepots & (1 << Number)) == 0 || Slot->DepotPending[Number]){
+					continue;
+				}
+			}else if((DirtySections & PlayerDataDirtyFlag(Type)) == 0){
+				continue;
+			}
+
+			TPlayerDataSection *Old = NULL;
+			for(int i = 0; i < OldSections; i += 1){
+				if(Sections[i].Type == Type && Sections[i].Number == Number){
+					Old = &Sections[i];
+					break;
+				}
+			}
+
+			int Start = Body.Position;
+			WritePlayerDataSection(Slot, Type, Number, &Body);
+			int Size = Body.Position - Start;
+			if(Old == NULL && Size == 0){
+				continue;
+			}
+
+			if(Old != NULL && Size > 0 && PlayerDataSectionEqual(&File, Old, &Body.Data[Start], Size)){
+				Body.Position = Start;
+				continue;
+			}
+
+			if(Old != NULL){
+				Old->Type = 0;
+			}
+
+			AddPlayerDataSection(&Body, Start, Type, Number, Sections, &NumSections);
+			Changed = true;
+		}
+	}
+	File.close();
+
+	if(!Changed){
+		return 0;
+	}
+
+	int LiveSize = 0;
+	int NewSections = 0;
+	for(int i = 0; i < NumSections; i += 1){
+		if(Sections[i].Type == 0){
+			continue;
+		}
+
+		if(i >= OldSections){
+			Sections[i].Offset += FileSize;
+		}
+
+		LiveSize += Sections[i].Size;
+		Sections[NewSections] = Sections[i];
+		NewSections += 1;
+	}
+	NumSections = NewSections;
+
+	int TableOffset = FileSize + Body.Position;
+	int TableSize = NumSections * PLAYERDATA_ENTRY_SIZE;
+	if(NumSections > PLAYERDATA_MAX_SECTIONS
+			|| (TableOffset + TableSize) > (LiveSize * 2 + PLAYERDATA_COMPACT_SLACK)){
+		return -1;
+	}
+
+	uint8 Header[PLAYERDATA_HEADER_SIZE];
+	uint8 Table[PLAYERDATA_MAX_SECTIONS * PLAYERDATA_ENTRY_SIZE];
+	WritePlayerDataHeader(Header, Slot->CharacterID,
+			Sections, NumSections, TableOffset, Table);
+
+	FILE *Out = fopen(FileName, "r+b");
+	if(Out == NULL){
+		throw "cannot open player file for update";
+	}
+
+	bool Result = fseek(Out, FileSize, SEEK_SET) == 0
+			&& (int)fwrite(Body.Data, 1, Body.Position, Out) == Body.Position
+			&& (int)fwrite(Table, 1, TableSize, Out) == TableSize
+			&& fflush(Out) == 0
+			&& fdatasync(fileno(Out)) == 0
+			&& fseek(Out, 0, SEEK_SET) == 0
+			&& (int)fwrite(Header, 1, PLAYERDATA_HEADER_SIZE, Out) == PLAYERDATA_HEADER_SIZE;
+	if(fclose(Out) != 0){
+		Result = false;
+	}
+
+	if(!Result){
+		throw "cannot append to player file";
+	}
+
+	return Body.Position + TableSize + PLAYERDATA_HEADER_SIZE;
+}
+
+bool SavePlayerData(TPlayerData *Slot){
+	if(Slot == NULL){
+		error("SavePlayerData: Slot is NULL.\n");
+		return false;
+	}
+
+	if(Slot->CharacterID == 0){
+		error("SavePlayerData: Slot contains no character.\n");
+		return false;
+	}
+
+	// NOTE(fusion): Whoever marked the slot as dirty without saying what has
+	// changed gets everything saved.
+	int DirtySections = Slot->DirtySections;
+	int DirtyDepots = Slot->DirtyDepots;
+	if(DirtySections == 0 && DirtyDepots == 0){
+		DirtySections = PLAYER_DIRTY_ALL;
+		DirtyDepots = (1 << MAX_DEPOTS) - 1;
+	}
+
+	char BinaryFileName[4096];
+	char TextFileName[4096];
+	PlayerDataBinaryPath(BinaryFileName, sizeof(BinaryFileName), Slot->CharacterID);
+	PlayerDataPath(TextFileName, sizeof(TextFileName), Slot->CharacterID);
+	if(BinaryPlayerData && FileExists(BinaryFileName)){
+		int Written = -1;
+		try{
+			Written = AppendPlayerDataBinary(Slot, BinaryFileName, DirtySections, DirtyDepots);
+		}catch(const char *str){
+			error("SavePlayerData: Cannot update file of player %u; rewriting it.\n",
+					Slot->CharacterID);
+			error("# Error: %s\n", str);
+		}
+
+		if(Written >= 0){
+#if ENABLE_ASSERTIONS
+			CheckPlayerDataQuests(Slot, BinaryFileName);
+#endif
+			unlink(TextFileName);
+			RecordPlayerDataSave(Written, (Written > 0), false);
+			Slot->DirtySections = 0;
+			Slot->DirtyDepots = 0;
+			return true;
+		}
+	}
+
+	// NOTE(fusion): Depots that were never opened only exist in the current
+	// file so they need to be read before it's replaced. Those that can't be
+	// read are carried over to the new binary file as they are, so the rest of
+	// the character is still saved. The text format has no way to do that so
+	// the old file is kept instead.
+	bool DepotsLoaded = true;
+	for(int DepotNr = 0; DepotNr < MAX_DEPOTS; DepotNr += 1){
+		if(!LoadPlayerDepot(Slot, DepotNr)){
+			DepotsLoaded = false;
+		}
+	}
+
+	bool Result = false;
+	if(BinaryPlayerData){
+		if(!DepotsLoaded){
+			error("SavePlayerData: Copying unreadable depots of player %u unchanged.\n",
+					Slot->CharacterID);
+		}
+
+		// NOTE(fusion): Write to a temporary file first so a failed save
+		// doesn't leave a truncated file behind.
+		char TempFileName[4096];
+		snprintf(TempFileName, sizeof(TempFileName), "%s.tmp", BinaryFileName);
+		try{
+			int Written = SavePlayerDataBinary(Slot, TempFileName, BinaryFileName);
+#if ENABLE_ASSERTIONS
+			CheckPlayerDataQuests(Slot, TempFileName);
+#endif
+			if(rename(TempFileName, BinaryFileName) != 0){
+				int ErrCode = errno;
+				error("SavePlayerData: Error %d while renaming %s.\n", ErrCode, TempFileName);
+				error("# Error %d: %s.\n", ErrCode, strerror(ErrCode));
+				unlink(TempFileName);
+				return false;
+			}
+			unlink(TextFileName);
+			RecordPlayerDataSave(Written, true, true);
+			Slot->DirtySections = 0;
+			Slot->DirtyDepots = 0;
+			Result = true;
+		}catch(const char *str){
+			error("SavePlayerData: Cannot write items of player %u.\n", Slot->CharacterID);
+			error("# Error: %s\n", str);
+			unlink(TempFileName);
+		}
+	}else if(!DepotsLoaded){
+		error("SavePlayerData: Keeping old data of player %u.\n", Slot->CharacterID);
+	}else{
+		// TODO(fusion): This is prone to problems if we don't backup user files.
+		// Even if we did automatic backups, would only this user get rolled back?
+		// This is probably one of the sources of whole day rollbacks.
+		try{
+			SavePlayerDataText(Slot, TextFileName);
+			unlink(BinaryFileName);
 
-		Script.writeText("LastLogout      = ");
-		Script.writeNumber((int)Slot->LastLogoutTime);
-		Script.writeLn();
+			struct stat FileInfo;
+			int Written = 0;
+			if(stat(TextFileName, &FileInfo) == 0){
+				Written = (int)FileInfo.st_size;
+			}
+			RecordPlayerDataSave(Written, true, true);
+			Slot->DirtySections = 0;
+			Slot->DirtyDepots = 0;
+			Result = true;
+		}catch(const char *str){
+			error("SavePlayerData: Cannot write items of player %u.\n", Slot->CharacterID);
+			error("# Error: %s\n", str);
+			unlink(TextFileName);
+		}
+	}
 
-		Script.writeText("StartPosition   = ");
-		Script.writeCoordinate(Slot->startx, Slot->starty, Slot->startz);
-		Script.writeLn();
+	return Result;
+}
 
-		Script.writeText("CurrentPosition = ");
-		Script.writeCoordinate(Slot->posx, Slot->posy, Slot->posz);
-		Script.writeLn();
+void UnlinkPlayerData(uint32 CharacterID){
+	char FileName[4096];
+	PlayerDataPath(FileName, sizeof(FileName), CharacterID);
+	unlink(FileName);
+	PlayerDataBinaryPath(FileName, sizeof(FileName), CharacterID);
+	unlink(FileName);
+}
 
-		Script.writeText("PlayerkillerEnd = ");
-		Script.writeNumber(Slot->PlayerkillerEnd);
-		Script.writeLn();
-		Script.writeLn();
+void ConvertPlayerData(bool Binary){
+	// NOTE(fusion): Files are converted by loading and saving them with the
+	// target format selected, which also removes the source file. Character
+	// IDs are gathered before so the directory isn't modified while it's read.
+	const char *SourceExt = (Binary ? ".usr" : ".usb");
+	BinaryPlayerData = Binary;
+
+	int Converted = 0;
+	int Failed = 0;
+	int Quests = 0;
+	int MaxQuestNr = 0;
+	TPlayerData *Slot = (TPlayerData*)calloc(1, sizeof(TPlayerData));
+	vector<uint32> CharacterIDs(0, 1000, 1000);
+	for(int DirNr = 0; DirNr < 100; DirNr += 1){
+		char DirName[4096];
+		snprintf(DirName, sizeof(DirName), "%s/%02d", USERPATH, DirNr);
+		DIR *UserDir = opendir(DirName);
+		if(UserDir == NULL){
+			continue;
+		}
 
-		for(int SkillNr = 0;
-				SkillNr < NARRAY(Slot->Minimum);
-				SkillNr += 1){
-			if(Slot->Minimum[SkillNr] == INT_MIN){
+		int NumCharacterIDs = 0;
+		while(dirent *DirEntry = readdir(UserDir)){
+			if(DirEntry->d_type != DT_REG){
 				continue;
 			}
 
-			Script.writeText("Skill = (");
-			Script.writeNumber(SkillNr);
-			Script.writeText(",");
-			Script.writeNumber(Slot->Actual[SkillNr]);
-			Script.writeText(",");
-			Script.writeNumber(Slot->Maximum[SkillNr]);
-			Script.writeText(",");
-			Script.writeNumber(Slot->Minimum[SkillNr]);
-			Script.writeText(",");
-			Script.writeNumber(Slot->DeltaAct[SkillNr]);
-			Script.writeText(",");
-			Script.writeNumber(Slot->MagicDeltaAct[SkillNr]);
-			Script.writeText(",");
-			Script.writeNumber(Slot->Cycle[SkillNr]);
-			Script.writeText(",");
-			Script.writeNumber(Slot->MaxCycle[SkillNr]);
-			Script.writeText(",");
-			Script.writeNumber(Slot->Count[SkillNr]);
-			Script.writeText(",");
-			Script.writeNumber(Slot->MaxCount[SkillNr]);
-			Script.writeText(",");
-			Script.writeNumber(Slot->AddLevel[SkillNr]);
-			Script.writeText(",");
-			Script.writeNumber(Slot->Experience[SkillNr]);
-			Script.writeText(",");
-			Script.writeNumber(Slot->FactorPercent[SkillNr]);
-			Script.writeText(",");
-			Script.writeNumber(Slot->NextLevel[SkillNr]);
-			Script.writeText(",");
-			Script.writeNumber(Slot->Delta[SkillNr]);
-			Script.writeText(")");
-			Script.writeLn();
-		}
-		Script.writeLn();
+			const char *FileExt = findLast(DirEntry->d_name, '.');
+			if(FileExt == NULL || strcmp(FileExt, SourceExt) != 0){
+				continue;
+			}
 
-		bool FirstSpell = true;
-		Script.writeText("Spells      = {");
-		for(int SpellNr = 0;
-				SpellNr < NARRAY(Slot->SpellList);
-				SpellNr += 1){
-			if(Slot->SpellList[SpellNr] != 0){
-				if(!FirstSpell){
-					Script.writeText(",");
-				}
-				Script.writeNumber(SpellNr);
-				FirstSpell = false;
+			uint32 CharacterID = (uint32)strtoul(DirEntry->d_name, NULL, 10);
+			if(CharacterID != 0){
+				*CharacterIDs.at(NumCharacterIDs) = CharacterID;
+				NumCharacterIDs += 1;
 			}
 		}
-		Script.writeText("}");
-		Script.writeLn();
-
-		bool FirstQuest = true;
-		Script.writeText("QuestValues = {");
-		for(int QuestNr = 0;
-				QuestNr < NARRAY(Slot->QuestValues);
-				QuestNr += 1){
-			if(Slot->QuestValues[QuestNr] != 0){
-				if(!FirstQuest){
-					Script.writeText(",");
+		closedir(UserDir);
+
+		for(int i = 0; i < NumCharacterIDs; i += 1){
+			memset(Slot, 0, sizeof(TPlayerData));
+			Slot->CharacterID = *CharacterIDs.at(i);
+			if(LoadPlayerData(Slot) && SavePlayerData(Slot)){
+				Converted += 1;
+				Quests += Slot->QuestValues.Count;
+				if(Slot->QuestValues.Count > 0){
+					int QuestNr = (int)Slot->QuestValues.Entry[Slot->QuestValues.Count - 1].QuestNr;
+					MaxQuestNr = std::max<int>(MaxQuestNr, QuestNr);
 				}
-				Script.writeText("(");
-				Script.writeNumber(QuestNr);
-				Script.writeText(",");
-				Script.writeNumber(Slot->QuestValues[QuestNr]);
-				Script.writeText(")");
-				FirstQuest = false;
+			}else{
+				Failed += 1;
 			}
-		}
-		Script.writeText("}");
-		Script.writeLn();
 
-		bool FirstMurder = true;
-		int Now = (int)time(NULL);
-		Script.writeText("Murders     = {");
-		for(int i = 0; i < NARRAY(Slot->MurderTimestamps); i += 1){
-			// NOTE(fusion): Save murder timestamps for up to a month.
-			if((Now - Slot->MurderTimestamps[i]) < (30 * 24 * 60 * 60)){
-				if(FirstMurder){
-					Script.writeText(",");
-				}
-				Script.writeNumber(Slot->MurderTimestamps[i]);
-				FirstMurder = false;
+			Slot->QuestValues.release();
+			delete[] Slot->Inventory;
+			for(int DepotNr = 0; DepotNr < MAX_DEPOTS; DepotNr += 1){
+				delete[] Slot->Depot[DepotNr];
 			}
 		}
-		Script.writeText("}");
-		Script.writeLn();
-		Script.writeLn();
+	}
 
-		bool FirstPosition = true;
-		Script.writeText("Inventory   = {");
-		if(Slot->Inventory != NULL){
-			TReadBuffer Buffer(Slot->Inventory, Slot->InventorySize);
-			while(true){
-				int Position = (int)Buffer.readByte();
-				if(Position == 0xFF){
-					break;
-				}
+	free(Slot);
+	print(1, "Converted %d player files to %s format (%d failed).\n",
+			Converted, (Binary ? "binary" : "text"), Failed);
 
-				if(!FirstPosition){
-					Script.writeText(",");
-					Script.writeLn();
-					Script.writeText("               ");
-				}
-				Script.writeNumber(Position);
-				Script.writeText(" Content=");
-				SaveObjects(&Buffer, &Script);
-				FirstPosition = false;
-			}
-		}
-		Script.writeText("}");
-		Script.writeLn();
-		Script.writeLn();
+	// NOTE(fusion): Quest values used to be a dense array of 500 values in
+	// every slot. Report what they actually take for these player files.
+	int SparseBytes = (int)sizeof(TQuestValues)
+			+ (Quests / std::max<int>(Converted, 1)) * (int)sizeof(TQuestValue);
+	print(1, "Quest values: %d over %d players, highest quest %d,"
+			" %d bytes per slot (%d as dense array), slot size %d bytes (%d before).\n",
+			Quests, Converted, MaxQuestNr, SparseBytes, QUESTVALUES_DENSE_SIZE,
+			(int)sizeof(TPlayerData),
+			(int)sizeof(TPlayerData) - (int)sizeof(TQuestValues) + QUESTVALUES_DENSE_SIZE);
+}
 
-		bool FirstDepot = true;
-		Script.writeText("Depots      = {");
-		for(int DepotNr = 0; DepotNr < MAX_DEPOTS; DepotNr += 1){
-			if(Slot->Depot[DepotNr] != NULL){
-				TReadBuffer Buffer(Slot->Depot[DepotNr], Slot->DepotSize[DepotNr]);
-				if(!FirstDepot){
-					Script.writeText(",");
-					Script.writeLn();
-					Script.writeText("               ");
-				}
-				Script.writeNumber(DepotNr);
-				Script.writeText(" Content=");
-				SaveObjects(&Buffer, &Script);
-				FirstDepot = false;
-			}
+// Player Pool
+// =============================================================================
+static uint32 PlayerPoolIndexHome(uint32 CharacterID){
+	// NOTE(fusion): Same as `CreatureTableHome`.
+	return (CharacterID * 2654435761U) >> PlayerDataPoolIndexShift;
+}
+
+static void InsertPlayerPoolIndex(TPlayerData *Slot){
+	uint32 Mask = (uint32)PlayerDataPoolIndexSize - 1;
+	uint32 Index = PlayerPoolIndexHome(Slot->CharacterID);
+	while(PlayerDataPoolIndex[Index] != 0){
+		Index = (Index + 1) & Mask;
+	}
+	PlayerDataPoolIndex[Index] = (int)(Slot - PlayerDataPool) + 1;
+}
+
+static void RemovePlayerPoolIndex(TPlayerData *Slot){
+	uint32 Mask = (uint32)PlayerDataPoolIndexSize - 1;
+	uint32 Index = PlayerPoolIndexHome(Slot->CharacterID);
+	int Entry = (int)(Slot - PlayerDataPool) + 1;
+	while(PlayerDataPoolIndex[Index] != Entry){
+		if(PlayerDataPoolIndex[Index] == 0){
+			error("RemovePlayerPoolIndex: Slot of character %u not found.\n",
+					Slot->CharacterID);
+			return;
 		}
-		Script.writeText("}");
-		Script.writeLn();
-		Script.close();
+		Index = (Index + 1) & Mask;
+	}
 
-	}catch(const char *str){
-		error("SavePlayerData: Cannot write items of player %u.\n", Slot->CharacterID);
-		error("# Error: %s\n", str);
-		unlink(FileName);
+	// NOTE(fusion): Backward shift deletion, same as `RemoveCreatureTable`.
+	uint32 Hole = Index;
+	Index = (Index + 1) & Mask;
+	while(PlayerDataPoolIndex[Index] != 0){
+		TPlayerData *Other = &PlayerDataPool[PlayerDataPoolIndex[Index] - 1];
+		uint32 Home = PlayerPoolIndexHome(Other->CharacterID);
+		if(((Index - Home) & Mask) >= ((Index - Hole) & Mask)){
+			PlayerDataPoolIndex[Hole] = PlayerDataPoolIndex[Index];
+			Hole = Index;
+		}
+		Index = (Index + 1) & Mask;
 	}
+	PlayerDataPoolIndex[Hole] = 0;
 }
 
-void UnlinkPlayerData(uint32 CharacterID){
-	char FileName[4096];
-	PlayerDataPath(FileName, sizeof(FileName), CharacterID);
-	unlink(FileName);
+static void PushPlayerPoolFree(TPlayerData *Slot){
+	ASSERT(PlayerDataPoolFreeSlots < PlayerDataPoolSlots);
+	PlayerDataPoolFree[PlayerDataPoolFreeSlots] = (int)(Slot - PlayerDataPool);
+	PlayerDataPoolFreeSlots += 1;
+}
+
+static TPlayerData *PopPlayerPoolFree(void){
+	if(PlayerDataPoolFreeSlots == 0){
+		return NULL;
+	}
+
+	PlayerDataPoolFreeSlots -= 1;
+	return &PlayerDataPool[PlayerDataPoolFree[PlayerDataPoolFreeSlots]];
 }
 
-// Player Pool
-// =============================================================================
 void SavePlayerPoolSlot(TPlayerData *Slot){
 	if(Slot == NULL){
 		error("SavePlayerPoolSlot: Slot does not exist.\n");
@@ -2667,12 +3949,15 @@ void FreePlayerPoolSlot(TPlayerData *Slot){
 		Slot->Dirty = false;
 	}
 
+	Slot->QuestValues.release();
 	delete[] Slot->Inventory;
 	for(int DepotNr = 0; DepotNr < MAX_DEPOTS; DepotNr += 1){
 		delete[] Slot->Depot[DepotNr];
 	}
 
+	RemovePlayerPoolIndex(Slot);
 	Slot->CharacterID = 0;
+	PushPlayerPoolFree(Slot);
 }
 
 TPlayerData *GetPlayerPoolSlot(uint32 CharacterID){
@@ -2681,14 +3966,16 @@ TPlayerData *GetPlayerPoolSlot(uint32 CharacterID){
 		return NULL;
 	}
 
-	TPlayerData *Slot = NULL;
-	for(int i = 0; i < NARRAY(PlayerDataPool); i += 1){
-		if(PlayerDataPool[i].CharacterID == CharacterID){
-			Slot = &PlayerDataPool[i];
-			break;
+	uint32 Mask = (uint32)PlayerDataPoolIndexSize - 1;
+	uint32 Index = PlayerPoolIndexHome(CharacterID);
+	while(PlayerDataPoolIndex[Index] != 0){
+		TPlayerData *Slot = &PlayerDataPool[PlayerDataPoolIndex[Index] - 1];
+		if(Slot->CharacterID == CharacterID){
+			return Slot;
 		}
+		Index = (Index + 1) & Mask;
 	}
-	return Slot;
+	return NULL;
 }
 
 TPlayerData *AssignPlayerPoolSlot(uint32 CharacterID, bool DontWait){
@@ -2731,22 +4018,18 @@ TPlayerData *AssignPlayerPoolSlot(uint32 CharacterID, bool DontWait){
 	ASSERT(Slot == NULL);
 
 	// NOTE(fusion): Try to find an empty slot.
-	for(int i = 0; i < NARRAY(PlayerDataPool); i += 1){
-		if(PlayerDataPool[i].CharacterID == 0){
-			Slot = &PlayerDataPool[i];
-			break;
-		}
-	}
+	Slot = PopPlayerPoolFree();
 
 	if(Slot == NULL){
 		// NOTE(fusion): Try to find a non-empty slot that is not being used and
 		// doesn't need to be saved.
-		for(int i = 0; i < NARRAY(PlayerDataPool); i += 1){
+		for(int i = 0; i < PlayerDataPoolSlots; i += 1){
 			if(PlayerDataPool[i].Locked == 0
 					&& PlayerDataPool[i].Sticky == 0
 					&& !PlayerDataPool[i].Dirty){
-				Slot = &PlayerDataPool[i];
-				FreePlayerPoolSlot(Slot);
+				FreePlayerPoolSlot(&PlayerDataPool[i]);
+				PlayerDataPoolEvictions += 1;
+				Slot = PopPlayerPoolFree();
 				break;
 			}
 		}
@@ -2754,10 +4037,12 @@ TPlayerData *AssignPlayerPoolSlot(uint32 CharacterID, bool DontWait){
 
 	if(Slot == NULL){
 		// NOTE(fusion): Try to find a non-empty slot that is not being used.
-		for(int i = 0; i < NARRAY(PlayerDataPool); i += 1){
+		for(int i = 0; i < PlayerDataPoolSlots; i += 1){
 			if(PlayerDataPool[i].Locked == 0 && PlayerDataPool[i].Sticky == 0){
-				Slot = &PlayerDataPool[i];
-				FreePlayerPoolSlot(Slot);
+				FreePlayerPoolSlot(&PlayerDataPool[i]);
+				PlayerDataPoolEvictions += 1;
+				PlayerDataPoolDirtyEvictions += 1;
+				Slot = PopPlayerPoolFree();
 				break;
 			}
 		}
@@ -2772,6 +4057,7 @@ TPlayerData *AssignPlayerPoolSlot(uint32 CharacterID, bool DontWait){
 	memset(Slot, 0, sizeof(TPlayerData));
 	Slot->CharacterID = CharacterID;
 	Slot->Locked = gettid();
+	InsertPlayerPoolIndex(Slot);
 	PlayerDataPoolMutex.up();
 
 	print(3, "Loading data for player %u.\n", CharacterID);
@@ -2781,8 +4067,13 @@ TPlayerData *AssignPlayerPoolSlot(uint32 CharacterID, bool DontWait){
 	}
 
 	if(!LoadPlayerData(Slot)){
+		PlayerDataPoolMutex.down();
+		RemovePlayerPoolIndex(Slot);
 		Slot->CharacterID = 0;
 		Slot->Locked = 0;
+		PushPlayerPoolFree(Slot);
+		PlayerDataPoolMutex.up();
+		PlayerDataPoolReleased.signal();
 		Slot = NULL;
 	}
 
@@ -2906,12 +4197,29 @@ void ReleasePlayerPoolSlot(TPlayerData *Slot){
 	}
 
 	Slot->Locked = 0;
+	PlayerDataPoolReleased.signal();
+}
+
+uint32 GetPlayerPoolReleaseGeneration(void){
+	return PlayerDataPoolReleased.generation();
+}
+
+bool WaitPlayerPoolRelease(uint32 Generation, int Milliseconds){
+	return PlayerDataPoolReleased.wait(Generation, Milliseconds);
 }
 
 void SavePlayerPoolSlots(void){
+	// NOTE(fusion): Each call handles the next of `PLAYERDATA_SAVE_STEPS` slices
+	// of the pool, so every slot is visited once per save interval without all
+	// of them being written at once.
+	int Step = PlayerDataSaveStep;
+	PlayerDataSaveStep = (Step + 1) % PLAYERDATA_SAVE_STEPS;
+	int First = (int)(((int64)PlayerDataPoolSlots * Step) / PLAYERDATA_SAVE_STEPS);
+	int Last = (int)(((int64)PlayerDataPoolSlots * (Step + 1)) / PLAYERDATA_SAVE_STEPS);
+
 	time_t Now = time(NULL);
-	print(3, "Saving all player data...\n");
-	for(int i = 0; i < NARRAY(PlayerDataPool); i += 1){
+	print(3, "Saving player data (slots %d to %d)...\n", First, Last - 1);
+	for(int i = First; i < Last; i += 1){
 		TPlayerData *Slot = &PlayerDataPool[i];
 		if(Slot->CharacterID == 0
 				|| Slot->Locked != 0
@@ -2931,15 +4239,93 @@ void SavePlayerPoolSlots(void){
 			ReleasePlayerPoolSlot(Slot);
 		}
 	}
+
+	if(PlayerDataSaveStep == 0){
+		PlayerDataSaveSummary();
+	}
+}
+
+void GetPlayerPoolStatistics(int *Slots, int *Used, int *Sticky, uint32 *Evictions){
+	PlayerDataPoolMutex.down();
+	*Slots = PlayerDataPoolSlots;
+	*Used = PlayerDataPoolSlots - PlayerDataPoolFreeSlots;
+	*Sticky = 0;
+	for(int i = 0; i < PlayerDataPoolSlots; i += 1){
+		if(PlayerDataPool[i].CharacterID != 0 && PlayerDataPool[i].Sticky > 0){
+			*Sticky += 1;
+		}
+	}
+	*Evictions = PlayerDataPoolEvictions;
+	PlayerDataPoolMutex.up();
+}
+
+void PlayerPoolSummary(void){
+	int Slots, Used, Sticky;
+	uint32 Evictions;
+	GetPlayerPoolStatistics(&Slots, &Used, &Sticky, &Evictions);
+	Log("game", "Player data pool: %d/%d slots used, %d sticky, %u evictions (%u dirty).\n",
+			Used, Slots, Sticky, Evictions, PlayerDataPoolDirtyEvictions);
+
+	int Quests = 0;
+	int QuestBytes = 0;
+	PlayerDataPoolMutex.down();
+	for(int i = 0; i < PlayerDataPoolSlots; i += 1){
+		TPlayerData *Slot = &PlayerDataPool[i];
+		if(Slot->CharacterID != 0){
+			Quests += Slot->QuestValues.Count;
+			QuestBytes += Slot->QuestValues.Capacity * (int)sizeof(TQuestValue);
+		}
+	}
+	PlayerDataPoolMutex.up();
+	Log("game", "Player data slots: %d bytes each (%d with dense quest values),"
+			" %d quest values in %d KB (%d KB as dense arrays).\n",
+			(int)sizeof(TPlayerData),
+			(int)sizeof(TPlayerData) - (int)sizeof(TQuestValues) + QUESTVALUES_DENSE_SIZE,
+			Quests, QuestBytes / 1024, (Used * QUESTVALUES_DENSE_SIZE) / 1024);
+
+	PlayerDataPoolMutex.down();
+	PlayerDataPoolEvictions = 0;
+	PlayerDataPoolDirtyEvictions = 0;
+	PlayerDataPoolMutex.up();
 }
 
 void InitPlayerPool(void){
-	memset(PlayerDataPool, 0, sizeof(PlayerDataPool));
+	PlayerDataPoolSlots = PlayerDataPoolSize;
+	if(PlayerDataPoolSlots < 1){
+		error("InitPlayerPool: Invalid pool size %d.\n", PlayerDataPoolSlots);
+		PlayerDataPoolSlots = 1;
+	}
+
+	PlayerDataPoolIndexSize = 16;
+	PlayerDataPoolIndexShift = 28;
+	while(PlayerDataPoolIndexSize < PlayerDataPoolSlots * 2){
+		PlayerDataPoolIndexSize *= 2;
+		PlayerDataPoolIndexShift -= 1;
+	}
+
+	PlayerDataPool = (TPlayerData*)calloc(PlayerDataPoolSlots, sizeof(TPlayerData));
+	PlayerDataPoolIndex = (int*)calloc(PlayerDataPoolIndexSize, sizeof(int));
+	PlayerDataPoolFree = (int*)calloc(PlayerDataPoolSlots, sizeof(int));
+	if(PlayerDataPool == NULL || PlayerDataPoolIndex == NULL || PlayerDataPoolFree == NULL){
+		throw "cannot allocate player data pool";
+	}
+
+	// NOTE(fusion): Hand out lower slots first, like the original scan did.
+	PlayerDataPoolFreeSlots = 0;
+	for(int i = PlayerDataPoolSlots - 1; i >= 0; i -= 1){
+		PushPlayerPoolFree(&PlayerDataPool[i]);
+	}
+	PlayerDataPoolEvictions = 0;
+	PlayerDataPoolDirtyEvictions = 0;
+
+#if ENABLE_ASSERTIONS
+	CheckPlayerDataQuestLimit();
+#endif
 }
 
 void ExitPlayerPool(void){
 	// TODO(fusion): I assume the order in `ExitAll` is such to make this work?
-	for(int i = 0; i < NARRAY(PlayerDataPool); i += 1){
+	for(int i = 0; i < PlayerDataPoolSlots; i += 1){
 		TPlayerData *Slot = &PlayerDataPool[i];
 		if(Slot->CharacterID == 0){
 			continue;
@@ -2959,98 +4345,352 @@ void ExitPlayerPool(void){
 		}
 
 		AttachPlayerPoolSlot(Slot, false);
+		PlayerDataPoolMutex.down();
 		FreePlayerPoolSlot(Slot);
+		PlayerDataPoolMutex.up();
 		ReleasePlayerPoolSlot(Slot);
 	}
 	print(1, "All player data saved.\n");
+
+	free(PlayerDataPool);
+	free(PlayerDataPoolIndex);
+	free(PlayerDataPoolFree);
+	PlayerDataPool = NULL;
+	PlayerDataPoolIndex = NULL;
+	PlayerDataPoolFree = NULL;
+	PlayerDataPoolSlots = 0;
+	PlayerDataPoolFreeSlots = 0;
 }
 
 // Player Index
 // =============================================================================
-int GetPlayerIndexEntryNumber(const char *Name, int Position){
-	if(Name == NULL){
-		error("GetPlayerIndexEntryNumber: Name is NULL.\n");
-		return 0;
+// NOTE(fusion): Names are kept in a flat entry array plus an open addressed
+// table of entry numbers plus one, hashed case insensitively so lookups agree
+// with `stricmp`. When `PlayerIndexSnapshotAge` is set, the whole thing is
+// written as a snapshot to SAVEPATH on exit and mapped back on startup, after
+// which only characters above the highest CharacterID previously received from
+// the query manager are requested. The snapshot is written with some spare
+// capacity so new names can go straight into the (private) mapping. The query
+// manager has no way to report deleted or renamed characters, so those only
+// disappear with a full reload, done on every restart unless a snapshot younger
+// than `PlayerIndexSnapshotAge` exists.
+#define PLAYERINDEX_MAGIC 0x58444950 // "PIDX"
+#define PLAYERINDEX_VERSION 1
+#define PLAYERINDEX_HEADER_SIZE 32
+#define PLAYERINDEX_QUERY_SIZE 10000
+
+static TPlayerIndexEntry *PlayerIndexEntry;
+static int PlayerIndexEntries;
+static int PlayerIndexCapacity;
+static uint32 *PlayerIndexTable;
+static int PlayerIndexTableSize;
+static uint32 PlayerIndexHighWater;
+static bool PlayerIndexModified;
+static uint8 *PlayerIndexMapping;
+static size_t PlayerIndexMappingSize;
+
+static void GetPlayerIndexFileName(char *Buffer, int BufferSize){
+	snprintf(Buffer, BufferSize, "%s/players.idx", SAVEPATH);
+}
+
+static uint32 PlayerIndexHash(const char *Name){
+	// NOTE(fusion): 32-bit FNV-1a over the same case folding as `stricmp`.
+	uint32 Hash = 2166136261U;
+	for(int i = 0; Name[i] != 0; i += 1){
+		Hash = (Hash ^ (uint8)toLower(Name[i])) * 16777619U;
 	}
+	return Hash;
+}
 
-	if(Position < (int)strlen(Name)){
-		int ch = Name[Position];
-		if(ch >= 'A' && ch <= 'Z'){
-			return ch - 'A';
-		}else if(ch >= 'a' && ch <= 'z'){
-			return ch - 'a';
-		}
+static uint32 PlayerIndexChecksum(uint32 Hash, const uint8 *Data, int Size){
+	for(int i = 0; i < Size; i += 1){
+		Hash = (Hash ^ Data[i]) * 16777619U;
 	}
-	return 0;
+	return Hash;
 }
 
-void InsertPlayerIndex(TPlayerIndexInternalNode *Node,
-		int Position, const char *Name, uint32 CharacterID){
-	while(true){
-		if(Node == NULL){
-			error("InsertPlayerIndex: Node is NULL.\n");
-			return;
-		}
+static int PlayerIndexTableSizeFor(int Capacity){
+	int TableSize = 1024;
+	while(TableSize < Capacity * 2){
+		TableSize *= 2;
+	}
+	return TableSize;
+}
 
-		if(Name == NULL){
-			error("InsertPlayerIndex: Name is NULL.\n");
-			return;
+static uint32 *FindPlayerIndexSlot(TPlayerIndexEntry *Entry,
+		uint32 *Table, int TableSize, const char *Name){
+	// NOTE(fusion): Returns the table slot holding `Name` or the empty slot
+	// where it would have to be inserted.
+	uint32 Mask = (uint32)TableSize - 1;
+	uint32 Index = PlayerIndexHash(Name) & Mask;
+	while(Table[Index] != 0 && stricmp(Entry[Table[Index] - 1].Name, Name) != 0){
+		Index = (Index + 1) & Mask;
+	}
+	return &Table[Index];
+}
+
+static void ReleasePlayerIndex(void){
+	if(PlayerIndexMapping != NULL){
+		munmap(PlayerIndexMapping, PlayerIndexMappingSize);
+		PlayerIndexMapping = NULL;
+		PlayerIndexMappingSize = 0;
+	}else{
+		free(PlayerIndexEntry);
+		free(PlayerIndexTable);
+	}
+
+	PlayerIndexEntry = NULL;
+	PlayerIndexEntries = 0;
+	PlayerIndexCapacity = 0;
+	PlayerIndexTable = NULL;
+	PlayerIndexTableSize = 0;
+}
+
+static void ResizePlayerIndex(int Capacity){
+	int TableSize = PlayerIndexTableSizeFor(Capacity);
+	TPlayerIndexEntry *Entry = (TPlayerIndexEntry*)calloc(Capacity, sizeof(TPlayerIndexEntry));
+	uint32 *Table = (uint32*)calloc(TableSize, sizeof(uint32));
+	if(Entry == NULL || Table == NULL){
+		throw "cannot allocate player index";
+	}
+
+	int Entries = PlayerIndexEntries;
+	if(Entries > 0){
+		memcpy(Entry, PlayerIndexEntry, Entries * sizeof(TPlayerIndexEntry));
+	}
+
+	for(int i = 0; i < Entries; i += 1){
+		*FindPlayerIndexSlot(Entry, Table, TableSize, Entry[i].Name) = (uint32)(i + 1);
+	}
+
+	ReleasePlayerIndex();
+	PlayerIndexEntry = Entry;
+	PlayerIndexEntries = Entries;
+	PlayerIndexCapacity = Capacity;
+	PlayerIndexTable = Table;
+	PlayerIndexTableSize = TableSize;
+}
+
+static bool LoadPlayerIndexSnapshot(const char *FileName){
+	int FileDescriptor = open(FileName, O_RDONLY);
+	if(FileDescriptor == -1){
+		return false;
+	}
+
+	// NOTE(fusion): The mapping is private so names added or changed while
+	// running never reach the file, which is only replaced as a whole.
+	uint8 *Mapping = NULL;
+	size_t MappingSize = 0;
+	struct stat SnapshotStat;
+	if(fstat(FileDescriptor, &SnapshotStat) == 0
+			&& SnapshotStat.st_size >= PLAYERINDEX_HEADER_SIZE){
+		void *Result = mmap(NULL, (size_t)SnapshotStat.st_size,
+				PROT_READ | PROT_WRITE, MAP_PRIVATE, FileDescriptor, 0);
+		if(Result != MAP_FAILED){
+			Mapping = (uint8*)Result;
+			MappingSize = (size_t)SnapshotStat.st_size;
 		}
+	}
+	close(FileDescriptor);
 
-		int ChildIndex = GetPlayerIndexEntryNumber(Name, Position);
-		TPlayerIndexNode *Child = Node->Child[ChildIndex];
-		if(Child == NULL){
-			TPlayerIndexLeafNode *Leaf = PlayerIndexLeafNodes.getFreeItem();
-			memset(Leaf, 0, sizeof(TPlayerIndexLeafNode));
-			Leaf->InternalNode = false;
-			Leaf->Count = 1;
-			strcpy(Leaf->Entry[0].Name, Name);
-			Leaf->Entry[0].CharacterID = CharacterID;
-			Node->Child[ChildIndex] = Leaf;
-			return;
+	if(Mapping == NULL){
+		error("LoadPlayerIndexSnapshot: Cannot map %s.\n", FileName);
+		return false;
+	}
+
+	TReadBuffer Buffer(Mapping, PLAYERINDEX_HEADER_SIZE);
+	uint32 Magic = Buffer.readQuad();
+	uint32 Version = Buffer.readQuad();
+	int Entries = (int)Buffer.readQuad();
+	int Capacity = (int)Buffer.readQuad();
+	int TableSize = (int)Buffer.readQuad();
+	uint32 HighWater = Buffer.readQuad();
+	uint32 Checksum = Buffer.readQuad();
+	int Created = (int)Buffer.readQuad();
+
+	bool Valid = Magic == PLAYERINDEX_MAGIC
+			&& Version == PLAYERINDEX_VERSION
+			&& Entries >= 0 && Capacity >= Entries
+			&& TableSize == PlayerIndexTableSizeFor(Capacity)
+			&& MappingSize == (size_t)PLAYERINDEX_HEADER_SIZE
+					+ (size_t)Capacity * sizeof(TPlayerIndexEntry)
+					+ (size_t)TableSize * sizeof(uint32);
+
+	TPlayerIndexEntry *Entry = (TPlayerIndexEntry*)(Mapping + PLAYERINDEX_HEADER_SIZE);
+	uint32 *Table = (uint32*)(Mapping + PLAYERINDEX_HEADER_SIZE
+			+ (size_t)Capacity * sizeof(TPlayerIndexEntry));
+	if(Valid){
+		uint32 Hash = 2166136261U;
+		Hash = PlayerIndexChecksum(Hash, (const uint8*)Entry,
+				Entries * (int)sizeof(TPlayerIndexEntry));
+		Hash = PlayerIndexChecksum(Hash, (const uint8*)Table,
+				TableSize * (int)sizeof(uint32));
+		Valid = Hash == Checksum;
+	}
+
+	if(!Valid){
+		error("LoadPlayerIndexSnapshot: Invalid snapshot %s.\n", FileName);
+		munmap(Mapping, MappingSize);
+		return false;
+	}
+
+	int Age = (int)time(NULL) - Created;
+	if(Age > PlayerIndexSnapshotAge){
+		print(1, "Player index snapshot is %d hours old; reloading all names.\n", Age / 3600);
+		munmap(Mapping, MappingSize);
+		return false;
+	}
+
+	PlayerIndexMapping = Mapping;
+	PlayerIndexMappingSize = MappingSize;
+	PlayerIndexEntry = Entry;
+	PlayerIndexEntries = Entries;
+	PlayerIndexCapacity = Capacity;
+	PlayerIndexTable = Table;
+	PlayerIndexTableSize = TableSize;
+	PlayerIndexHighWater = HighWater;
+	print(1, "Player index snapshot loaded (%d names).\n", Entries);
+	return true;
+}
+
+static void SavePlayerIndexSnapshot(const char *FileName){
+	int Entries = PlayerIndexEntries;
+	int Capacity = Entries + std::max<int>(Entries / 8, 1024);
+	int TableSize = PlayerIndexTableSizeFor(Capacity);
+	uint32 *Table = (uint32*)calloc(TableSize, sizeof(uint32));
+	if(Table == NULL){
+		error("SavePlayerIndexSnapshot: Cannot allocate table.\n");
+		return;
+	}
+
+	for(int i = 0; i < Entries; i += 1){
+		*FindPlayerIndexSlot(PlayerIndexEntry, Table, TableSize,
+				PlayerIndexEntry[i].Name) = (uint32)(i + 1);
+	}
+
+	uint32 Checksum = 2166136261U;
+	Checksum = PlayerIndexChecksum(Checksum, (const uint8*)PlayerIndexEntry,
+			Entries * (int)sizeof(TPlayerIndexEntry));
+	Checksum = PlayerIndexChecksum(Checksum, (const uint8*)Table,
+			TableSize * (int)sizeof(uint32));
+
+	// NOTE(fusion): Write to a temporary file first so a failed write doesn't
+	// leave a truncated snapshot behind.
+	char TempFileName[4096];
+	snprintf(TempFileName, sizeof(TempFileName), "%s.tmp", FileName);
+	try{
+		TWriteBinaryFile File;
+		File.open(TempFileName);
+		File.writeQuad(PLAYERINDEX_MAGIC);
+		File.writeQuad(PLAYERINDEX_VERSION);
+		File.writeQuad((uint32)Entries);
+		File.writeQuad((uint32)Capacity);
+		File.writeQuad((uint32)TableSize);
+		File.writeQuad(PlayerIndexHighWater);
+		File.writeQuad(Checksum);
+		File.writeQuad((uint32)time(NULL));
+		File.writeBytes((const uint8*)PlayerIndexEntry,
+				Entries * (int)sizeof(TPlayerIndexEntry));
+
+		TPlayerIndexEntry Empty = {};
+		for(int i = Entries; i < Capacity; i += 1){
+			File.writeBytes((const uint8*)&Empty, (int)sizeof(TPlayerIndexEntry));
+		}
+
+		File.writeBytes((const uint8*)Table, TableSize * (int)sizeof(uint32));
+		File.close();
+
+		if(rename(TempFileName, FileName) != 0){
+			error("SavePlayerIndexSnapshot: Cannot rename %s.\n", TempFileName);
+		}else{
+			PlayerIndexModified = false;
+			print(1, "Player index snapshot written (%d names).\n", Entries);
 		}
+	}catch(const char *str){
+		error("SavePlayerIndexSnapshot: Cannot write snapshot (%s).\n", str);
+		unlink(TempFileName);
+	}
 
-		if(Child->InternalNode){
-			Position += 1;
-			Node = (TPlayerIndexInternalNode*)Child;
-			continue;
+	free(Table);
+}
+
+static void LoadPlayerIndexDelta(void){
+	TQueryManagerConnection QueryManager(360007);
+	if(!QueryManager.isConnected()){
+		error("InitPlayerIndex: Cannot connect to query manager.\n");
+		return;
+	}
+
+	// NOTE(fusion): These used to be stack arrays of about 340KB.
+	uint32 *CharacterIDs = new uint32[PLAYERINDEX_QUERY_SIZE];
+	char (*Names)[30] = new char[PLAYERINDEX_QUERY_SIZE][30];
+	uint32 MinimumCharacterID = 0;
+	if(PlayerIndexHighWater != 0){
+		MinimumCharacterID = PlayerIndexHighWater + 1;
+	}
+
+	int Loaded = 0;
+	while(true){
+		int NumberOfPlayers;
+		int Ret = QueryManager.loadPlayers(MinimumCharacterID,
+				&NumberOfPlayers, Names, CharacterIDs);
+		if(Ret != 0){
+			error("InitPlayerIndex: Cannot determine player data.\n");
+			break;
 		}
 
-		TPlayerIndexLeafNode *ChildLeaf = (TPlayerIndexLeafNode*)Child;
-		for(int i = 0; i < ChildLeaf->Count; i += 1){
-			// NOTE(fusion): Check if entry is already in the index?
-			// TODO(fusion): We should probably be using `stricmp` here.
-			if(strcmp(ChildLeaf->Entry[i].Name, Name) == 0){
-				return;
-			}
+		for(int i = 0; i < NumberOfPlayers; i += 1){
+			InsertPlayerIndex(Names[i], CharacterIDs[i]);
+			PlayerIndexHighWater = std::max<uint32>(PlayerIndexHighWater, CharacterIDs[i]);
 		}
+		Loaded += NumberOfPlayers;
 
-		if(ChildLeaf->Count < NARRAY(ChildLeaf->Entry)){
-			strcpy(ChildLeaf->Entry[ChildLeaf->Count].Name, Name);
-			ChildLeaf->Entry[ChildLeaf->Count].CharacterID = CharacterID;
-			ChildLeaf->Count += 1;
-			return;
+		if(NumberOfPlayers < PLAYERINDEX_QUERY_SIZE){
+			break;
 		}
 
-		// NOTE(fusion): Child leaf node is full so we need to create a new
-		// internal node and move all previous leaf entries to it. Note that
-		// the position is also increased here, so entries should get different
-		// child indices.
-		TPlayerIndexInternalNode *ChildInternal = PlayerIndexInternalNodes.getFreeItem();
-		memset(ChildInternal, 0, sizeof(TPlayerIndexInternalNode));
-		ChildInternal->InternalNode = true;
-		Node->Child[ChildIndex] = ChildInternal;
+		MinimumCharacterID = CharacterIDs[PLAYERINDEX_QUERY_SIZE - 1] + 1;
+	}
+
+	delete[] CharacterIDs;
+	delete[] Names;
+	print(1, "Loaded %d names from query manager (%d in player index).\n",
+			Loaded, PlayerIndexEntries);
+}
+
+void InsertPlayerIndex(const char *Name, uint32 CharacterID){
+	if(Name == NULL){
+		error("InsertPlayerIndex: Name is NULL.\n");
+		return;
+	}
 
-		for(int i = 0; i < ChildLeaf->Count; i += 1){
-			InsertPlayerIndex(ChildInternal, Position + 1,
-					ChildLeaf->Entry[i].Name,
-					ChildLeaf->Entry[i].CharacterID);
+	uint32 *Slot = FindPlayerIndexSlot(PlayerIndexEntry,
+			PlayerIndexTable, PlayerIndexTableSize, Name);
+	if(*Slot != 0){
+		// NOTE(fusion): Names of deleted characters may be taken again, in
+		// which case the newest character wins.
+		TPlayerIndexEntry *Entry = &PlayerIndexEntry[*Slot - 1];
+		if(Entry->CharacterID != CharacterID || strcmp(Entry->Name, Name) != 0){
+			strncpy(Entry->Name, Name, sizeof(Entry->Name) - 1);
+			Entry->CharacterID = CharacterID;
+			PlayerIndexModified = true;
 		}
-		PlayerIndexLeafNodes.putFreeItem(ChildLeaf);
+		return;
+	}
 
-		Position += 1;
-		Node = ChildInternal;
+	if(PlayerIndexEntries >= PlayerIndexCapacity){
+		ResizePlayerIndex(std::max<int>(PlayerIndexCapacity * 2, 1024));
+		Slot = FindPlayerIndexSlot(PlayerIndexEntry,
+				PlayerIndexTable, PlayerIndexTableSize, Name);
 	}
+
+	TPlayerIndexEntry *Entry = &PlayerIndexEntry[PlayerIndexEntries];
+	memset(Entry, 0, sizeof(TPlayerIndexEntry));
+	strncpy(Entry->Name, Name, sizeof(Entry->Name) - 1);
+	Entry->CharacterID = CharacterID;
+	PlayerIndexEntries += 1;
+	*Slot = (uint32)PlayerIndexEntries;
+	PlayerIndexModified = true;
 }
 
 TPlayerIndexEntry *SearchPlayerIndex(const char *Name){
@@ -3059,24 +4699,13 @@ TPlayerIndexEntry *SearchPlayerIndex(const char *Name){
 		return NULL;
 	}
 
-	TPlayerIndexNode *Node = &PlayerIndexHead;
-	for(int Position = 0; Node->InternalNode; Position += 1){
-		int ChildIndex = GetPlayerIndexEntryNumber(Name, Position);
-		Node = ((TPlayerIndexInternalNode*)Node)->Child[ChildIndex];
-		if(Node == NULL){
-			return NULL;
-		}
-	}
-
-	ASSERT(!Node->InternalNode);
-	TPlayerIndexLeafNode *Leaf = (TPlayerIndexLeafNode*)Node;
-	for(int i = 0; i < Leaf->Count; i += 1){
-		if(stricmp(Leaf->Entry[i].Name, Name) == 0){
-			return &Leaf->Entry[i];
-		}
+	uint32 *Slot = FindPlayerIndexSlot(PlayerIndexEntry,
+			PlayerIndexTable, PlayerIndexTableSize, Name);
+	if(*Slot == 0){
+		return NULL;
 	}
 
-	return NULL;
+	return &PlayerIndexEntry[*Slot - 1];
 }
 
 bool PlayerExists(const char *Name){
@@ -3117,45 +4746,30 @@ const char *GetCharacterName(const char *Name){
 }
 
 void InitPlayerIndex(void){
-	memset(&PlayerIndexHead, 0, sizeof(TPlayerIndexInternalNode));
-	PlayerIndexHead.InternalNode = true;
-
-	// TODO(fusion): The `QueryBufferSize` parameter to `TQueryManagerConnection`
-	// is probably related to the size of both these arrays. There gotta be some
-	// type of limit per load query or we'd easily overflow these buffers. It may
-	// be hardcoded.
-	uint32 CharacterIDs[10000];
-	char Names[10000][30];
-	TQueryManagerConnection QueryManager(360007);
-	if(!QueryManager.isConnected()){
-		error("InitPlayerIndex: Cannot connect to query manager.\n");
-		return;
-	}
-
-	int MinimumCharacterID = 0;
-	while(true){
-		int NumberOfPlayers;
-		int Ret = QueryManager.loadPlayers(MinimumCharacterID,
-				&NumberOfPlayers, Names, CharacterIDs);
-		if(Ret != 0){
-			error("InitPlayerIndex: Cannot determine player data.\n");
-			break;
-		}
-
-		for(int i = 0; i < NumberOfPlayers; i += 1){
-			InsertPlayerIndex(&PlayerIndexHead, 0, Names[i], CharacterIDs[i]);
-		}
+	PlayerIndexHighWater = 0;
+	PlayerIndexModified = false;
 
-		if(NumberOfPlayers < 10000){
-			break;
-		}
+	char FileName[4096];
+	GetPlayerIndexFileName(FileName, sizeof(FileName));
+	if(PlayerIndexSnapshotAge <= 0 || !LoadPlayerIndexSnapshot(FileName)){
+		PlayerIndexHighWater = 0;
+		ResizePlayerIndex(1024);
+	}
 
-		MinimumCharacterID = CharacterIDs[9999] + 1;
+	LoadPlayerIndexDelta();
+	if(PlayerIndexSnapshotAge > 0 && PlayerIndexModified){
+		SavePlayerIndexSnapshot(FileName);
 	}
 }
 
 void ExitPlayerIndex(void){
-	// no-op
+	if(PlayerIndexSnapshotAge > 0 && PlayerIndexModified){
+		char FileName[4096];
+		GetPlayerIndexFileName(FileName, sizeof(FileName));
+		SavePlayerIndexSnapshot(FileName);
+	}
+
+	ReleasePlayerIndex();
 }
 
 // Initialization
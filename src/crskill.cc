@@ -14,6 +14,7 @@ TSkill::TSkill(int SkNr, TCreature *Master){
 
 	this->SkNr = (uint16)SkNr;
 	this->Master = Master;
+	this->CountRound = 0;
 }
 
 int TSkill::Get(void){
@@ -55,6 +56,18 @@ void TSkill::Check(void){
 	}
 }
 
+void TSkill::SyncCount(void){
+	// NOTE(fusion): Creatures are only processed on skill timer rounds where one
+	// of their timers is due (see `ScheduleSkillTimers`). On every other round
+	// `Process` would have just decremented `Count`, so we catch up on these
+	// lazily whenever `Count` is about to be used.
+	if(this->Cycle != 0 && this->Master != NULL && this->Master->InCrList
+			&& this->CountRound < SkillTimerRound){
+		this->Count -= (int)(SkillTimerRound - this->CountRound);
+		this->CountRound = SkillTimerRound;
+	}
+}
+
 void TSkill::Change(int Amount){
 	this->Set(this->Act + Amount);
 
@@ -118,6 +131,7 @@ void TSkill::Load(int Act, int Max, int Min, int DAct, int MDAct,
 void TSkill::Save(int *Act, int *Max, int *Min, int *DAct, int *MDAct,
 		int *Cycle, int *MaxCycle, int *Count, int *MaxCount, int *AddLevel,
 		int *Exp, int *FactorPercent, int *NextLevel, int *Delta){
+	this->SyncCount();
 	*Act = this->Act;
 	*Max = this->Max;
 	*Min = this->Min;
@@ -790,6 +804,7 @@ void TSkillSoulpoints::Set(int Value){
 }
 
 int TSkillSoulpoints::TimerValue(void){
+	this->SyncCount();
 	return (this->Cycle - 1) * this->MaxCount + this->Count;
 }
 
@@ -1113,6 +1128,7 @@ TSkillBase::TSkillBase(void){
 		this->TimerList[i] = NULL;
 	}
 	this->FirstFreeTimer = 0;
+	this->TimerDueRound = 0;
 }
 
 TSkillBase::~TSkillBase(void){
@@ -1194,8 +1210,17 @@ void TSkillBase::ProcessSkills(void){
 	int Index = 0;
 	while(Index < this->FirstFreeTimer){
 		// TODO(fusion): Probably remove if `Skill == NULL`?
+		// NOTE(fusion): Timers already processed on this round are skipped, in
+		// case the creature got rescheduled for the same round.
 		TSkill *Skill = this->TimerList[Index];
-		if(Skill != NULL && Skill->Process()){
+		bool Expired = false;
+		if(Skill != NULL && Skill->CountRound <= SkillTimerRound){
+			Skill->SyncCount();
+			Skill->CountRound = SkillTimerRound + 1;
+			Expired = Skill->Process();
+		}
+
+		if(Expired){
 			// NOTE(fusion): A little swap and pop action.
 			this->FirstFreeTimer -= 1;
 			this->TimerList[Index] = this->TimerList[this->FirstFreeTimer];
@@ -1206,6 +1231,29 @@ void TSkillBase::ProcessSkills(void){
 	}
 }
 
+uint32 TSkillBase::NextTimerRound(void){
+	// NOTE(fusion): A timer with `Count` at `CountRound` is decremented on each
+	// of the next `Count` rounds and only does something on the round after
+	// that, except for finished timers which are removed on the next round.
+	uint32 Result = 0;
+	for(int Index = 0; Index < this->FirstFreeTimer; Index += 1){
+		TSkill *Skill = this->TimerList[Index];
+		if(Skill == NULL){
+			continue;
+		}
+
+		uint32 Round = Skill->CountRound + 1;
+		if(Skill->Cycle != 0 && Skill->Count > 0){
+			Round += (uint32)Skill->Count;
+		}
+
+		if(Result == 0 || Round < Result){
+			Result = Round;
+		}
+	}
+	return Result;
+}
+
 bool TSkillBase::SetTimer(uint16 SkNr, int Cycle, int Count, int MaxCount, int AdditionalValue){
 	if(SkNr >= NARRAY(this->Skills)){
 		error("TSkillBase::SetTimer: Invalid SkNr: %d\n", SkNr);
@@ -1224,6 +1272,11 @@ bool TSkillBase::SetTimer(uint16 SkNr, int Cycle, int Count, int MaxCount, int A
 		ASSERT(this->FirstFreeTimer < NARRAY(this->TimerList));
 		this->TimerList[this->FirstFreeTimer] = Skill;
 		this->FirstFreeTimer += 1;
+
+		Skill->CountRound = SkillTimerRound;
+		if(Skill->Master != NULL){
+			ScheduleSkillTimers(Skill->Master);
+		}
 	}
 
 	return Result;
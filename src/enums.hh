@@ -52,6 +52,10 @@ enum BehaviourConditionType: int {
 	BEHAVIOUR_CONDITION_PARAMETER			= 3,
 	BEHAVIOUR_CONDITION_EXPRESSION			= 4,
 	BEHAVIOUR_CONDITION_SHORTCIRCUIT		= 5,
+
+	// NOTE(fusion): Only produced by `TBehaviourDatabase::compile`.
+	BEHAVIOUR_CONDITION_SITUATION			= 6,
+	BEHAVIOUR_CONDITION_COMPARE				= 7,
 };
 
 enum BehaviourNodeType: int {
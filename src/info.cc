@@ -107,38 +107,25 @@ int GetWeight(Object Obj, int Count){
 		return 0;
 	}
 
-	// TODO(fusion): Why do some UNTAKE items have weight, and even worse, hardcoded?
-
-	int Result = 0;
 	ObjectType ObjType = Obj.getObjectType();
-	if(ObjType.getFlag(TAKE)){
-		int Weight = (int)ObjType.getAttribute(WEIGHT);
-		if(!ObjType.getFlag(CUMULATIVE)){
-			Count = 1;
-		}else if(Count == -1){
-			Count = (int)Obj.getAttribute(AMOUNT);
-		}
-		Result = Weight * Count;
-	}else if(ObjType.TypeID == 2904){ // LARGE AMPHORA
-		Result = 19500;
-	}else if(ObjType.TypeID == 3458){ // ANVIL
-		Result = 50000;
-	}else if(ObjType.TypeID == 3510){ // COAL BASIN
-		Result = 22800;
-	}else if(ObjType.TypeID == 4311){ // DEAD HUMAN
-		Result = 80000;
-	}else{
+	if(ObjType.getFlag(CUMULATIVE) && Count == -1){
+		Count = (int)Obj.getAttribute(AMOUNT);
+	}
+
+	int Result = ObjType.getWeight(Count);
+	if(Result == 0 && !ObjType.getFlag(TAKE)){
 		error("GetWeight: Object type %d is not takeable.\n", ObjType.TypeID);
 	}
 	return Result;
 }
 
+// NOTE(fusion): The weight of an object's contents is cached by the map (see
+// `TObject::ContentWeight`) so this no longer walks the container tree.
 int GetCompleteWeight(Object Obj){
 	int Result = GetWeight(Obj, -1);
 	ObjectType ObjType = Obj.getObjectType();
 	if(ObjType.getFlag(CONTAINER) || ObjType.getFlag(CHEST)){
-		Object Help = GetFirstContainerObject(Obj);
-		Result += GetRowWeight(Help);
+		Result += GetContentWeight(Obj);
 	}
 	return Result;
 }
@@ -146,13 +133,7 @@ int GetCompleteWeight(Object Obj){
 int GetRowWeight(Object Obj){
 	int Result = 0;
 	while(Obj != NONE){
-		// TODO(fusion): This is probably `GetCompleteWeight` inlined.
-		Result += GetWeight(Obj, -1);
-		ObjectType ObjType = Obj.getObjectType();
-		if(ObjType.getFlag(CONTAINER) || ObjType.getFlag(CHEST)){
-			Object Help = GetFirstContainerObject(Obj);
-			Result += GetRowWeight(Help);
-		}
+		Result += GetCompleteWeight(Obj);
 		Obj = Obj.getNextObject();
 	}
 	return Result;
@@ -164,16 +145,14 @@ uint32 GetObjectCreatureID(Object Obj){
 		return 0;
 	}
 
+	// NOTE(fusion): Creature containers are always placed directly on the map
+	// so the owner of an object, if any, is its root.
 	uint32 CreatureID = 0;
-	while(Obj != NONE){
-		ObjectType ObjType = Obj.getObjectType();
-		if(ObjType.isCreatureContainer()){
-			CreatureID = Obj.getCreatureID();
-			break;
-		}else if(ObjType.isMapContainer()){
-			break;
+	if(!Obj.getObjectType().isMapContainer()){
+		Object Root = GetObjectRoot(Obj);
+		if(Root.getObjectType().isCreatureContainer()){
+			CreatureID = Root.getCreatureID();
 		}
-		Obj = Obj.getContainer();
 	}
 	return CreatureID;
 }
@@ -188,16 +167,10 @@ int GetObjectBodyPosition(Object Obj){
 	}
 
 	int Position = 0;
-	while(Obj != NONE){
-		ObjectType ObjType = Obj.getObjectType();
-		if(ObjType.isBodyContainer()){
-			// NOTE(fusion): Body container type ids match inventory slots exactly.
-			Position = ObjType.TypeID;
-			break;
-		}else if(ObjType.isMapContainer()){
-			break;
-		}
-		Obj = Obj.getContainer();
+	Object BodyCon = GetObjectBodyContainer(Obj);
+	if(BodyCon != NONE){
+		// NOTE(fusion): Body container type ids match inventory slots exactly.
+		Position = BodyCon.getObjectType().TypeID;
 	}
 	return Position;
 }
@@ -462,6 +435,18 @@ Object GetInventoryObject(uint32 CreatureID, ObjectType Type, uint32 Value){
 		return NONE;
 	}
 
+	// NOTE(fusion): Skip the search if nothing matching is being carried.
+	if(Creature->InventoryIndex.get(Type.TypeID, GetInventoryIndexValue(Type, Value)) == 0){
+#if ENABLE_ASSERTIONS
+		Object Help = GetFirstContainerObject(Creature->CrObject);
+		while(Help != NONE){
+			ASSERT(GetRowObject(GetFirstContainerObject(Help), Type, Value, true) == NONE);
+			Help = Help.getNextObject();
+		}
+#endif
+		return NONE;
+	}
+
 	Object Result = NONE;
 
 	// NOTE(fusion): Search inventory containers.
@@ -497,14 +482,24 @@ Object GetInventoryObject(uint32 CreatureID, ObjectType Type, uint32 Value){
 }
 
 bool IsHeldByContainer(Object Obj, Object Con){
-	// TODO(fusion): Why do we check for map container in some loops?
-	while(Obj != NONE && !Obj.getObjectType().isMapContainer()){
-		if(Obj == Con){
-			return true;
-		}
+	if(Obj == NONE || Con == NONE
+			|| Obj.getObjectType().isMapContainer()
+			|| Con.getObjectType().isMapContainer()){
+		return false;
+	}
+
+	// NOTE(fusion): Both objects must share the same root, in which case we only
+	// need to climb from `Obj` to the depth of `Con`.
+	if(GetObjectRoot(Obj) != GetObjectRoot(Con)){
+		return false;
+	}
+
+	int Steps = GetObjectDepth(Obj) - GetObjectDepth(Con);
+	while(Steps > 0){
 		Obj = Obj.getContainer();
+		Steps -= 1;
 	}
-	return false;
+	return Steps == 0 && Obj == Con;
 }
 
 int CountObjectsInContainer(Object Con){
@@ -583,8 +578,20 @@ int CountInventoryObjects(uint32 CreatureID, ObjectType Type, uint32 Value){
 		return 0;
 	}
 
+	// NOTE(fusion): `CountObjects` only compares `Value` against the body
+	// containers themselves, which never match, and passes zero down to their
+	// contents (see the BUG there). The index lookup keeps that behaviour.
+	int Count = Creature->InventoryIndex.get(Type.TypeID,
+			GetInventoryIndexValue(Type, 0));
+
+#if ENABLE_ASSERTIONS
 	Object Help = GetFirstContainerObject(Creature->CrObject);
-	return CountObjects(Help, Type, Value);
+	ASSERT(Count == CountObjects(Help, Type, Value));
+#else
+	(void)Value;
+#endif
+
+	return Count;
 }
 
 int CountMoney(Object Obj){
@@ -627,8 +634,105 @@ int CountInventoryMoney(uint32 CreatureID){
 		return 0;
 	}
 
+	int Money = Creature->InventoryIndex.Money;
+
+#if ENABLE_ASSERTIONS
 	Object Help = GetFirstContainerObject(Creature->CrObject);
-	return CountMoney(Help);
+	ASSERT(Money == CountMoney(Help));
+#endif
+
+	return Money;
+}
+
+// NOTE(fusion): Creature containers and body containers are the frame of an
+// inventory rather than part of it, and creature containers are never inside
+// one, so neither is indexed. Everything else below a creature container is.
+static void IndexInventoryObject(TInventoryIndex *Index, Object Obj, int Sign, bool Recurse){
+	ObjectType ObjType = Obj.getObjectType();
+	if(ObjType.isCreatureContainer()){
+		return;
+	}
+
+	if(!ObjType.isBodyContainer()){
+		uint32 Value = 0;
+		if(ObjType.getFlag(LIQUIDCONTAINER)){
+			Value = Obj.getAttribute(CONTAINERLIQUIDTYPE);
+		}else if(ObjType.getFlag(KEY)){
+			Value = Obj.getAttribute(KEYNUMBER);
+		}
+
+		int Count = 1;
+		if(ObjType.getFlag(CUMULATIVE)){
+			Count = (int)Obj.getAttribute(AMOUNT);
+		}
+
+		Index->add(ObjType.TypeID, Value, Sign * Count);
+		if(ObjType == GetSpecialObject(MONEY_ONE)){
+			Index->Money += Sign * Count;
+		}else if(ObjType == GetSpecialObject(MONEY_HUNDRED)){
+			Index->Money += Sign * Count * 100;
+		}else if(ObjType == GetSpecialObject(MONEY_TENTHOUSAND)){
+			Index->Money += Sign * Count * 10000;
+		}
+	}
+
+	if(Recurse && ObjType.getFlag(CONTAINER)){
+		Object Help = GetFirstContainerObject(Obj);
+		while(Help != NONE){
+			IndexInventoryObject(Index, Help, Sign, Recurse);
+			Help = Help.getNextObject();
+		}
+	}
+}
+
+uint32 GetInventoryIndexValue(ObjectType Type, uint32 Value){
+	if(Type.getFlag(LIQUIDCONTAINER) || Type.getFlag(KEY)){
+		return Value;
+	}
+	return 0;
+}
+
+// NOTE(fusion): These must be called with `Obj` as it is right before it leaves
+// or right after it enters the inventory of `CreatureID`, or changes anything
+// that is indexed, which is its type, amount, liquid type, or key number. Moves
+// within the same inventory and splits don't change any totals.
+void AddInventoryIndex(uint32 CreatureID, Object Obj, bool Recurse){
+	if(CreatureID == 0){
+		return;
+	}
+
+	TCreature *Creature = GetCreature(CreatureID);
+	if(Creature != NULL){
+		IndexInventoryObject(&Creature->InventoryIndex, Obj, 1, Recurse);
+	}
+}
+
+void RemoveInventoryIndex(uint32 CreatureID, Object Obj, bool Recurse){
+	if(CreatureID == 0){
+		return;
+	}
+
+	TCreature *Creature = GetCreature(CreatureID);
+	if(Creature != NULL){
+		IndexInventoryObject(&Creature->InventoryIndex, Obj, -1, Recurse);
+	}
+}
+
+void RebuildInventoryIndex(uint32 CreatureID){
+	TCreature *Creature = GetCreature(CreatureID);
+	if(Creature == NULL){
+		error("RebuildInventoryIndex: Creature %d does not exist.\n", CreatureID);
+		return;
+	}
+
+	Creature->InventoryIndex.clear();
+	if(Creature->CrObject != NONE){
+		Object BodyCon = GetFirstContainerObject(Creature->CrObject);
+		while(BodyCon != NONE){
+			IndexInventoryObject(&Creature->InventoryIndex, BodyCon, 1, true);
+			BodyCon = BodyCon.getNextObject();
+		}
+	}
 }
 
 void CalculateChange(int Amount, int *Gold, int *Platinum, int *Crystal){
@@ -758,15 +862,88 @@ bool FieldPossible(int x, int y, int z, int FieldType){
 	return true;
 }
 
-bool SearchFreeField(int *x, int *y, int *z, int Distance, uint16 HouseID, bool Jump){
+// NOTE(fusion): Offsets visited by the spiral used in `SearchFreeField`,
+// `SearchLoginField`, and `SearchSummonField`, in order, along with the
+// distance the spiral had reached when visiting them. A search with some
+// `Distance` visits every entry up to, but not including, the first one with
+// a greater distance.
+// TODO(fusion): This function used directions different from the ones used by
+// creatures and defined in `enums.hh` so I made it use them instead, LOL.
+#define SPIRAL_MAX_DISTANCE 16
+#define SPIRAL_MAX_OFFSETS ((2 * SPIRAL_MAX_DISTANCE + 3) * (2 * SPIRAL_MAX_DISTANCE + 3))
+struct TSpiralOffset {
+	int OffsetX;
+	int OffsetY;
+	int Distance;
+};
+
+static TSpiralOffset SpiralOffset[SPIRAL_MAX_OFFSETS];
+static int SpiralOffsets;
+static int SpiralOffsetsUpTo[SPIRAL_MAX_DISTANCE + 1];
+
+static void InitSpiralOffsets(void){
 	int OffsetX = 0;
 	int OffsetY = 0;
 	int CurrentDistance = 0;
 	int CurrentDirection = DIRECTION_EAST;
-	while(CurrentDistance <= Distance){
-		int FieldX = *x + OffsetX;
-		int FieldY = *y + OffsetY;
+	SpiralOffsets = 0;
+	while(CurrentDistance <= SPIRAL_MAX_DISTANCE){
+		ASSERT(SpiralOffsets < SPIRAL_MAX_OFFSETS);
+		SpiralOffset[SpiralOffsets].OffsetX = OffsetX;
+		SpiralOffset[SpiralOffsets].OffsetY = OffsetY;
+		SpiralOffset[SpiralOffsets].Distance = CurrentDistance;
+		SpiralOffsets += 1;
+		SpiralOffsetsUpTo[CurrentDistance] = SpiralOffsets;
+
+		if(CurrentDirection == DIRECTION_NORTH){
+			OffsetY -= 1;
+			if(OffsetY <= -CurrentDistance){
+				CurrentDirection = DIRECTION_WEST;
+			}
+		}else if(CurrentDirection == DIRECTION_WEST){
+			OffsetX -= 1;
+			if(OffsetX <= -CurrentDistance){
+				CurrentDirection = DIRECTION_SOUTH;
+			}
+		}else if(CurrentDirection == DIRECTION_SOUTH){
+			OffsetY += 1;
+			if(OffsetY >= CurrentDistance){
+				CurrentDirection = DIRECTION_EAST;
+			}
+		}else{
+			ASSERT(CurrentDirection == DIRECTION_EAST);
+			OffsetX += 1;
+			if(OffsetX > CurrentDistance){
+				CurrentDistance = OffsetX;
+				CurrentDirection = DIRECTION_NORTH;
+			}
+		}
+	}
+}
+
+static int GetSpiralOffsets(int Distance){
+	if(Distance > SPIRAL_MAX_DISTANCE){
+		error("GetSpiralOffsets: Distance %d is too large (maximum %d).\n",
+				Distance, SPIRAL_MAX_DISTANCE);
+		Distance = SPIRAL_MAX_DISTANCE;
+	}
+
+	if(Distance < 0){
+		return 0;
+	}
+
+	return SpiralOffsetsUpTo[Distance];
+}
+
+bool SearchFreeField(int *x, int *y, int *z, int Distance, uint16 HouseID, bool Jump){
+	int Count = GetSpiralOffsets(Distance);
+	for(int Index = 0; Index < Count; Index += 1){
+		int FieldX = *x + SpiralOffset[Index].OffsetX;
+		int FieldY = *y + SpiralOffset[Index].OffsetY;
 		int FieldZ = *z;
+		if(FieldStaticallyImpossible(FieldX, FieldY, FieldZ)){
+			continue;
+		}
 
 		// TODO(fusion): This is probably some form of the `TCreature::MovePossible`
 		// function inlined.
@@ -792,34 +969,6 @@ bool SearchFreeField(int *x, int *y, int *z, int Distance, uint16 HouseID, bool
 			}
 		}
 
-
-		// NOTE(fusion): We're spiraling out from the initial coordinate.
-		// TODO(fusion): This function used directions different from the ones
-		// used by creatures and defined in `enums.hh` so I made it use them
-		// instead, LOL.
-		if(CurrentDirection == DIRECTION_NORTH){
-			OffsetY -= 1;
-			if(OffsetY <= -CurrentDistance){
-				CurrentDirection = DIRECTION_WEST;
-			}
-		}else if(CurrentDirection == DIRECTION_WEST){
-			OffsetX -= 1;
-			if(OffsetX <= -CurrentDistance){
-				CurrentDirection = DIRECTION_SOUTH;
-			}
-		}else if(CurrentDirection == DIRECTION_SOUTH){
-			OffsetY += 1;
-			if(OffsetY >= CurrentDistance){
-				CurrentDirection = DIRECTION_EAST;
-			}
-		}else{
-			ASSERT(CurrentDirection == DIRECTION_EAST);
-			OffsetX += 1;
-			if(OffsetX > CurrentDistance){
-				CurrentDistance = OffsetX;
-				CurrentDirection = DIRECTION_NORTH;
-			}
-		}
 	}
 
 	return false;
@@ -872,50 +1021,63 @@ bool SearchLoginField(int *x, int *y, int *z, int Distance, bool Player){
 		return true;
 	}
 
-	int OffsetX = 0;
-	int OffsetY = 0;
-	int CurrentDistance = 0;
-	int CurrentDirection = DIRECTION_EAST;
-	while(CurrentDistance <= Distance){
-		int FieldX = *x + OffsetX;
-		int FieldY = *y + OffsetY;
+	int Count = GetSpiralOffsets(Distance);
+	for(int Index = 0; Index < Count; Index += 1){
+		int FieldX = *x + SpiralOffset[Index].OffsetX;
+		int FieldY = *y + SpiralOffset[Index].OffsetY;
 		int FieldZ = *z;
+		if(FieldStaticallyImpossible(FieldX, FieldY, FieldZ)){
+			continue;
+		}
 
 		if(LoginPossible(FieldX, FieldY, FieldZ, HouseID, Player)){
 			*x = FieldX;
 			*y = FieldY;
 			return true;
 		}
+	}
+	return false;
+}
 
-		// NOTE(fusion): Same as `SearchFreeField`.
-		if(CurrentDirection == DIRECTION_NORTH){
-			OffsetY -= 1;
-			if(OffsetY <= -CurrentDistance){
-				CurrentDirection = DIRECTION_WEST;
-			}
-		}else if(CurrentDirection == DIRECTION_WEST){
-			OffsetX -= 1;
-			if(OffsetX <= -CurrentDistance){
-				CurrentDirection = DIRECTION_SOUTH;
-			}
-		}else if(CurrentDirection == DIRECTION_SOUTH){
-			OffsetY += 1;
-			if(OffsetY >= CurrentDistance){
-				CurrentDirection = DIRECTION_EAST;
-			}
-		}else{
-			ASSERT(CurrentDirection == DIRECTION_EAST);
-			OffsetX += 1;
-			if(OffsetX > CurrentDistance){
-				CurrentDistance = OffsetX;
-				CurrentDirection = DIRECTION_NORTH;
-			}
-		}
+static int SpawnCandidateBit(int OffsetX, int OffsetY){
+	return (OffsetY + SPAWN_CANDIDATE_DISTANCE) * SPAWN_CANDIDATE_SIDE
+		+ (OffsetX + SPAWN_CANDIDATE_DISTANCE);
+}
+
+static bool SpawnFieldExcluded(int FieldX, int FieldY, int FieldZ, uint16 HouseID, bool Player){
+	if(IsHouse(FieldX, FieldY, FieldZ) && (HouseID == 0 || GetHouseID(FieldX, FieldY, FieldZ) != HouseID)){
+		return true;
+	}
+
+	if(!Player && IsProtectionZone(FieldX, FieldY, FieldZ)){
+		return true;
 	}
+
 	return false;
 }
 
+void GetSpawnCandidates(int x, int y, int z, bool Player, TSpawnCandidates *Candidates){
+	uint16 HouseID = GetHouseID(x, y, z);
+	memset(Candidates, 0, sizeof(TSpawnCandidates));
+	for(int OffsetY = -SPAWN_CANDIDATE_DISTANCE; OffsetY <= SPAWN_CANDIDATE_DISTANCE; OffsetY += 1)
+	for(int OffsetX = -SPAWN_CANDIDATE_DISTANCE; OffsetX <= SPAWN_CANDIDATE_DISTANCE; OffsetX += 1){
+		int FieldX = x + OffsetX;
+		int FieldY = y + OffsetY;
+		if(!SpawnFieldExcluded(FieldX, FieldY, z, HouseID, Player)
+				&& GetFirstObject(FieldX, FieldY, z) != NONE){
+			int Bit = SpawnCandidateBit(OffsetX, OffsetY);
+			Candidates->Mask[Bit / 8] |= (uint8)(1 << (Bit % 8));
+			Candidates->Count += 1;
+		}
+	}
+}
+
 bool SearchSpawnField(int *x, int *y, int *z, int Distance, bool Player){
+	return SearchSpawnField(x, y, z, Distance, Player, NULL);
+}
+
+bool SearchSpawnField(int *x, int *y, int *z, int Distance, bool Player,
+		const TSpawnCandidates *Candidates){
 	// TODO(fusion): It seems `Distance` can be a negative number to do some
 	// extended search?
 	bool Minimize = true;
@@ -924,6 +1086,16 @@ bool SearchSpawnField(int *x, int *y, int *z, int Distance, bool Player){
 		Distance = -Distance;
 	}
 
+	// NOTE(fusion): Candidates only cover a limited distance, and they must
+	// have been computed for the same spawn point and `Player` flag. They are
+	// only a prefilter since houses and protection zones may have changed since
+	// they were computed, so the remaining fields are still checked.
+	if(Candidates != NULL && Distance > SPAWN_CANDIDATE_DISTANCE){
+		Candidates = NULL;
+	}
+
+	// NOTE(fusion): This is a flood fill through passable fields, whose order
+	// depends on the map, so it can't use the spiral offsets.
 	uint16 HouseID = GetHouseID(*x, *y, *z);
 	matrix<int> Map(-Distance, Distance, -Distance, Distance, INT_MAX);
 	*Map.at(0, 0) = 0;
@@ -944,11 +1116,14 @@ bool SearchSpawnField(int *x, int *y, int *z, int Distance, bool Player){
 			int FieldX = *x + OffsetX;
 			int FieldY = *y + OffsetY;
 			int FieldZ = *z;
-			if(IsHouse(FieldX, FieldY, FieldZ) && (HouseID == 0 || GetHouseID(FieldX, FieldY, FieldZ) != HouseID)){
-				continue;
+			if(Candidates != NULL){
+				int Bit = SpawnCandidateBit(OffsetX, OffsetY);
+				if((Candidates->Mask[Bit / 8] & (1 << (Bit % 8))) == 0){
+					continue;
+				}
 			}
 
-			if(!Player && IsProtectionZone(FieldX, FieldY, FieldZ)){
+			if(SpawnFieldExcluded(FieldX, FieldY, FieldZ, HouseID, Player)){
 				continue;
 			}
 
@@ -1062,6 +1237,8 @@ bool SearchFlightField(uint32 FugitiveID, uint32 PursuerID, int *x, int *y, int
 	Dir[5] = (Fugitive->posx >= Pursuer->posx && Fugitive->posy >= Pursuer->posy) ? DIRECTION_SOUTHEAST : DIRECTION_NONE;
 	Dir[6] = (Fugitive->posx >= Pursuer->posx && Fugitive->posy <= Pursuer->posy) ? DIRECTION_NORTHEAST : DIRECTION_NONE;
 	Dir[7] = (Fugitive->posx <= Pursuer->posx && Fugitive->posy <= Pursuer->posy) ? DIRECTION_NORTHWEST : DIRECTION_NONE;
+	// NOTE(fusion): Only the eight neighbors are considered, straight ones
+	// first and each group in random order, so the spiral offsets don't apply.
 	RandomShuffle(&Dir[0], 4);
 	RandomShuffle(&Dir[4], 4);
 	for(int i = 0; i < NARRAY(Dir); i += 1){
@@ -1087,7 +1264,8 @@ bool SearchFlightField(uint32 FugitiveID, uint32 PursuerID, int *x, int *y, int
 			}
 		}
 
-		if(Fugitive->MovePossible(FieldX, FieldY, FieldZ, false, false)){
+		if(!FieldStaticallyImpossible(FieldX, FieldY, FieldZ)
+				&& Fugitive->MovePossible(FieldX, FieldY, FieldZ, false, false)){
 			*x = FieldX;
 			*y = FieldY;
 			*z = FieldZ;
@@ -1102,17 +1280,18 @@ bool SearchSummonField(int *x, int *y, int *z, int Distance){
 	int BestX = 0;
 	int BestY = 0;
 	int BestTieBreaker = -1;
-	for(int OffsetY = -Distance; OffsetY <= Distance; OffsetY += 1)
-	for(int OffsetX = -Distance; OffsetX <= Distance; OffsetX += 1){
+	int Count = GetSpiralOffsets(Distance);
+	for(int Index = 0; Index < Count; Index += 1){
 		int TieBreaker = random(0, 99);
 		if(TieBreaker <= BestTieBreaker){
 			continue;
 		}
 
-		int FieldX = *x + OffsetX;
-		int FieldY = *y + OffsetY;
+		int FieldX = *x + SpiralOffset[Index].OffsetX;
+		int FieldY = *y + SpiralOffset[Index].OffsetY;
 		int FieldZ = *z;
-		if(CoordinateFlag(FieldX, FieldY, FieldZ, BANK)
+		if(!FieldStaticallyImpossible(FieldX, FieldY, FieldZ)
+				&& CoordinateFlag(FieldX, FieldY, FieldZ, BANK)
 				&& !CoordinateFlag(FieldX, FieldY, FieldZ, UNPASS)
 				&& !CoordinateFlag(FieldX, FieldY, FieldZ, AVOID)
 				&& !IsProtectionZone(FieldX, FieldY, FieldZ)
@@ -1275,8 +1454,9 @@ int GetInventoryWeight(uint32 CreatureID){
 		return 0;
 	}
 
-	Object Help = GetFirstContainerObject(Creature->CrObject);
-	return GetRowWeight(Help);
+	// NOTE(fusion): The content weight of the creature container covers its body
+	// containers and everything inside them.
+	return GetContentWeight(Creature->CrObject);
 }
 
 bool CheckRight(uint32 CharacterID, RIGHT Right){
@@ -1410,7 +1590,7 @@ const char *GetBanishmentReason(int Reason){
 }
 
 void InitInfo(void){
-	// no-op
+	InitSpiralOffsets();
 }
 
 void ExitInfo(void){
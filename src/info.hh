@@ -31,13 +31,32 @@ int CountObjects(Object Obj, ObjectType Type, uint32 Value);
 int CountInventoryObjects(uint32 CreatureID, ObjectType Type, uint32 Value);
 int CountMoney(Object Obj);
 int CountInventoryMoney(uint32 CreatureID);
+uint32 GetInventoryIndexValue(ObjectType Type, uint32 Value);
+void AddInventoryIndex(uint32 CreatureID, Object Obj, bool Recurse);
+void RemoveInventoryIndex(uint32 CreatureID, Object Obj, bool Recurse);
+void RebuildInventoryIndex(uint32 CreatureID);
 void CalculateChange(int Amount, int *Gold, int *Platinum, int *Crystal);
 int GetHeight(int x, int y, int z);
 bool JumpPossible(int x, int y, int z, bool AvoidPlayers);
 bool FieldPossible(int x, int y, int z, int FieldType);
 bool SearchFreeField(int *x, int *y, int *z, int Distance, uint16 HouseID, bool Jump);
 bool SearchLoginField(int *x, int *y, int *z, int Distance, bool Player);
+
+// NOTE(fusion): Fields around a spawn point that `SearchSpawnField` may consider
+// at all, regardless of what's currently on them. Houses, protection zones and
+// the extent of the map don't change at runtime so these can be computed once
+// and used to skip the same lookups for every field of every search.
+#define SPAWN_CANDIDATE_DISTANCE 10
+#define SPAWN_CANDIDATE_SIDE (2 * SPAWN_CANDIDATE_DISTANCE + 1)
+struct TSpawnCandidates {
+	int Count;
+	uint8 Mask[(SPAWN_CANDIDATE_SIDE * SPAWN_CANDIDATE_SIDE + 7) / 8];
+};
+
+void GetSpawnCandidates(int x, int y, int z, bool Player, TSpawnCandidates *Candidates);
 bool SearchSpawnField(int *x, int *y, int *z, int Distance, bool Player);
+bool SearchSpawnField(int *x, int *y, int *z, int Distance, bool Player,
+		const TSpawnCandidates *Candidates);
 bool SearchFlightField(uint32 FugitiveID, uint32 PursuerID, int *x, int *y, int *z);
 bool SearchSummonField(int *x, int *y, int *z, int Distance);
 bool ThrowPossible(int OrigX, int OrigY, int OrigZ,
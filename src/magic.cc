@@ -2777,7 +2777,7 @@ void GetQuestValue(TCreature *Actor, const char *Param){
 
 	if(CheckRight(Actor->ID, CHANGE_SKILLS)){
 		int QuestNumber = atoi(Param);
-		if(QuestNumber >= 0 && QuestNumber < NARRAY(TPlayer::QuestValues)){
+		if(QuestNumber >= 0 && QuestNumber < MAX_QUESTS){
 			SendMessage(Actor->Connection, TALK_INFO_MESSAGE, "Quest value %d is %d.",
 					QuestNumber, ((TPlayer*)Actor)->GetQuestValue(QuestNumber));
 		}else{
@@ -2810,7 +2810,7 @@ void SetQuestValue(TCreature *Actor, const char *Param1, const char *Param2){
 	if(CheckRight(Actor->ID, CHANGE_SKILLS)){
 		int QuestNumber = atoi(Param1);
 		int QuestValue = atoi(Param2);
-		if(QuestNumber >= 0 && QuestNumber < NARRAY(TPlayer::QuestValues)){
+		if(QuestNumber >= 0 && QuestNumber < MAX_QUESTS){
 			SendMessage(Actor->Connection, TALK_INFO_MESSAGE,
 					"Quest value %d set to %d.", QuestNumber, QuestValue);
 		}else{
@@ -2831,11 +2831,7 @@ void ClearQuestValues(TCreature *Actor){
 	}
 
 	if(CheckRight(Actor->ID, CHANGE_SKILLS)){
-		for(int QuestNumber = 0;
-				QuestNumber < NARRAY(TPlayer::QuestValues);
-				QuestNumber += 1){
-			((TPlayer*)Actor)->SetQuestValue(QuestNumber, 0);
-		}
+		((TPlayer*)Actor)->QuestValues.clear();
 		SendMessage(Actor->Connection, TALK_INFO_MESSAGE, "All quest values deleted.");
 	}
 }
@@ -257,6 +257,7 @@ static void InitAll(void){
 		InitWriter();
 		InitReader();
 		InitObjects();
+		InitOrigMapIndex();
 		InitMap();
 		InitInfo();
 		InitMoveUse();
@@ -265,6 +266,7 @@ static void InitAll(void){
 		InitHouses();
 		InitTime();
 		ApplyPatches();
+		RefreshMonsterhomeCandidates(0, 0, -1);
 	}catch(const char *str){
 		error("Initialization error: %s\n", str);
 		exit(EXIT_FAILURE);
@@ -347,10 +349,14 @@ static void AdvanceGame(int Delay){
 		ProcessMonsterhomes();
 		ProcessMonsterRaids();
 		ProcessCommunicationControl();
-		ProcessReaderThreadReplies(RefreshSector, SendMails);
+		ProcessReaderThreadReplies(RefreshSector, RefreshMapSector, SendMails);
 		ProcessWriterThreadReplies();
 		ProcessCommand();
 
+		if(RoundNr % (PLAYERDATA_SAVE_INTERVAL / PLAYERDATA_SAVE_STEPS) == 0){
+			SavePlayerDataOrder();
+		}
+
 		// TODO(fusion): Shouldn't we be checking both brightness and color?
 		int Brightness, Color;
 		GetAmbiente(&Brightness, &Color);
@@ -377,11 +383,18 @@ static void AdvanceGame(int Delay){
 			if(Minute % 5 == 0){
 				CreatePlayerList(true);
 			}
-			if(Minute % 15 == 0){
-				SavePlayerDataOrder();
-			}
 			if(Minute == 0){
 				NetLoadSummary();
+				ReaderLatencySummary();
+				PathfindingSummary();
+				CreatureTableSummary();
+				MonsterActivitySummary();
+				SkillTimerSummary();
+				MonsterhomeSummary();
+				NpcReactionSummary();
+				TargetCacheSummary();
+				PlayerPoolSummary();
+				DepotSummary();
 			}
 			if(Minute == 55){
 				WriteKillStatistics();
@@ -392,6 +405,7 @@ static void AdvanceGame(int Delay){
 				if(Reboot){
 					BroadcastMessage(TALK_ADMIN_MESSAGE,
 						"Server is saving game in 5 minutes.\nPlease come back in 10 minutes.");
+					StartRefreshMap();
 				}else{
 					BroadcastMessage(TALK_ADMIN_MESSAGE,
 						"Server is going down in 5 minutes.\nPlease log out.");
@@ -430,6 +444,13 @@ static void AdvanceGame(int Delay){
 		CleanupDynamicStrings();
 	}
 
+	// NOTE(fusion): Map data arrives faster than the regular once per second
+	// reply processing would handle during a map refresh.
+	if(RefreshMapActive()){
+		ProcessReaderThreadReplies(RefreshSector, RefreshMapSector, SendMails);
+		ProcessRefreshMap();
+	}
+
 	if(Delay > Beat){
 		Log("lag", "Delay %d msec.\n", Delay);
 	}
@@ -522,6 +543,32 @@ static bool DaemonInit(bool NoFork){
 	return false;
 }
 
+static int ConvertPlayers(const char *Format){
+	bool Binary;
+	if(strcmp(Format, "binary") == 0){
+		Binary = true;
+	}else if(strcmp(Format, "text") == 0){
+		Binary = false;
+	}else{
+		error("ConvertPlayers: Unknown format \"%s\".\n", Format);
+		return EXIT_FAILURE;
+	}
+
+	// NOTE(fusion): Object types are needed to translate object scripts from
+	// and into their binary representation, nothing else has to be running.
+	try{
+		ReadConfig();
+		InitObjects();
+		ConvertPlayerData(Binary);
+		ExitObjects();
+	}catch(const char *str){
+		error("ConvertPlayers: %s\n", str);
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
+
 int main(int argc, char **argv){
 	bool NoFork = false;
 	BeADaemon = false;
@@ -532,6 +579,12 @@ int main(int argc, char **argv){
 			BeADaemon = true;
 		}else if(strcmp(argv[i], "nofork") == 0){
 			NoFork = true;
+		}else if(strcmp(argv[i], "convertplayers") == 0){
+			if((i + 1) >= argc){
+				error("main: Missing format for convertplayers.\n");
+				return EXIT_FAILURE;
+			}
+			return ConvertPlayers(argv[i + 1]);
 		}
 	}
 
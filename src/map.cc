@@ -22,9 +22,24 @@ int VeteranStartPositionY;
 int VeteranStartPositionZ;
 
 static int OBCount;
-static matrix3d<TSector*> *Sector;
+static int OBMaxCount;
+static bool OBReleaseEmpty;
+static TSectorPage **SectorPage;
+static int SectorPageXMin;
+static int SectorPageYMin;
+static int SectorPageDX;
+static int SectorPageDY;
+static int SectorPageDZ;
+static int SectorPages;
+static vector<TSector*> SectorList(0, 1023, 1024);
+static int Sectors;
+static bool SectorListSorted;
 static TObjectBlock **ObjectBlock;
-static TObject *FirstFreeObject;
+static TObject **ObjectBlockFree;
+static int *ObjectBlockUsed;
+static int *ObjectBlockOrder;
+static int ObjectBlocks;
+static int CurrentObjectBlock;
 static TObject **HashTableData;
 static uint8 *HashTableType;
 static uint32 HashTableSize;
@@ -44,6 +59,37 @@ static TDynamicWriteBuffer HelpBuffer(KB(64));
 
 // Object
 // =============================================================================
+// NOTE(fusion): Returns the container whose content weight should account for
+// `Obj`, which is none for objects lying on the map or detached.
+static Object GetWeighingContainer(Object Obj){
+	Object Con = AccessObject(Obj)->Container;
+	if(Con == NONE || AccessObject(Con)->Type.isMapContainer()){
+		return NONE;
+	}
+	return Con;
+}
+
+static int GetOwnWeight(Object Obj){
+	ObjectType ObjType = AccessObject(Obj)->Type;
+	int Count = 1;
+	if(ObjType.getFlag(CUMULATIVE)){
+		Count = (int)Obj.getAttribute(AMOUNT);
+	}
+	return ObjType.getWeight(Count);
+}
+
+static void PropagateContentWeight(Object Con, int Delta){
+	while(Delta != 0 && Con != NONE){
+		TObject *Entry = AccessObject(Con);
+		if(Entry->Type.isMapContainer()){
+			break;
+		}
+
+		Entry->ContentWeight += Delta;
+		Con = Entry->Container;
+	}
+}
+
 bool Object::exists(void){
 	if(*this == NONE){
 		return false;
@@ -63,7 +109,15 @@ ObjectType Object::getObjectType(void){
 }
 
 void Object::setObjectType(ObjectType Type){
+	Object Con = GetWeighingContainer(*this);
+	if(Con == NONE){
+		AccessObject(*this)->Type = Type;
+		return;
+	}
+
+	int OldWeight = GetOwnWeight(*this);
 	AccessObject(*this)->Type = Type;
+	PropagateContentWeight(Con, GetOwnWeight(*this) - OldWeight);
 }
 
 Object Object::getNextObject(void){
@@ -136,7 +190,16 @@ void Object::setAttribute(INSTANCEATTRIBUTE Attribute, uint32 Value){
 		}
 	}
 
-	AccessObject(*this)->Attributes[AttributeOffset] = Value;
+	TObject *Entry = AccessObject(*this);
+	if(Attribute == AMOUNT){
+		Object Con = GetWeighingContainer(*this);
+		if(Con != NONE){
+			int OldWeight = ObjType.getWeight((int)Entry->Attributes[AttributeOffset]);
+			PropagateContentWeight(Con, ObjType.getWeight((int)Value) - OldWeight);
+		}
+	}
+
+	Entry->Attributes[AttributeOffset] = Value;
 }
 
 // Cron Management
@@ -342,6 +405,8 @@ uint32 CronStop(Object Obj){
 // =============================================================================
 static void ReadMapConfig(void){
 	OBCount = 0xA0000;
+	OBMaxCount = 0;
+	OBReleaseEmpty = false;
 	SectorXMin = 1000;
 	SectorXMax = 1015;
 	SectorYMin = 1000;
@@ -392,6 +457,10 @@ static void ReadMapConfig(void){
 			HashTableSize = (uint32)Script.readNumber();
 		}else if(strcmp(Identifier, "cachesize") == 0){
 			OBCount = Script.readNumber();
+		}else if(strcmp(Identifier, "maxcachesize") == 0){
+			OBMaxCount = Script.readNumber();
+		}else if(strcmp(Identifier, "releasecache") == 0){
+			OBReleaseEmpty = (Script.readNumber() != 0);
 		}else if(strcmp(Identifier, "depot") == 0){
 			int DepotIndex = 0;
 			TDepotInfo TempInfo = {};
@@ -490,6 +559,22 @@ static void ReadMapConfig(void){
 
 	OBCount /= 32768;
 
+	// NOTE(fusion): `MaxCacheSize` is the ceiling up to which the object store
+	// may grow on demand, before having to swap sectors out. It defaults to
+	// `CacheSize` which disables growth entirely.
+	if(OBMaxCount == 0){
+		OBMaxCount = OBCount * 32768;
+	}
+
+	if(OBMaxCount % 32768 != 0){
+		throw "MaxCacheSize must be a multiple of 32768";
+	}
+
+	OBMaxCount /= 32768;
+	if(OBMaxCount < OBCount){
+		throw "MaxCacheSize is smaller than CacheSize";
+	}
+
 	if(HashTableSize <= 0){
 		throw "illegal value for Objects";
 	}
@@ -568,13 +653,124 @@ static void ResizeHashTable(void){
 	HashTableFree += (NewSize - OldSize);
 }
 
-static TObject *GetFreeObjectSlot(void){
-	if(FirstFreeObject == NULL){
-		SwapSector();
+// NOTE(fusion): Object blocks are allocated on demand, up to `OBMaxCount`, and
+// each one keeps its own free list so that objects from the same sector may be
+// allocated close to each other. The first `OBCount` blocks are allocated at
+// startup and never released. Additional blocks are released once they become
+// empty, if `OBReleaseEmpty` is set.
+static void LinkObjectBlock(int Block){
+	constexpr int ObjectsPerBlock = NARRAY(TObjectBlock::Object);
+	ASSERT(Block >= 0 && Block < OBMaxCount && ObjectBlock[Block] != NULL);
+	for(int i = 0; i < (ObjectsPerBlock - 1); i += 1){
+		*((TObject**)&ObjectBlock[Block]->Object[i]) = &ObjectBlock[Block]->Object[i + 1];
 	}
+	*((TObject**)&ObjectBlock[Block]->Object[ObjectsPerBlock - 1]) = NULL;
+	ObjectBlockFree[Block] = &ObjectBlock[Block]->Object[0];
+	ObjectBlockUsed[Block] = 0;
+}
 
-	TObject *Entry = FirstFreeObject;
-	if(Entry == NULL){
+static int AllocateObjectBlock(void){
+	if(ObjectBlocks >= OBMaxCount){
+		return -1;
+	}
+
+	int Block = 0;
+	while(Block < OBMaxCount && ObjectBlock[Block] != NULL){
+		Block += 1;
+	}
+	ASSERT(Block < OBMaxCount);
+
+	ObjectBlock[Block] = (TObjectBlock*)malloc(sizeof(TObjectBlock));
+	if(ObjectBlock[Block] == NULL){
+		error("AllocateObjectBlock: Cannot allocate object block.\n");
+		return -1;
+	}
+
+	LinkObjectBlock(Block);
+
+	// NOTE(fusion): Keep `ObjectBlockOrder` sorted by block address so we can
+	// find the block of any object with a binary search.
+	int Position = ObjectBlocks;
+	while(Position > 0 && ObjectBlock[ObjectBlockOrder[Position - 1]] > ObjectBlock[Block]){
+		ObjectBlockOrder[Position] = ObjectBlockOrder[Position - 1];
+		Position -= 1;
+	}
+	ObjectBlockOrder[Position] = Block;
+	ObjectBlocks += 1;
+
+	if(ObjectBlocks > OBCount){
+		print(2, "Object store grown to %d blocks.\n", ObjectBlocks);
+	}
+	SetObjectBlocks(ObjectBlocks);
+	return Block;
+}
+
+static void ReleaseObjectBlock(int Block){
+	ASSERT(Block >= 0 && Block < OBMaxCount && ObjectBlock[Block] != NULL);
+	ASSERT(ObjectBlockUsed[Block] == 0);
+
+	int Position = 0;
+	while(ObjectBlockOrder[Position] != Block){
+		Position += 1;
+	}
+
+	ObjectBlocks -= 1;
+	while(Position < ObjectBlocks){
+		ObjectBlockOrder[Position] = ObjectBlockOrder[Position + 1];
+		Position += 1;
+	}
+
+	free(ObjectBlock[Block]);
+	ObjectBlock[Block] = NULL;
+	ObjectBlockFree[Block] = NULL;
+	print(2, "Object store shrunk to %d blocks.\n", ObjectBlocks);
+	SetObjectBlocks(ObjectBlocks);
+}
+
+static int GetObjectBlock(TObject *Entry){
+	int Min = 0;
+	int Max = ObjectBlocks - 1;
+	while(Min <= Max){
+		int Mid = (Min + Max) / 2;
+		int Block = ObjectBlockOrder[Mid];
+		TObject *First = &ObjectBlock[Block]->Object[0];
+		if(Entry < First){
+			Max = Mid - 1;
+		}else if(Entry >= (First + NARRAY(TObjectBlock::Object))){
+			Min = Mid + 1;
+		}else{
+			return Block;
+		}
+	}
+	return -1;
+}
+
+static int FindFreeObjectBlock(void){
+	for(int i = 0; i < OBMaxCount; i += 1){
+		int Block = (CurrentObjectBlock + i) % OBMaxCount;
+		if(ObjectBlockFree[Block] != NULL){
+			CurrentObjectBlock = Block;
+			return Block;
+		}
+	}
+
+	int Block = AllocateObjectBlock();
+	if(Block != -1){
+		CurrentObjectBlock = Block;
+	}
+	return Block;
+}
+
+static TObject *GetFreeObjectSlot(int Block){
+	if(Block < 0 || Block >= OBMaxCount || ObjectBlockFree[Block] == NULL){
+		Block = FindFreeObjectBlock();
+		if(Block == -1){
+			SwapSector();
+			Block = FindFreeObjectBlock();
+		}
+	}
+
+	if(Block == -1){
 		error("GetFreeObjectSlot: No free space left.\n");
 		return NULL;
 	}
@@ -582,7 +778,9 @@ static TObject *GetFreeObjectSlot(void){
 	// NOTE(fusion): The next object pointer was originally stored in `Entry->NextObject.ObjectID`
 	// which is a problem when compiling in 64 bits mode. For this reason, I've changed it to be
 	// stored at the beggining of `TObject`.
-	FirstFreeObject = *((TObject**)Entry);
+	TObject *Entry = ObjectBlockFree[Block];
+	ObjectBlockFree[Block] = *((TObject**)Entry);
+	ObjectBlockUsed[Block] += 1;
 
 	// TODO(fusion): Using `memset` here will trigger a compiler warning because `TObject` contains
 	// a few `Object`s and I've made them non PODs by adding a few constructors.
@@ -598,9 +796,238 @@ static void PutFreeObjectSlot(TObject *Entry){
 		return;
 	}
 
+	int Block = GetObjectBlock(Entry);
+	if(Block == -1){
+		error("PutFreeObjectSlot: Entry doesn't belong to any object block.\n");
+		return;
+	}
+
 	// NOTE(fusion): See note in `GetFreeObjectSlot`, just above.
-	*((TObject**)Entry) = FirstFreeObject;
-	FirstFreeObject = Entry;
+	*((TObject**)Entry) = ObjectBlockFree[Block];
+	ObjectBlockFree[Block] = Entry;
+	ObjectBlockUsed[Block] -= 1;
+	if(ObjectBlockUsed[Block] == 0 && OBReleaseEmpty && Block >= OBCount){
+		ReleaseObjectBlock(Block);
+	}
+}
+
+// Sector Directory
+// =============================================================================
+static TSector **GetSectorSlot(int SectorX, int SectorY, int SectorZ, bool Create){
+	if(SectorX < SectorXMin || SectorXMax < SectorX
+			|| SectorY < SectorYMin || SectorYMax < SectorY
+			|| SectorZ < SectorZMin || SectorZMax < SectorZ){
+		return NULL;
+	}
+
+	ASSERT(SectorPage != NULL);
+	int PageX = SectorX / SECTOR_PAGE_SIZE - SectorPageXMin;
+	int PageY = SectorY / SECTOR_PAGE_SIZE - SectorPageYMin;
+	int PageZ = SectorZ - SectorZMin;
+	TSectorPage **Page = &SectorPage[(PageZ * SectorPageDY + PageY) * SectorPageDX + PageX];
+	if(*Page == NULL){
+		if(!Create){
+			return NULL;
+		}
+
+		*Page = (TSectorPage*)calloc(1, sizeof(TSectorPage));
+		SectorPages += 1;
+	}
+
+	return &(*Page)->Sector[SectorX % SECTOR_PAGE_SIZE][SectorY % SECTOR_PAGE_SIZE];
+}
+
+static TSector *FindSector(int SectorX, int SectorY, int SectorZ){
+	TSector **Slot = GetSectorSlot(SectorX, SectorY, SectorZ, false);
+	return Slot != NULL ? *Slot : NULL;
+}
+
+static bool SectorListLess(const TSector *A, const TSector *B){
+	if(A->SectorY != B->SectorY){
+		return A->SectorY < B->SectorY;
+	}else if(A->SectorX != B->SectorX){
+		return A->SectorX < B->SectorX;
+	}else{
+		return A->SectorZ < B->SectorZ;
+	}
+}
+
+static TSector *GetSectorListEntry(int Index){
+	if(Index < 0 || Index >= Sectors){
+		error("GetSectorListEntry: Invalid index %d.\n", Index);
+		return NULL;
+	}
+
+	// NOTE(fusion): Sectors are appended when created and only sorted when we
+	// actually iterate over them, to avoid sorting the list over and over while
+	// loading the map.
+	if(!SectorListSorted){
+		TSector **First = SectorList.at(0);
+		std::sort(First, First + Sectors, SectorListLess);
+		SectorListSorted = true;
+	}
+
+	return *SectorList.at(Index);
+}
+
+int GetSectorCount(void){
+	return Sectors;
+}
+
+void GetSectorCoordinates(int Index, int *SectorX, int *SectorY, int *SectorZ){
+	TSector *Entry = GetSectorListEntry(Index);
+	if(Entry == NULL){
+		*SectorX = 0;
+		*SectorY = 0;
+		*SectorZ = 0;
+		return;
+	}
+
+	*SectorX = Entry->SectorX;
+	*SectorY = Entry->SectorY;
+	*SectorZ = (int)Entry->SectorZ;
+}
+
+uint8 GetSectorFlags(int Index){
+	TSector *Entry = GetSectorListEntry(Index);
+	if(Entry == NULL){
+		return 0;
+	}
+
+	return Entry->MapFlags;
+}
+
+uint32 GetSectorRevision(int SectorX, int SectorY, int SectorZ){
+	TSector *Sec = FindSector(SectorX, SectorY, SectorZ);
+	if(Sec == NULL){
+		return 0;
+	}
+
+	return Sec->Revision;
+}
+
+bool SectorLoaded(int SectorX, int SectorY, int SectorZ){
+	TSector *Sec = FindSector(SectorX, SectorY, SectorZ);
+	return Sec != NULL && Sec->Status == STATUS_LOADED;
+}
+
+static bool AffectsStaticField(ObjectType Type){
+	return Type.getFlag(BANK) || Type.getFlag(UNPASS);
+}
+
+// NOTE(fusion): `Static` tells whether the change may affect
+// `FieldStaticallyImpossible`, in which case the sector's static revision is
+// also bumped.
+static void TouchMapContainer(Object Con, Object Obj, bool Static){
+	if(Con == NONE || !Con.getObjectType().isMapContainer()
+			|| Obj.getObjectType().isCreatureContainer()){
+		return;
+	}
+
+	int CoordX, CoordY, CoordZ;
+	GetObjectCoordinates(Con, &CoordX, &CoordY, &CoordZ);
+	TSector *Sec = FindSector(CoordX / 32, CoordY / 32, CoordZ);
+	if(Sec != NULL){
+		Sec->Revision += 1;
+		if(Static){
+			Sec->StaticRevision += 1;
+		}
+	}
+}
+
+// NOTE(fusion): A field without any ground, or with something that is both
+// unpassable and unmovable, can't be entered by anything and won't change until
+// a bank or unpassable object is added to or removed from it, so the field
+// searches in `info.cc` may skip it right away. These are cached per sector, as
+// a bit per field, in a small direct mapped cache indexed by the low bits of
+// all three sector coordinates, and recomputed whenever the sector's static
+// revision no longer matches. Creatures and other objects don't affect it.
+#define STATIC_FIELD_CACHE_SIZE 1024
+struct TStaticFieldEntry {
+	int SectorX;
+	int SectorY;
+	int SectorZ;
+	uint32 Revision;
+	bool Valid;
+	uint32 Impossible[32];
+};
+
+static TStaticFieldEntry StaticFieldEntry[STATIC_FIELD_CACHE_SIZE];
+
+static bool ComputeFieldImpossible(Object Obj){
+	bool HasBank = false;
+	while(Obj != NONE){
+		ObjectType ObjType = Obj.getObjectType();
+		if(!ObjType.isCreatureContainer()){
+			if(ObjType.getFlag(BANK)){
+				HasBank = true;
+			}
+
+			if(ObjType.getFlag(UNPASS) && ObjType.getFlag(UNMOVE)){
+				return true;
+			}
+		}
+		Obj = Obj.getNextObject();
+	}
+	return !HasBank;
+}
+
+bool FieldStaticallyImpossible(int x, int y, int z){
+	// NOTE(fusion): Returning false only means the field must be checked as
+	// usual, which is also what happens when the cache is disabled.
+	if(!StaticFieldCache || x < 0 || y < 0){
+		return false;
+	}
+
+	int SectorX = x / 32;
+	int SectorY = y / 32;
+	int SectorZ = z;
+	TSector *Sec = FindSector(SectorX, SectorY, SectorZ);
+	if(Sec == NULL){
+		return false;
+	}
+
+	int Slot = ((SectorX & 7) | ((SectorY & 7) << 3) | ((SectorZ & 15) << 6)) % STATIC_FIELD_CACHE_SIZE;
+	TStaticFieldEntry *Entry = &StaticFieldEntry[Slot];
+	if(!Entry->Valid || Entry->Revision != Sec->StaticRevision
+			|| Entry->SectorX != SectorX
+			|| Entry->SectorY != SectorY
+			|| Entry->SectorZ != SectorZ){
+		for(int OffsetY = 0; OffsetY < 32; OffsetY += 1){
+			uint32 Row = 0;
+			for(int OffsetX = 0; OffsetX < 32; OffsetX += 1){
+				Object First = Object(Sec->MapCon[OffsetX][OffsetY].getAttribute(CONTENT));
+				if(ComputeFieldImpossible(First)){
+					Row |= (1U << OffsetX);
+				}
+			}
+			Entry->Impossible[OffsetY] = Row;
+		}
+
+		Entry->SectorX = SectorX;
+		Entry->SectorY = SectorY;
+		Entry->SectorZ = SectorZ;
+		Entry->Revision = Sec->StaticRevision;
+		Entry->Valid = true;
+	}
+
+	return ((Entry->Impossible[y % 32] >> (x % 32)) & 1) != 0;
+}
+
+void ReportSectorMemory(void){
+	usize DirectoryBytes = (usize)SectorPageDX * SectorPageDY * SectorPageDZ * sizeof(TSectorPage*);
+	usize PageBytes = (usize)SectorPages * sizeof(TSectorPage);
+	usize SectorBytes = (usize)Sectors * sizeof(TSector);
+	usize DenseBytes = (usize)(SectorXMax - SectorXMin + 1)
+			* (usize)(SectorYMax - SectorYMin + 1)
+			* (usize)(SectorZMax - SectorZMin + 1)
+			* sizeof(TSector*);
+	print(1, "Sector directory: %d sectors in %d/%d pages.\n",
+			Sectors, SectorPages, SectorPageDX * SectorPageDY * SectorPageDZ);
+	print(1, "Sector directory: %lu KB (dense: %lu KB), sector data: %lu KB.\n",
+			(unsigned long)((DirectoryBytes + PageBytes) >> 10),
+			(unsigned long)(DenseBytes >> 10),
+			(unsigned long)(SectorBytes >> 10));
 }
 
 void SwapObject(TWriteBinaryFile *File, Object Obj, uintptr FileNumber){
@@ -645,18 +1072,14 @@ void SwapSector(void){
 	int OldestSectorZ = 0;
 	uint32 OldestTimeStamp = RoundNr + 1;
 
-	ASSERT(Sector != NULL);
-	for(int SectorZ = SectorZMin; SectorZ <= SectorZMax; SectorZ += 1)
-	for(int SectorY = SectorYMin; SectorY <= SectorYMax; SectorY += 1)
-	for(int SectorX = SectorXMin; SectorX <= SectorXMax; SectorX += 1){
-		TSector *CurrentSector = *Sector->at(SectorX, SectorY, SectorZ);
-		if(CurrentSector != NULL
-				&& CurrentSector->Status == STATUS_LOADED
+	for(int Index = 0; Index < Sectors; Index += 1){
+		TSector *CurrentSector = *SectorList.at(Index);
+		if(CurrentSector->Status == STATUS_LOADED
 				&& CurrentSector->TimeStamp < OldestTimeStamp){
 			Oldest = CurrentSector;
-			OldestSectorX = SectorX;
-			OldestSectorY = SectorY;
-			OldestSectorZ = SectorZ;
+			OldestSectorX = CurrentSector->SectorX;
+			OldestSectorY = CurrentSector->SectorY;
+			OldestSectorZ = (int)CurrentSector->SectorZ;
 			OldestTimeStamp = CurrentSector->TimeStamp;
 		}
 	}
@@ -710,8 +1133,7 @@ void UnswapSector(uintptr FileNumber){
 		int SectorZ = (int)File.readQuad();
 		print(2, "Loading sector %d/%d/%d...\n", SectorX, SectorY, SectorZ);
 
-		ASSERT(Sector != NULL);
-		TSector *LoadingSector = *Sector->at(SectorX, SectorY, SectorZ);
+		TSector *LoadingSector = FindSector(SectorX, SectorY, SectorZ);
 		if(LoadingSector == NULL){
 			error("UnswapSector: Sector %d/%d/%d does not exist.\n", SectorX, SectorY, SectorZ);
 			File.close();
@@ -735,7 +1157,7 @@ void UnswapSector(uintptr FileNumber){
 				// its status. The original code would call `readBytes` on the result
 				// from `GetFreeObjectSlot()` directly and would then leak it if the
 				// entry status was not `STATUS_SWAPPED`.
-				TObject *EntryPointer = GetFreeObjectSlot();
+				TObject *EntryPointer = GetFreeObjectSlot(LoadingSector->ObjectBlock);
 				*EntryPointer = Entry;
 				HashTableData[EntryIndex] = EntryPointer;
 				HashTableType[EntryIndex] = STATUS_LOADED;
@@ -909,17 +1331,64 @@ void LoadObjects(TReadStream *Stream, Object Con){
 	}
 }
 
+int CountObjects(TReadStream *Stream){
+	// NOTE(fusion): Walks the same format as `LoadObjects` without creating
+	// anything, so callers can tell how many objects a stored container holds.
+	int Count = 0;
+	int Depth = 1;
+	bool ProcessObjects = true;
+	while(true){
+		if(ProcessObjects){
+			int TypeID = (int)Stream->readWord();
+			if(TypeID != 0xFFFF){
+				Count += 1;
+			}else{
+				Depth -= 1;
+				if(Depth <= 0){
+					break;
+				}
+			}
+			ProcessObjects = false;
+		}else{
+			int Attribute = (int)Stream->readByte();
+			if(Attribute == 0xFF){
+				ProcessObjects = true;
+			}else if(Attribute == CONTENT){
+				Depth += 1;
+				ProcessObjects = true;
+			}else if(Attribute == TEXTSTRING || Attribute == EDITOR){
+				int Length = (int)Stream->readWord();
+				if(Length == 0xFFFF){
+					Length = (int)Stream->readQuad();
+				}
+				Stream->skip(Length);
+			}else{
+				Stream->readQuad();
+			}
+		}
+	}
+	return Count;
+}
+
+static Object CreateObject(int Block);
+
 void InitSector(int SectorX, int SectorY, int SectorZ){
-	ASSERT(Sector);
-	if(*Sector->at(SectorX, SectorY, SectorZ) != NULL){
+	TSector **Slot = GetSectorSlot(SectorX, SectorY, SectorZ, true);
+	if(Slot == NULL){
+		error("InitSector: Sector %d/%d/%d is out of bounds.\n", SectorX, SectorY, SectorZ);
+		return;
+	}
+
+	if(*Slot != NULL){
 		error("InitSector: Sector %d/%d/%d already exists.\n", SectorX, SectorY, SectorZ);
 		return;
 	}
 
 	TSector *NewSector = (TSector*)malloc(sizeof(TSector));
+	NewSector->ObjectBlock = FindFreeObjectBlock();
 	for(int X = 0; X < 32; X += 1){
 		for(int Y = 0; Y < 32; Y += 1){
-			Object MapCon = CreateObject();
+			Object MapCon = CreateObject(NewSector->ObjectBlock);
 			// NOTE(fusion): `Attributes[0]` is probably the object id of the
 			// first object in the container.
 			AccessObject(MapCon)->Attributes[1] = SectorX * 32 + X;
@@ -931,8 +1400,16 @@ void InitSector(int SectorX, int SectorY, int SectorZ){
 	NewSector->TimeStamp = RoundNr;
 	NewSector->Status = STATUS_LOADED;
 	NewSector->MapFlags = 0;
+	NewSector->SectorZ = (uint16)SectorZ;
+	NewSector->SectorX = SectorX;
+	NewSector->SectorY = SectorY;
+	NewSector->Revision = 0;
+	NewSector->StaticRevision = 0;
 
-	*Sector->at(SectorX, SectorY, SectorZ) = NewSector;
+	*Slot = NewSector;
+	*SectorList.at(Sectors) = NewSector;
+	Sectors += 1;
+	SectorListSorted = false;
 }
 
 void LoadSector(const char *FileName, int SectorX, int SectorY, int SectorZ){
@@ -944,8 +1421,7 @@ void LoadSector(const char *FileName, int SectorX, int SectorY, int SectorZ){
 
 	InitSector(SectorX, SectorY, SectorZ);
 
-	ASSERT(Sector != NULL);
-	TSector *LoadingSector = *Sector->at(SectorX, SectorY, SectorZ);
+	TSector *LoadingSector = FindSector(SectorX, SectorY, SectorZ);
 	ASSERT(LoadingSector != NULL);
 
 	TReadScriptFile Script;
@@ -1044,6 +1520,7 @@ void LoadMap(void){
 	closedir(MapDir);
 	print(1, "%d Sectors loaded.\n", SectorCounter);
 	print(1, "%d Objects loaded.\n", ObjectCounter);
+	ReportSectorMemory();
 }
 
 void SaveObjects(Object Obj, TWriteStream *Stream, bool Stop){
@@ -1190,8 +1667,7 @@ void SaveObjects(TReadStream *Stream, TWriteScriptFile *Script){
 }
 
 void SaveSector(char *FileName, int SectorX, int SectorY, int SectorZ){
-	ASSERT(Sector);
-	TSector *SavingSector = *Sector->at(SectorX, SectorY, SectorZ);
+	TSector *SavingSector = FindSector(SectorX, SectorY, SectorZ);
 	if(!SavingSector){
 		return;
 	}
@@ -1294,9 +1770,9 @@ void SaveMap(void){
 	ObjectCounter = 0;
 
 	char FileName[4096];
-	for(int SectorZ = SectorZMin; SectorZ <= SectorZMax; SectorZ += 1)
-	for(int SectorY = SectorYMin; SectorY <= SectorYMax; SectorY += 1)
-	for(int SectorX = SectorXMin; SectorX <= SectorXMax; SectorX += 1){
+	for(int Index = 0; Index < Sectors; Index += 1){
+		int SectorX, SectorY, SectorZ;
+		GetSectorCoordinates(Index, &SectorX, &SectorY, &SectorZ);
 		snprintf(FileName, sizeof(FileName), "%s/%04d-%04d-%02d.sec",
 				MAPPATH, SectorX, SectorY, SectorZ);
 		SaveSector(FileName, SectorX, SectorY, SectorZ);
@@ -1307,8 +1783,6 @@ void SaveMap(void){
 }
 
 void RefreshSector(int SectorX, int SectorY, int SectorZ, TReadStream *Stream){
-	// TODO(fusion): `matrix3d::at` will return the first entry if the coordinates
-	// are out of bounds which that is problematic, specially here.
 	if(SectorX < SectorXMin || SectorXMax < SectorX
 			|| SectorY < SectorYMin || SectorYMax < SectorY
 			|| SectorZ < SectorZMin || SectorZMax < SectorZ){
@@ -1317,8 +1791,7 @@ void RefreshSector(int SectorX, int SectorY, int SectorZ, TReadStream *Stream){
 		return;
 	}
 
-	ASSERT(Sector);
-	TSector *Sec = *Sector->at(SectorX, SectorY, SectorZ);
+	TSector *Sec = FindSector(SectorX, SectorY, SectorZ);
 	if(Sec && (Sec->MapFlags & 0x01) != 0){
 		print(3, "Refreshing sector %d/%d/%d ...\n", SectorX, SectorY, SectorZ);
 		while(!Stream->eof()){
@@ -1355,13 +1828,12 @@ void PatchSector(int SectorX, int SectorY, int SectorZ, bool FullSector,
 		return;
 	}
 
-	ASSERT(Sector);
-	TSector *Sec = *Sector->at(SectorX, SectorY, SectorZ);
+	TSector *Sec = FindSector(SectorX, SectorY, SectorZ);
 	bool NewSector = (Sec == NULL);
 	if(NewSector){
 		print(2, "Creating sector %d/%d/%d anew.\n", SectorX, SectorY, SectorZ);
 		InitSector(SectorX, SectorY, SectorZ);
-		Sec = *Sector->at(SectorX, SectorY, SectorZ);
+		Sec = FindSector(SectorX, SectorY, SectorZ);
 		ASSERT(Sec != NULL);
 	}
 
@@ -1709,33 +2181,38 @@ void PatchSector(int SectorX, int SectorY, int SectorZ, bool FullSector,
 void InitMap(void){
 	ReadMapConfig();
 
-	Sector = new matrix3d<TSector*>(SectorXMin, SectorXMax,
-			SectorYMin, SectorYMax, SectorZMin, SectorZMax, NULL);
+	// NOTE(fusion): Only the top level of the sector directory is allocated up
+	// front. See `GetSectorSlot`.
+	SectorPageXMin = SectorXMin / SECTOR_PAGE_SIZE;
+	SectorPageYMin = SectorYMin / SECTOR_PAGE_SIZE;
+	SectorPageDX = SectorXMax / SECTOR_PAGE_SIZE - SectorPageXMin + 1;
+	SectorPageDY = SectorYMax / SECTOR_PAGE_SIZE - SectorPageYMin + 1;
+	SectorPageDZ = SectorZMax - SectorZMin + 1;
+	SectorPage = (TSectorPage**)calloc((usize)SectorPageDX * SectorPageDY * SectorPageDZ,
+			sizeof(TSectorPage*));
+	SectorPages = 0;
+	Sectors = 0;
+	SectorListSorted = true;
 
 	DeleteSwappedSectors();
 
-	// NOTE(fusion): Object storage is FIXED and determined at startup.
-	ObjectBlock = (TObjectBlock**)malloc(OBCount * sizeof(TObjectBlock*));
-	for(int i = 0; i < OBCount; i += 1){
-		ObjectBlock[i] = (TObjectBlock*)malloc(sizeof(TObjectBlock));
-	}
-
-	// NOTE(fusion): Setup free object list. See note in `GetFreeObjectSlot`.
-	constexpr int ObjectsPerBlock = NARRAY(TObjectBlock::Object);
+	// NOTE(fusion): Object storage starts with `OBCount` blocks and may grow up
+	// to `OBMaxCount`. See `AllocateObjectBlock`.
+	ObjectBlock = (TObjectBlock**)calloc(OBMaxCount, sizeof(TObjectBlock*));
+	ObjectBlockFree = (TObject**)calloc(OBMaxCount, sizeof(TObject*));
+	ObjectBlockUsed = (int*)calloc(OBMaxCount, sizeof(int));
+	ObjectBlockOrder = (int*)calloc(OBMaxCount, sizeof(int));
+	ObjectBlocks = 0;
+	CurrentObjectBlock = 0;
 	for(int i = 0; i < OBCount; i += 1){
-		for(int j = 0; j < ObjectsPerBlock; j += 1){
-			*((TObject**)&ObjectBlock[i]->Object[j]) = &ObjectBlock[i]->Object[j + 1];
+		if(AllocateObjectBlock() == -1){
+			throw "cannot allocate object store";
 		}
+	}
 
-		if(i < (OBCount - 1)){
-			// NOTE(fusion): Link last entry of this block, with the first entry of the next one.
-			*((TObject**)&ObjectBlock[i]->Object[ObjectsPerBlock - 1]) = &ObjectBlock[i + 1]->Object[0];
-		}else{
-			// NOTE(fusion): End of free object list.
-			*((TObject**)&ObjectBlock[i]->Object[ObjectsPerBlock - 1]) = NULL;
-		}
+	if((uint32)OBMaxCount * NARRAY(TObjectBlock::Object) > (HashTableSize - HashTableSize / 16)){
+		print(1, "WARNING: MaxCacheSize exceeds the capacity of the object hash table.\n");
 	}
-	FirstFreeObject = &ObjectBlock[0]->Object[0];
 
 	// NOTE(fusion): Initialize object hash table.
 	ASSERT(ISPOW2(HashTableSize));
@@ -1746,7 +2223,7 @@ void InitMap(void){
 	HashTableFree = HashTableSize - 1;
 	// NOTE(fusion): This is probably reserved for `NONE`.
 	HashTableType[0] = STATUS_PERMANENT;
-	HashTableData[0] = GetFreeObjectSlot();
+	HashTableData[0] = GetFreeObjectSlot(0);
 
 	// NOTE(fusion): Initialize cron hash table (whatever that is).
 	for(int i = 0; i < NARRAY(CronHashTable); i += 1){
@@ -1765,21 +2242,32 @@ void ExitMap(bool Save){
 	free(HashTableData);
 	free(HashTableType);
 
-	for(int i = 0; i < OBCount; i += 1){
-		free(ObjectBlock[i]);
+	for(int i = 0; i < OBMaxCount; i += 1){
+		if(ObjectBlock[i] != NULL){
+			free(ObjectBlock[i]);
+		}
 	}
 	free(ObjectBlock);
+	free(ObjectBlockFree);
+	free(ObjectBlockUsed);
+	free(ObjectBlockOrder);
+	ObjectBlocks = 0;
 
-	if(Sector != NULL){
-		for(int SectorZ = SectorZMin; SectorZ <= SectorZMax; SectorZ += 1)
-		for(int SectorY = SectorYMin; SectorY <= SectorYMax; SectorY += 1)
-		for(int SectorX = SectorXMin; SectorX <= SectorXMax; SectorX += 1){
-			TSector *CurrentSector = *Sector->at(SectorX, SectorY, SectorZ);
-			if(CurrentSector != NULL){
-				free(CurrentSector);
+	for(int Index = 0; Index < Sectors; Index += 1){
+		free(*SectorList.at(Index));
+	}
+	Sectors = 0;
+
+	if(SectorPage != NULL){
+		int PageCount = SectorPageDX * SectorPageDY * SectorPageDZ;
+		for(int Index = 0; Index < PageCount; Index += 1){
+			if(SectorPage[Index] != NULL){
+				free(SectorPage[Index]);
 			}
 		}
-		delete Sector;
+		free(SectorPage);
+		SectorPage = NULL;
+		SectorPages = 0;
 	}
 
 	DeleteSwappedSectors();
@@ -1806,7 +2294,9 @@ TObject *AccessObject(Object Obj){
 	}
 }
 
-Object CreateObject(void){
+// NOTE(fusion): Same as `CreateObject` but allocating the object from the given
+// object block, if it has any free space left.
+static Object CreateObject(int Block){
 	static uint32 NextObjectID = 1;
 
 	// NOTE(fusion): Load factor of 1/16.
@@ -1824,13 +2314,14 @@ Object CreateObject(void){
 	}
 	ASSERT(HashTableType[NextObjectID & HashTableMask] == 0);
 
-	TObject *Entry = GetFreeObjectSlot();
+	TObject *Entry = GetFreeObjectSlot(Block);
 	if(Entry == NULL){
 		error("CreateObject: Cannot create object.\n");
 		return NONE;
 	}
 
 	Entry->ObjectID = NextObjectID;
+	Entry->Root = Object(NextObjectID);
 	HashTableData[NextObjectID & HashTableMask] = Entry;
 	HashTableType[NextObjectID & HashTableMask] = STATUS_LOADED;
 	HashTableFree -= 1;
@@ -1839,6 +2330,28 @@ Object CreateObject(void){
 	return Object(NextObjectID);
 }
 
+Object CreateObject(void){
+	return CreateObject(-1);
+}
+
+// NOTE(fusion): Returns the preferred object block for objects placed inside
+// `Con`, which is the object block of its sector.
+static int GetObjectBlockHint(Object Con){
+	Object MapCon = GetMapContainer(Con);
+	if(MapCon == NONE){
+		return -1;
+	}
+
+	int CoordX, CoordY, CoordZ;
+	GetObjectCoordinates(MapCon, &CoordX, &CoordY, &CoordZ);
+	TSector *Sec = FindSector(CoordX / 32, CoordY / 32, CoordZ);
+	if(Sec == NULL){
+		return -1;
+	}
+
+	return Sec->ObjectBlock;
+}
+
 static void DestroyObject(Object Obj){
 	if(!Obj.exists()){
 		error("DestroyObject: Passed object does not exist.\n");
@@ -1883,13 +2396,15 @@ static void DestroyObject(Object Obj){
 	DecrementObjectCounter();
 }
 
+static void UnlinkObject(Object Obj);
+
 void DeleteObject(Object Obj){
 	if(!Obj.exists()){
 		error("DeleteObject: Passed object does not exist.\n");
 		return;
 	}
 
-	CutObject(Obj);
+	UnlinkObject(Obj);
 	DestroyObject(Obj);
 }
 
@@ -1936,6 +2451,8 @@ void ChangeObject(Object Obj, ObjectType NewType){
 	}
 
 	Obj.setObjectType(NewType);
+	TouchMapContainer(Obj.getContainer(), Obj,
+			AffectsStaticField(OldType) || AffectsStaticField(NewType));
 
 	if(NewType.getFlag(CUMULATIVE)){
 		if(Amount <= 0){
@@ -2002,6 +2519,73 @@ int GetObjectPriority(Object Obj){
 	return ObjPriority;
 }
 
+// NOTE(fusion): Recompute the cached ancestry of `Obj` from its new container
+// `Con` and propagate it down to its contents. Moving an object around while
+// keeping the same root (e.g. a creature walking with its whole inventory) will
+// stop right at the top so only actual tree changes pay for the propagation.
+static void UpdateObjectAncestry(Object Obj, Object Con){
+	Object Root = Obj;
+	Object BodyCon = NONE;
+	uint32 Depth = 0;
+	if(Con != NONE){
+		TObject *ConEntry = AccessObject(Con);
+		if(!ConEntry->Type.isMapContainer()){
+			Root = ConEntry->Root;
+			Depth = ConEntry->Depth + 1;
+			if(ConEntry->Type.isBodyContainer()){
+				BodyCon = Con;
+			}else{
+				BodyCon = ConEntry->BodyCon;
+			}
+		}
+	}
+
+	TObject *Entry = AccessObject(Obj);
+	if(Entry->Root == Root && Entry->BodyCon == BodyCon && Entry->Depth == Depth){
+		return;
+	}
+
+	Entry->Root = Root;
+	Entry->BodyCon = BodyCon;
+	Entry->Depth = Depth;
+
+	ObjectType ObjType = Entry->Type;
+	if(ObjType.getFlag(CONTAINER) || ObjType.getFlag(CHEST)){
+		Object Inner = Object(Obj.getAttribute(CONTENT));
+		while(Inner != NONE){
+			UpdateObjectAncestry(Inner, Obj);
+			Inner = Inner.getNextObject();
+		}
+	}
+}
+
+#if ENABLE_ASSERTIONS
+// NOTE(fusion): Validate the cached ancestry against the actual container chain.
+static void CheckObjectAncestry(Object Obj){
+	Object Root = Obj;
+	Object BodyCon = NONE;
+	uint32 Depth = 0;
+	Object Con = Obj.getContainer();
+	while(Con != NONE && !Con.getObjectType().isMapContainer()){
+		if(BodyCon == NONE && Con.getObjectType().isBodyContainer()){
+			BodyCon = Con;
+		}
+		Root = Con;
+		Depth += 1;
+		Con = Con.getContainer();
+	}
+
+	TObject *Entry = AccessObject(Obj);
+	if(Entry->Type.isMapContainer()){
+		ASSERT(Entry->Depth == 0);
+	}else{
+		ASSERT(Entry->Root == Root);
+		ASSERT(Entry->BodyCon == BodyCon);
+		ASSERT(Entry->Depth == Depth);
+	}
+}
+#endif
+
 void PlaceObject(Object Obj, Object Con, bool Append){
 	if(!Obj.exists()){
 		error("PlaceObject: Passed object does not exist.\n");
@@ -2077,16 +2661,23 @@ void PlaceObject(Object Obj, Object Con, bool Append){
 	}
 	Obj.setNextObject(Cur);
 	Obj.setContainer(Con);
+	UpdateObjectAncestry(Obj, Con);
+	TouchMapContainer(Con, Obj, AffectsStaticField(Obj.getObjectType()));
+	if(!ConType.isMapContainer()){
+		PropagateContentWeight(Con, GetOwnWeight(Obj) + AccessObject(Obj)->ContentWeight);
+	}
 }
 
-// NOTE(fusion): This is the opposite of `PlaceObject`.
-void CutObject(Object Obj){
-	if(!Obj.exists()){
-		error("CutObject: Passed object does not exist.\n");
-		return;
+// NOTE(fusion): Same as `CutObject` but leaves the cached ancestry of `Obj` and
+// its contents untouched. It is used when the object is about to be placed
+// somewhere else or destroyed, in which case updating it would be wasted work.
+static void UnlinkObject(Object Obj){
+	Object Con = Obj.getContainer();
+	TouchMapContainer(Con, Obj, AffectsStaticField(Obj.getObjectType()));
+	if(GetWeighingContainer(Obj) != NONE){
+		PropagateContentWeight(Con, -(GetOwnWeight(Obj) + AccessObject(Obj)->ContentWeight));
 	}
 
-	Object Con = Obj.getContainer();
 	Object Cur = GetFirstContainerObject(Con);
 	if(Cur == Obj){
 		Object Next = Obj.getNextObject();
@@ -2104,6 +2695,17 @@ void CutObject(Object Obj){
 	Obj.setContainer(NONE);
 }
 
+// NOTE(fusion): This is the opposite of `PlaceObject`.
+void CutObject(Object Obj){
+	if(!Obj.exists()){
+		error("CutObject: Passed object does not exist.\n");
+		return;
+	}
+
+	UnlinkObject(Obj);
+	UpdateObjectAncestry(Obj, NONE);
+}
+
 void MoveObject(Object Obj, Object Con){
 	if(!Obj.exists()){
 		error("MoveObject: Passed object does not exist.\n");
@@ -2115,7 +2717,7 @@ void MoveObject(Object Obj, Object Con){
 		return;
 	}
 
-	CutObject(Obj);
+	UnlinkObject(Obj);
 	PlaceObject(Obj, Con, false);
 }
 
@@ -2125,7 +2727,7 @@ Object AppendObject(Object Con, ObjectType Type){
 		return NONE;
 	}
 
-	Object Obj = CreateObject();
+	Object Obj = CreateObject(GetObjectBlockHint(Con));
 	ChangeObject(Obj, Type);
 	PlaceObject(Obj, Con, true);
 	return Obj;
@@ -2137,7 +2739,7 @@ Object SetObject(Object Con, ObjectType Type, uint32 CreatureID){
 		return NONE;
 	}
 
-	Object Obj = CreateObject();
+	Object Obj = CreateObject(GetObjectBlockHint(Con));
 	ChangeObject(Obj, Type);
 	PlaceObject(Obj, Con, false);
 	if(Type.isCreatureContainer()){
@@ -2167,6 +2769,7 @@ Object CopyObject(Object Con, Object Source){
 	}
 
 	Object NewObj = SetObject(Con, SourceType, 0);
+	int OldWeight = GetOwnWeight(NewObj);
 	for(int i = 0; i < NARRAY(TObject::Attributes); i += 1){
 		AccessObject(NewObj)->Attributes[i] = AccessObject(Source)->Attributes[i];
 	}
@@ -2175,6 +2778,11 @@ Object CopyObject(Object Con, Object Source){
 		NewObj.setAttribute(CONTENT, NONE.ObjectID);
 	}
 
+	// NOTE(fusion): The amount was copied along with the other attributes.
+	if(GetWeighingContainer(NewObj) != NONE){
+		PropagateContentWeight(Con, GetOwnWeight(NewObj) - OldWeight);
+	}
+
 	if(SourceType.getFlag(TEXT)){
 		// NOTE(fusion): Both `NewObj` and `Source` share the same strings. We
 		// need to duplicate them so both objects can "own" and manage their own
@@ -2308,14 +2916,7 @@ Object GetMapContainer(int x, int y, int z){
 	int SectorY = y / 32;
 	int SectorZ = z;
 
-	if(SectorX < SectorXMin || SectorXMax < SectorX
-			|| SectorY < SectorYMin || SectorYMax < SectorY
-			|| SectorZ < SectorZMin || SectorZMax < SectorZ){
-		return NONE;
-	}
-
-	ASSERT(Sector != NULL);
-	TSector *ConSector = *Sector->at(SectorX, SectorY, SectorZ);
+	TSector *ConSector = FindSector(SectorX, SectorY, SectorZ);
 	if(ConSector == NULL){
 		return NONE;
 	}
@@ -2332,13 +2933,85 @@ Object GetMapContainer(Object Obj){
 		return NONE;
 	}
 
-	while(Obj != NONE){
-		if(Obj.getObjectType().isMapContainer())
-			break;
-		Obj = Obj.getContainer();
+#if ENABLE_ASSERTIONS
+	CheckObjectAncestry(Obj);
+#endif
+
+	TObject *Entry = AccessObject(Obj);
+	if(Entry->Type.isMapContainer()){
+		return Obj;
 	}
 
-	return Obj;
+	return Entry->Root.getContainer();
+}
+
+Object GetObjectRoot(Object Obj){
+	if(!Obj.exists()){
+		error("GetObjectRoot: Passed object does not exist\n");
+		return NONE;
+	}
+
+	return AccessObject(Obj)->Root;
+}
+
+Object GetObjectBodyContainer(Object Obj){
+	if(!Obj.exists()){
+		error("GetObjectBodyContainer: Passed object does not exist\n");
+		return NONE;
+	}
+
+	TObject *Entry = AccessObject(Obj);
+	if(Entry->Type.isBodyContainer()){
+		return Obj;
+	}
+
+	return Entry->BodyCon;
+}
+
+int GetObjectDepth(Object Obj){
+	if(!Obj.exists()){
+		error("GetObjectDepth: Passed object does not exist\n");
+		return 0;
+	}
+
+	return (int)AccessObject(Obj)->Depth;
+}
+
+#if ENABLE_ASSERTIONS
+// NOTE(fusion): Validate the cached content weight of `Con` and everything
+// inside it against the actual contents.
+static int CheckContentWeight(Object Con){
+	int Weight = 0;
+	ObjectType ConType = AccessObject(Con)->Type;
+	if(ConType.getFlag(CONTAINER) || ConType.getFlag(CHEST)){
+		Object Obj = Object(Con.getAttribute(CONTENT));
+		while(Obj != NONE){
+			Weight += GetOwnWeight(Obj) + CheckContentWeight(Obj);
+			Obj = Obj.getNextObject();
+		}
+	}
+
+	ASSERT(AccessObject(Con)->ContentWeight == Weight);
+	return Weight;
+}
+#endif
+
+int GetContentWeight(Object Con){
+	if(!Con.exists()){
+		error("GetContentWeight: Passed object does not exist\n");
+		return 0;
+	}
+
+	TObject *Entry = AccessObject(Con);
+	if(Entry->Type.isMapContainer()){
+		return 0;
+	}
+
+#if ENABLE_ASSERTIONS
+	CheckContentWeight(Con);
+#endif
+
+	return AccessObject(Con)->ContentWeight;
 }
 
 Object GetFirstObject(int x, int y, int z){
@@ -2380,15 +3053,15 @@ void GetObjectCoordinates(Object Obj, int *x, int *y, int *z){
 		return;
 	}
 
-	// TODO(fusion): I'm not sure I like this approach with calling `AccessObject`
-	// multiple times for the same object. Furthermore, using `Object::getObjectType`
-	// (at least until now) is very weird when we could just get the same information
-	// from the `TObject` which we'll access ANYWAYS.
+#if ENABLE_ASSERTIONS
+	CheckObjectAncestry(Obj);
+#endif
 
-	while(true){
-		if(Obj.getObjectType().isMapContainer())
-			break;
-		Obj = Obj.getContainer();
+	// NOTE(fusion): The root's container is the map container, unless the object
+	// is detached, in which case we'll end up with `NONE` and zero coordinates,
+	// just like the original loop would.
+	if(!AccessObject(Obj)->Type.isMapContainer()){
+		Obj = AccessObject(Obj)->Root.getContainer();
 	}
 
 	*x = AccessObject(Obj)->Attributes[1];
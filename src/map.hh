@@ -59,12 +59,26 @@ struct Object {
 
 constexpr Object NONE;
 
+// NOTE(fusion): `Root`, `BodyCon`, and `Depth` cache an object's ancestry so
+// we don't need to climb the container chain for every coordinate or owner
+// query. `Root` is the outermost ancestor that isn't a map container (which
+// may be the object itself), `BodyCon` is the closest body container ancestor,
+// if any, and `Depth` is the number of links between the object and `Root`.
+// They're maintained by `PlaceObject` and `CutObject`.
+//	Similarly, `ContentWeight` caches the complete weight of everything inside
+// the object and is adjusted along the container chain whenever an object is
+// placed, removed, or has its type or amount changed. It isn't kept for map
+// containers.
 struct TObject {
 	uint32 ObjectID;
 	Object NextObject;
 	Object Container;
 	ObjectType Type;
 	uint32 Attributes[4];
+	Object Root;
+	Object BodyCon;
+	uint32 Depth;
+	int ContentWeight;
 };
 
 struct TObjectBlock {
@@ -76,6 +90,21 @@ struct TSector {
 	uint32 TimeStamp;
 	uint8 Status;
 	uint8 MapFlags;
+	uint16 SectorZ;
+	int SectorX;
+	int SectorY;
+	int ObjectBlock;
+	uint32 Revision;
+	uint32 StaticRevision;
+};
+
+// NOTE(fusion): Sectors are kept in a two level directory. Each page covers
+// `SECTOR_PAGE_SIZE` x `SECTOR_PAGE_SIZE` sectors of a single floor and is only
+// allocated when one of its sectors is created, so large but mostly empty worlds
+// don't pay for the whole bounding box.
+#define SECTOR_PAGE_SIZE 16
+struct TSectorPage {
+	TSector *Sector[SECTOR_PAGE_SIZE][SECTOR_PAGE_SIZE];
 };
 
 struct TDepotInfo {
@@ -126,6 +155,7 @@ void UnswapSector(uintptr FileNumber);
 void DeleteSwappedSectors(void);
 void LoadObjects(TReadScriptFile *Script, TWriteStream *Stream, bool Skip);
 void LoadObjects(TReadStream *Stream, Object Con);
+int CountObjects(TReadStream *Stream);
 void InitSector(int SectorX, int SectorY, int SectorZ);
 void LoadSector(const char *FileName, int SectorX, int SectorY, int SectorZ);
 void LoadMap(void);
@@ -139,6 +169,21 @@ void PatchSector(int SectorX, int SectorY, int SectorZ, bool FullSector,
 void InitMap(void);
 void ExitMap(bool Save);
 
+// NOTE(fusion): Sector directory iteration. Existing sectors are kept sorted by
+// their Y, X, and Z coordinates, in that order, so sectors from the same cylinder
+// are always adjacent.
+int GetSectorCount(void);
+void GetSectorCoordinates(int Index, int *SectorX, int *SectorY, int *SectorZ);
+uint8 GetSectorFlags(int Index);
+void ReportSectorMemory(void);
+
+// NOTE(fusion): The sector revision changes whenever an object, other than a
+// creature, is added to, removed from, or changed on one of the sector's fields.
+// It is used to invalidate cached information derived from the map.
+uint32 GetSectorRevision(int SectorX, int SectorY, int SectorZ);
+bool SectorLoaded(int SectorX, int SectorY, int SectorZ);
+bool FieldStaticallyImpossible(int x, int y, int z);
+
 // NOTE(fusion): Object related functions.
 TObject *AccessObject(Object Obj);
 Object CreateObject(void);
@@ -158,6 +203,10 @@ Object GetFirstContainerObject(Object Con);
 Object GetContainerObject(Object Con, int Index);
 Object GetMapContainer(int x, int y, int z);
 Object GetMapContainer(Object Obj);
+Object GetObjectRoot(Object Obj);
+Object GetObjectBodyContainer(Object Obj);
+int GetObjectDepth(Object Obj);
+int GetContentWeight(Object Con);
 Object GetFirstObject(int x, int y, int z);
 Object GetFirstSpecObject(int x, int y, int z, ObjectType Type);
 uint8 GetMapContainerFlags(Object Obj);
@@ -18,6 +18,19 @@ static TMoveUseDatabase MoveUseDatabases[5];
 static vector<TDelayedMail> DelayedMail(0, 10, 10);
 static int DelayedMails;
 
+// NOTE(fusion): Owners of depot boxes that are open but not yet loaded, so
+// `MaterializeDepotBox` can find the owner of a box without scanning every
+// player. Entries whose owner left or whose box got loaded in the meantime are
+// only dropped when found.
+static vector<uint32> UnloadedDepotOwner(0, 100, 100);
+static int UnloadedDepotOwners;
+
+static int MaterializedDepots;
+static int MaterializedDepotsPeak;
+static int DepotVisits;
+static int DepotMaterializations;
+static int DepotIdleUnloads;
+
 // Coordinate Packing
 // =============================================================================
 int PackAbsoluteCoordinate(int x, int y, int z){
@@ -617,6 +630,17 @@ void ClearField(Object Obj, Object Exclude){
 	}
 }
 
+static void InsertUnloadedDepotOwner(uint32 CreatureID){
+	for(int i = 0; i < UnloadedDepotOwners; i += 1){
+		if(*UnloadedDepotOwner.at(i) == CreatureID){
+			return;
+		}
+	}
+
+	*UnloadedDepotOwner.at(UnloadedDepotOwners) = CreatureID;
+	UnloadedDepotOwners += 1;
+}
+
 void LoadDepotBox(uint32 CreatureID, int Nr, Object Con){
 	TPlayer *Player = GetPlayer(CreatureID);
 	if(Player == NULL){
@@ -634,15 +658,19 @@ void LoadDepotBox(uint32 CreatureID, int Nr, Object Con){
 		return;
 	}
 
-	// NOTE(fusion): Holy fuck. Objects are actually loaded into the depot box.
-	LoadDepot(Player->PlayerData, Nr, Con);
-
-	int DepotObjects = CountObjects(Con) - 1;
+	// NOTE(fusion): Objects are only loaded into the depot box once it is
+	// actually needed, see `MaterializeDepot`. Until then the depot stays
+	// serialized in the player data and is only scanned to count objects.
+	int DepotObjects = CountDepotObjects(Player->PlayerData, Nr);
 	int DepotCapacity = GetDepotSize(Nr, CheckRight(Player->ID, PREMIUM_ACCOUNT));
 	int DepotSpace = DepotCapacity - DepotObjects;
 	Player->Depot = Con;
 	Player->DepotNr = Nr;
 	Player->DepotSpace = DepotSpace;
+	Player->DepotMaterialized = false;
+	Player->DepotIdleRound = RoundNr;
+	InsertUnloadedDepotOwner(Player->ID);
+	DepotVisits += 1;
 
 	print(3, "Depot belonging to %s has %d free spaces.\n", Player->Name, DepotSpace);
 	SendMessage(Player->Connection, TALK_STATUS_MESSAGE,
@@ -655,6 +683,71 @@ void LoadDepotBox(uint32 CreatureID, int Nr, Object Con){
 	}
 }
 
+void MaterializeDepot(uint32 CreatureID, Object Con){
+	TCreature *Creature = GetCreature(CreatureID);
+	if(Creature == NULL || Creature->Type != PLAYER){
+		return;
+	}
+
+	TPlayer *Player = (TPlayer*)Creature;
+	if(Player->Depot == NONE || Player->Depot != Con || Player->DepotMaterialized){
+		return;
+	}
+
+	// NOTE(fusion): Holy fuck. Objects are actually loaded into the depot box.
+	LoadDepot(Player->PlayerData, Player->DepotNr, Con);
+
+	// NOTE(fusion): The stored depot may have changed since the player arrived
+	// (houses, mails), so recount from what was actually loaded.
+	int DepotObjects = CountObjects(Con) - 1;
+	int DepotCapacity = GetDepotSize(Player->DepotNr, CheckRight(Player->ID, PREMIUM_ACCOUNT));
+	Player->DepotSpace = DepotCapacity - DepotObjects;
+	Player->DepotMaterialized = true;
+	Player->DepotIdleRound = RoundNr;
+
+	MaterializedDepots += 1;
+	DepotMaterializations += 1;
+	if(MaterializedDepotsPeak < MaterializedDepots){
+		MaterializedDepotsPeak = MaterializedDepots;
+	}
+}
+
+void MaterializeDepotBox(Object Con){
+	// NOTE(fusion): Objects may be moved into a depot box by anyone, not just
+	// its owner, and it must be loaded before that happens.
+	int i = 0;
+	while(i < UnloadedDepotOwners){
+		TPlayer *Player = GetPlayer(*UnloadedDepotOwner.at(i));
+		if(Player != NULL && Player->Depot != NONE && !Player->DepotMaterialized
+				&& Player->Depot != Con){
+			i += 1;
+			continue;
+		}
+
+		UnloadedDepotOwners -= 1;
+		*UnloadedDepotOwner.at(i) = *UnloadedDepotOwner.at(UnloadedDepotOwners);
+		if(Player != NULL && Player->Depot == Con && !Player->DepotMaterialized){
+			MaterializeDepot(Player->ID, Con);
+			return;
+		}
+	}
+}
+
+static void DematerializeDepot(TPlayer *Player){
+	Object Con = Player->Depot;
+	SaveDepot(Player->PlayerData, Player->DepotNr, Con);
+
+	Object Obj = GetFirstContainerObject(Con);
+	while(Obj != NONE){
+		Object Next = Obj.getNextObject();
+		Delete(Obj, -1);
+		Obj = Next;
+	}
+
+	Player->DepotMaterialized = false;
+	MaterializedDepots -= 1;
+}
+
 void SaveDepotBox(uint32 CreatureID, int Nr, Object Con){
 	TPlayer *Player = GetPlayer(CreatureID);
 	if(Player == NULL){
@@ -672,21 +765,76 @@ void SaveDepotBox(uint32 CreatureID, int Nr, Object Con){
 		return;
 	}
 
+	// NOTE(fusion): Anything that ended up in a depot box that was never
+	// loaded goes on top of what's stored, same as if it had been loaded.
+	if(Player->Depot == Con && !Player->DepotMaterialized){
+		if(GetFirstContainerObject(Con) == NONE){
+			Player->Depot = NONE;
+			return;
+		}
+		MaterializeDepot(CreatureID, Con);
+	}
+
 	int DepotObjects = CountObjects(Con) - 1;
 	Log("game", "Saving depot %d belonging to %s ... Depot size: %d.\n",
 			Nr, Player->Name, DepotObjects);
 	print(3, "Depot belonging to %s: Calculated free space: %d: Number of actual objects: %d.\n",
 			Player->Name, Player->DepotSpace, DepotObjects);
 
-	SaveDepot(Player->PlayerData, Nr, Con);
+	if(Player->Depot == Con){
+		DematerializeDepot(Player);
+	}else if(GetFirstContainerObject(Con) != NONE){
+		error("moveuse::SaveDepotBox: Depot box of %s was not loaded.\n", Player->Name);
+		SaveDepot(Player->PlayerData, Nr, Con);
+		Object Obj = GetFirstContainerObject(Con);
+		while(Obj != NONE){
+			Object Next = Obj.getNextObject();
+			Delete(Obj, -1);
+			Obj = Next;
+		}
+	}
 	Player->Depot = NONE;
+}
 
-	Object Obj = GetFirstContainerObject(Con);
-	while(Obj != NONE){
-		Object Next = Obj.getNextObject();
-		Delete(Obj, -1);
-		Obj = Next;
+void CheckDepotIdle(TPlayer *Player){
+	if(Player->Depot == NONE || !Player->DepotMaterialized){
+		return;
 	}
+
+	bool InUse = Player->TradeObject != NONE
+			&& IsHeldByContainer(Player->TradeObject, Player->Depot);
+	for(int ContainerNr = 0;
+			ContainerNr < NARRAY(TPlayer::OpenContainer) && !InUse;
+			ContainerNr += 1){
+		Object Con = Player->GetOpenContainer(ContainerNr);
+		if(Con != NONE && (Con == Player->Depot
+				|| IsHeldByContainer(Con, Player->Depot))){
+			InUse = true;
+		}
+	}
+
+	if(InUse){
+		Player->DepotIdleRound = RoundNr;
+	}else if((RoundNr - Player->DepotIdleRound) >= DEPOT_IDLE_TIMEOUT){
+		try{
+			DematerializeDepot(Player);
+			InsertUnloadedDepotOwner(Player->ID);
+			DepotIdleUnloads += 1;
+		}catch(RESULT r){
+			error("CheckDepotIdle: Cannot unload depot of %s (Exception %d).\n",
+					Player->Name, r);
+		}
+	}
+}
+
+void DepotSummary(void){
+	Log("game", "Depots: %d materialized (peak %d), %d of %d visits opened, %d idle unloads.\n",
+			MaterializedDepots, MaterializedDepotsPeak,
+			DepotMaterializations, DepotVisits, DepotIdleUnloads);
+	MaterializedDepotsPeak = MaterializedDepots;
+	DepotVisits = 0;
+	DepotMaterializations = 0;
+	DepotIdleUnloads = 0;
 }
 
 // TODO(fusion): Maybe move this to `strings.cc` or `utils.cc`?
@@ -792,6 +940,7 @@ void SendMail(Object Obj){
 	if(PlayerOnline && Player->Depot != NONE && Player->DepotNr == DepotNr){
 		print(3, "Addressee is logged in and has depot open.\n");
 		try{
+			MaterializeDepot(Player->ID, Player->Depot);
 			Move(0, Obj, Player->Depot, -1, true, NONE);
 			if(ObjType == GetSpecialObject(LETTER_NEW)){
 				Change(Obj, GetSpecialObject(LETTER_STAMPED), 0);
@@ -879,6 +1028,14 @@ void SendMails(TPlayerData *PlayerData){
 			DepotNr = 0;
 		}
 
+		// NOTE(fusion): Mails are prepended to the depot's content so it must
+		// be read first. The mail stays queued if that isn't possible.
+		if(!LoadPlayerDepot(PlayerData, DepotNr)){
+			error("SendMails: Cannot read depot %d of player %u.\n",
+					DepotNr, PlayerData->CharacterID);
+			continue;
+		}
+
 		int NewDepotSize = 0;
 		uint8 *NewDepot = NULL;
 		if(PlayerData->Depot[DepotNr] != NULL){
@@ -902,6 +1059,7 @@ void SendMails(TPlayerData *PlayerData){
 		PlayerData->Depot[DepotNr] = NewDepot;
 		PlayerData->DepotSize[DepotNr] = NewDepotSize;
 		PlayerData->Dirty = true;
+		PlayerData->DirtyDepots |= (1 << DepotNr);
   
 		Log("game", "Mail to %s delivered.\n", PlayerData->Name);
 
@@ -1561,6 +1719,8 @@ void UseContainer(uint32 CreatureID, Object Con, int NextContainerNr){
 		throw ERROR;
 	}
 
+	MaterializeDepotBox(Con);
+
 	bool ContainerClosed = false;
 	for(int ContainerNr = 0;
 			ContainerNr < NARRAY(TPlayer::OpenContainer);
@@ -1595,7 +1755,7 @@ void UseChest(uint32 CreatureID, Object Chest){
 	GetObjectCoordinates(Chest, &ChestX, &ChestY, &ChestZ);
 
 	int QuestNr = (int)Chest.getAttribute(CHESTQUESTNUMBER);
-	if(QuestNr < 0 || QuestNr >= NARRAY(TPlayer::QuestValues)){
+	if(QuestNr < 0 || QuestNr >= MAX_QUESTS){
 		error("UseChest: Invalid number %d on treasure chest at position [%d,%d,%d].\n",
 				QuestNr, ChestX, ChestY, ChestZ);
 		throw ERROR;
@@ -8,6 +8,11 @@
 
 #define MOVEUSE_MAX_PARAMETERS 5
 
+// NOTE(fusion): Seconds a loaded depot box may sit closed before its objects
+// are serialized back into the player data, see `CheckDepotIdle`.
+#define DEPOT_IDLE_TIMEOUT 60
+
+struct TPlayer;
 struct TPlayerData;
 
 enum MoveUseActionType: int {
@@ -157,7 +162,11 @@ void MoveAllObjects(Object Obj, Object Dest, Object Exclude, bool MoveUnmovable)
 void DeleteAllObjects(Object Obj, Object Exclude, bool DeleteUnmovable);
 void ClearField(Object Obj, Object Exclude);
 void LoadDepotBox(uint32 CreatureID, int Nr, Object Con);
+void MaterializeDepot(uint32 CreatureID, Object Con);
+void MaterializeDepotBox(Object Con);
 void SaveDepotBox(uint32 CreatureID, int Nr, Object Con);
+void CheckDepotIdle(TPlayer *Player);
+void DepotSummary(void);
 void SendMail(Object Obj);
 void SendMails(TPlayerData *PlayerData);
 void TextEffect(const char *Text, int x, int y, int z, int Radius);
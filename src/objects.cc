@@ -311,6 +311,30 @@ const char *ObjectType::getDescription(void){
 	return TypeP->Description;
 }
 
+// NOTE(fusion): `Count` is only used for CUMULATIVE objects. Objects that can't
+// be taken weigh nothing, except for a few hardcoded ones (see `GetWeight`).
+int ObjectType::getWeight(int Count){
+	// TODO(fusion): Why do some UNTAKE items have weight, and even worse, hardcoded?
+
+	int Result = 0;
+	if(this->getFlag(TAKE)){
+		int Weight = (int)this->getAttribute(WEIGHT);
+		if(!this->getFlag(CUMULATIVE)){
+			Count = 1;
+		}
+		Result = Weight * Count;
+	}else if(this->TypeID == 2904){ // LARGE AMPHORA
+		Result = 19500;
+	}else if(this->TypeID == 3458){ // ANVIL
+		Result = 50000;
+	}else if(this->TypeID == 3510){ // COAL BASIN
+		Result = 22800;
+	}else if(this->TypeID == 4311){ // DEAD HUMAN
+		Result = 80000;
+	}
+	return Result;
+}
+
 // Object Type Related Functions
 // =============================================================================
 int GetFlagByName(const char *Name){
@@ -28,6 +28,7 @@ struct ObjectType {
 	int getAttributeOffset(INSTANCEATTRIBUTE Attribute);
 	const char *getName(int Count);
 	const char *getDescription(void);
+	int getWeight(int Count);
 
 	bool isMapContainer(void){
 		return this->TypeID == TYPEID_MAP_CONTAINER;
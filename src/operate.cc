@@ -5,6 +5,7 @@
 #include "magic.hh"
 #include "moveuse.hh"
 #include "reader.hh"
+#include "threads.hh"
 
 #include <dirent.h>
 
@@ -1180,6 +1181,8 @@ Object Create(Object Con, ObjectType Type, uint32 Value){
 		ChangeObject(Obj, CHARGES, Value);
 	}
 
+	AddInventoryIndex(ConOwnerID, Obj, false);
+
 	if(Type.isCreatureContainer()){
 		// BUG(fusion): We should just check this before creating the object.
 		// Also, using `Delete` instead of `DeleteObject` here is problematic
@@ -1255,6 +1258,7 @@ Object Copy(Object Con, Object Source){
 	// functions will do meaningless work there (I think, check what happens when
 	// we're actually running).
 	Object Obj = CopyObject(Con, Source);
+	AddInventoryIndex(ConOwnerID, Obj, false);
 	if(SourceType.getFlag(CONTAINER)){
 		Object Help = GetFirstContainerObject(Source);
 		while(Help != NONE){
@@ -1355,6 +1359,7 @@ void Move(uint32 CreatureID, Object Obj, Object Con, int Count, bool NoMerge, Ob
 		if(ConType.isBodyContainer()){
 			CheckInventoryDestination(Obj, Con, Split);
 		}else{
+			MaterializeDepotBox(Con);
 			CheckContainerDestination(Obj, Con);
 		}
 
@@ -1411,8 +1416,20 @@ void Move(uint32 CreatureID, Object Obj, Object Con, int Count, bool NoMerge, Ob
 		AnnounceMovingCreature(MovingCreatureID, Con);
 	}
 
+	// NOTE(fusion): Owners are checked again because events may have moved
+	// things around since the checks above.
+	uint32 OldOwnerID = GetObjectCreatureID(Obj);
+	uint32 NewOwnerID = GetObjectCreatureID(Con);
+	if(OldOwnerID != NewOwnerID){
+		RemoveInventoryIndex(OldOwnerID, Obj, true);
+	}
+
 	MoveObject(Obj, Con);
 
+	if(OldOwnerID != NewOwnerID){
+		AddInventoryIndex(NewOwnerID, Obj, true);
+	}
+
 	if(!ObjType.isCreatureContainer()){
 		AnnounceChangedObject(Obj, OBJECT_CREATED);
 		NotifyTrades(Obj);
@@ -1511,8 +1528,12 @@ void Merge(uint32 CreatureID, Object Obj, Object Dest, int Count, Object Ignore)
 		SeparationEvent(Obj, ObjCon);
 	}
 
+	uint32 IndexOwnerID = GetObjectCreatureID(Obj);
+	RemoveInventoryIndex(IndexOwnerID, Obj, false);
+	RemoveInventoryIndex(DestOwnerID, Dest, false);
 	if(Count < ObjCount){
 		ChangeObject(Obj, AMOUNT, ObjCount - Count);
+		AddInventoryIndex(IndexOwnerID, Obj, false);
 		AnnounceChangedObject(Obj, OBJECT_CHANGED);
 		NotifyTrades(Obj);
 		ChangeObject(Dest, AMOUNT, DestCount + Count);
@@ -1522,6 +1543,7 @@ void Merge(uint32 CreatureID, Object Obj, Object Dest, int Count, Object Ignore)
 		NotifyDepot(CreatureID, Obj, 1);
 		MergeObjects(Obj, Dest);
 	}
+	AddInventoryIndex(DestOwnerID, Dest, false);
 
 	AnnounceChangedObject(Dest, OBJECT_CHANGED);
 	NotifyTrades(Dest);
@@ -1602,6 +1624,7 @@ void Change(Object Obj, ObjectType NewType, uint32 Value){
 		CloseContainer(Obj, true);
 	}
 
+	RemoveInventoryIndex(ObjOwnerID, Obj, false);
 	ChangeObject(Obj, NewType);
 
 	// TODO(fusion): Same thing as `Create`. I feel these usages of `Value`
@@ -1631,6 +1654,7 @@ void Change(Object Obj, ObjectType NewType, uint32 Value){
 		ChangeObject(Obj, CHARGES, Value);
 	}
 
+	AddInventoryIndex(ObjOwnerID, Obj, false);
 	AnnounceChangedObject(Obj, OBJECT_CHANGED);
 	NotifyTrades(Obj);
 	NotifyCreature(ObjOwnerID, Obj, ConType.isBodyContainer());
@@ -1660,7 +1684,19 @@ void Change(Object Obj, INSTANCEATTRIBUTE Attribute, uint32 Value){
 		CheckWeight(ObjOwnerID, Obj.getObjectType(), Value, OldWeight);
 	}
 
+	bool Indexed = Attribute == AMOUNT
+			|| Attribute == CONTAINERLIQUIDTYPE
+			|| Attribute == KEYNUMBER;
+	if(Indexed){
+		RemoveInventoryIndex(ObjOwnerID, Obj, false);
+	}
+
 	ChangeObject(Obj, Attribute, Value);
+
+	if(Indexed){
+		AddInventoryIndex(ObjOwnerID, Obj, false);
+	}
+
 	if(Attribute == AMOUNT
 			|| Attribute == CONTAINERLIQUIDTYPE
 			|| Attribute == POOLLIQUIDTYPE){
@@ -1692,6 +1728,8 @@ void Delete(Object Obj, int Count){
 		NotifyTrades(Obj);
 	}
 
+	Object Con = Obj.getContainer();
+	uint32 ObjOwnerID = GetObjectCreatureID(Obj);
 	if(ObjType.getFlag(CONTAINER) || ObjType.getFlag(CHEST)){
 		if(ObjType.getFlag(CONTAINER)){
 			CloseContainer(Obj, true);
@@ -1700,13 +1738,12 @@ void Delete(Object Obj, int Count){
 		Object Help = GetFirstContainerObject(Obj);
 		while(Help != NONE){
 			Object Next = Help.getNextObject();
+			RemoveInventoryIndex(ObjOwnerID, Help, true);
 			DeleteObject(Help);
 			Help = Next;
 		}
 	}
 
-	Object Con = Obj.getContainer();
-	uint32 ObjOwnerID = GetObjectCreatureID(Obj);
 	SeparationEvent(Obj, Con);
 
 	// BUG(fusion): Object may have been destroyed by the separation event? This
@@ -1730,6 +1767,8 @@ void Delete(Object Obj, int Count){
 			}
 		}
 
+		// NOTE(fusion): The separation event may have moved the object.
+		RemoveInventoryIndex(GetObjectCreatureID(Obj), Obj, true);
 		DeleteObject(Obj);
 
 		if(Remainder != NONE){
@@ -2810,11 +2849,7 @@ bool SectorRefreshable(int SectorX, int SectorY, int SectorZ){
 	return true;
 }
 
-void RefreshSector(int SectorX, int SectorY, int SectorZ, const uint8 *Data, int Count){
-	if(!SectorRefreshable(SectorX, SectorY, SectorZ)){
-		return;
-	}
-
+static void ApplySectorRefresh(int SectorX, int SectorY, int SectorZ, const uint8 *Data, int Count){
 	TReadBuffer Buffer(Data, Count);
 	RefreshSector(SectorX, SectorY, SectorZ, &Buffer);
 
@@ -2832,7 +2867,7 @@ void RefreshSector(int SectorX, int SectorY, int SectorZ, const uint8 *Data, int
 
 		TCreature *Creature = GetCreature(CreatureID);
 		if(Creature == NULL){
-			error("RefreshSector: Creature does not exist.\n");
+			error("ApplySectorRefresh: Creature does not exist.\n");
 			continue;
 		}
 
@@ -2875,113 +2910,181 @@ void RefreshSector(int SectorX, int SectorY, int SectorZ, const uint8 *Data, int
 				Object MapCon = GetMapContainer(FieldX, FieldY, FieldZ);
 				Move(0, Creature->CrObject, MapCon, -1, false, NONE);
 			}catch(RESULT r){
-				error("RefreshSector: Exception %d while resetting the monster.\n", r);
+				error("ApplySectorRefresh: Exception %d while resetting the monster.\n", r);
 			}
 		}
 	}
 }
 
-void RefreshMap(void){
-	TDynamicWriteBuffer HelpBuffer(KB(64));
-	for(int SectorZ = SectorZMin; SectorZ <= SectorZMax; SectorZ += 1)
-	for(int SectorY = SectorYMin; SectorY <= SectorYMax; SectorY += 1)
-	for(int SectorX = SectorXMin; SectorX <= SectorXMax; SectorX += 1){
-		if(!SectorRefreshable(SectorX, SectorY, SectorZ)){
-			continue;
+void RefreshSector(int SectorX, int SectorY, int SectorZ, const uint8 *Data, int Count){
+	if(!SectorRefreshable(SectorX, SectorY, SectorZ)){
+		return;
+	}
+
+	ApplySectorRefresh(SectorX, SectorY, SectorZ, Data, Count);
+}
+
+// NOTE(fusion): The full map refresh before a reboot used to parse every
+// original sector file on the game thread, freezing the game for a few seconds.
+// It is now started a few minutes before the reboot: the reader thread parses
+// the original map (see `ProcessLoadMapOrder`) and sends it back sector by
+// sector, while `ProcessRefreshMap` applies queued sectors every beat within
+// `RefreshMapBudget` milliseconds. Sectors that can't be refreshed because
+// a player is watching are put back at the end of the queue, to be retried
+// later. Whatever is left when the reboot comes is applied by `RefreshMap`.
+struct TRefreshMapEntry {
+	int SectorX;
+	int SectorY;
+	int SectorZ;
+	const uint8 *Data;
+	int Size;
+};
+
+static fifo<TRefreshMapEntry> RefreshMapQueue(256);
+static bool RefreshMapStarted;
+static bool RefreshMapLoaded;
+static int RefreshMapReceived;
+static int RefreshMapApplied;
+static int RefreshMapSkipped;
+
+void StartRefreshMap(void){
+	if(RefreshMapStarted){
+		return;
+	}
+
+	print(1, "Starting map refresh ...\n");
+	RefreshMapStarted = true;
+	RefreshMapLoaded = false;
+	RefreshMapReceived = 0;
+	RefreshMapApplied = 0;
+	RefreshMapSkipped = 0;
+	LoadMapOrder();
+}
+
+bool RefreshMapActive(void){
+	return RefreshMapStarted;
+}
+
+void RefreshMapSector(int SectorX, int SectorY, int SectorZ, const uint8 *Data, int Count){
+	if(Data == NULL){
+		RefreshMapLoaded = true;
+		print(2, "RefreshMap: Original map loaded (%d sectors).\n", RefreshMapReceived);
+		return;
+	}
+
+	if(!RefreshMapStarted){
+		error("RefreshMapSector: Map refresh not started.\n");
+		delete[] Data;
+		return;
+	}
+
+	TRefreshMapEntry *Entry = RefreshMapQueue.append();
+	Entry->SectorX = SectorX;
+	Entry->SectorY = SectorY;
+	Entry->SectorZ = SectorZ;
+	Entry->Data = Data;
+	Entry->Size = Count;
+	RefreshMapReceived += 1;
+}
+
+// NOTE(fusion): Each queued sector is looked at most once per call so deferred
+// sectors don't keep us spinning. `Deadline` is a monotonic timestamp in
+// microseconds, or zero to process the whole queue. If `Deferrable` is false,
+// sectors that can't be refreshed are dropped.
+static void ApplyRefreshMapQueue(int64 Deadline, bool Deferrable){
+	int Count = RefreshMapReceived - RefreshMapApplied - RefreshMapSkipped;
+	for(int i = 0; i < Count; i += 1){
+		if(i > 0 && Deadline != 0 && GetMonotonicMicroseconds() >= Deadline){
+			break;
 		}
 
-		char FileName[4096];
-		snprintf(FileName, sizeof(FileName), "%s/%04d-%04d-%02d.sec",
-				ORIGMAPPATH, SectorX, SectorY, SectorZ);
-		if(!FileExists(FileName)){
+		TRefreshMapEntry Entry = *RefreshMapQueue.next();
+		RefreshMapQueue.remove();
+		if(SectorRefreshable(Entry.SectorX, Entry.SectorY, Entry.SectorZ)){
+			ApplySectorRefresh(Entry.SectorX, Entry.SectorY, Entry.SectorZ,
+					Entry.Data, Entry.Size);
+			RefreshMapApplied += 1;
+		}else if(Deferrable){
+			*RefreshMapQueue.append() = Entry;
 			continue;
+		}else{
+			print(2, "RefreshMap: Sector %d/%d/%d cannot be refreshed.\n",
+					Entry.SectorX, Entry.SectorY, Entry.SectorZ);
+			RefreshMapSkipped += 1;
 		}
 
-		int OffsetX = -1;
-		int OffsetY = -1;
-		bool Refreshable = false;
-		HelpBuffer.Position = 0;
-		try{
-			TReadScriptFile Script;
-			Script.open(FileName);
-			while(true){
-				Script.nextToken();
-				if(Script.Token == ENDOFFILE){
-					Script.close();
-					break;
-				}
+		delete[] Entry.Data;
+	}
+}
 
-				if(Script.Token == SPECIAL && Script.getSpecial() == ','){
-					continue;
-				}
+void ProcessRefreshMap(void){
+	static uint32 LastProgressRound = 0;
 
-				if(Script.Token == BYTES){
-					uint8 *SectorOffset = Script.getBytesequence();
-					OffsetX = (int)SectorOffset[0];
-					OffsetY = (int)SectorOffset[1];
-					Refreshable = false;
-					Script.readSymbol(':');
-				}else if(Script.Token == IDENTIFIER){
-					if(OffsetX == -1 || OffsetY == -1){
-						Script.error("coordinate expected");
-					}
+	if(!RefreshMapStarted){
+		return;
+	}
 
-					const char *Identifier = Script.getIdentifier();
-					if(strcmp(Identifier, "refresh") == 0){
-						Refreshable = true;
-					}else if(strcmp(Identifier, "content") == 0){
-						Script.readSymbol('=');
-						if(Refreshable){
-							HelpBuffer.writeByte((uint8)OffsetX);
-							HelpBuffer.writeByte((uint8)OffsetY);
-						}
-						LoadObjects(&Script, &HelpBuffer, !Refreshable);
-					}
-				}
-			}
+	int64 Deadline = GetMonotonicMicroseconds() + (int64)RefreshMapBudget * 1000;
+	ApplyRefreshMapQueue(Deadline, true);
 
-			if(HelpBuffer.Position > 0){
-				TReadBuffer ReadBuffer(HelpBuffer.Data, HelpBuffer.Position);
-				RefreshSector(SectorX, SectorY, SectorZ, &ReadBuffer);
-			}
-		}catch(const char *str){
-			error("RefreshMap: Error while processing file (%s).\n", str);
-		}
+	if(LastProgressRound != RoundNr){
+		LastProgressRound = RoundNr;
+		print(3, "RefreshMap: %d/%d sectors applied%s.\n",
+				RefreshMapApplied, RefreshMapReceived,
+				(RefreshMapLoaded ? "" : " (still loading)"));
 	}
 }
 
+void RefreshMap(void){
+	// NOTE(fusion): This is the reboot deadline. Wait for the reader thread to
+	// finish loading the original map and apply whatever is left.
+	StartRefreshMap();
+	while(!RefreshMapLoaded){
+		DelayThread(0, 10000);
+		ProcessReaderThreadReplies(RefreshSector, RefreshMapSector, SendMails);
+	}
+
+	ApplyRefreshMapQueue(0, false);
+	print(1, "RefreshMap: %d sectors refreshed, %d skipped.\n",
+			RefreshMapApplied, RefreshMapSkipped);
+	RefreshMapStarted = false;
+}
+
 void RefreshCylinders(void){
 	// TODO(fusion): `RefreshedCylinders` is the number of cylinders we attempt to
 	// refresh in this function, which is called every minute or so by `AdvanceGame`.
 	// We should probably rename it to something more clear.
 
-	// TODO(fusion): This might be on purpose but `RefreshX` and `RefreshY` will be
-	// way below `SectorXMin` and `SectorYMin` the first N times this function is
-	// called and depending on the value of `RefreshedCylinders`, could take a few
-	// hours before we even start refreshing the map.
-	//	If the intent is to delay refreshing cylinders until some time after startup,
-	// we should change how this function is called by `AdvanceGame` instead.
+	// NOTE(fusion): We walk the sector directory rather than the whole bounding
+	// box, which keeps sectors from the same cylinder adjacent, and only request
+	// sectors with refreshable fields. Sectors without them would be ignored by
+	// `RefreshSector` anyways.
+	static int RefreshIndex = 0;
+	int SectorCount = GetSectorCount();
+	if(SectorCount == 0){
+		return;
+	}
 
-	static int RefreshX = -1;
-	static int RefreshY = -1;
 	for(int i = 0; i < RefreshedCylinders; i += 1){
-		if(RefreshX < SectorXMax){
-			RefreshX += 1;
-		}else{
-			RefreshX = SectorXMin;
-			if(RefreshY < SectorYMax){
-				RefreshY += 1;
-			}else{
-				RefreshY = SectorYMin;
-			}
+		if(RefreshIndex >= SectorCount){
+			RefreshIndex = 0;
 		}
 
-		for(int RefreshZ = SectorZMin;
-				RefreshZ <= SectorZMax;
-				RefreshZ += 1){
-			if(SectorRefreshable(RefreshX, RefreshY, RefreshZ)){
-				LoadSectorOrder(RefreshX, RefreshY, RefreshZ);
+		int RefreshX, RefreshY, RefreshZ;
+		GetSectorCoordinates(RefreshIndex, &RefreshX, &RefreshY, &RefreshZ);
+		while(RefreshIndex < SectorCount){
+			int SectorX, SectorY, SectorZ;
+			GetSectorCoordinates(RefreshIndex, &SectorX, &SectorY, &SectorZ);
+			if(SectorX != RefreshX || SectorY != RefreshY){
+				break;
+			}
+
+			if((GetSectorFlags(RefreshIndex) & 0x01) != 0
+					&& SectorRefreshable(SectorX, SectorY, SectorZ)){
+				LoadSectorOrder(SectorX, SectorY, SectorZ);
 			}
+
+			RefreshIndex += 1;
 		}
 	}
 }
@@ -2997,6 +3100,7 @@ void ApplyPatch(int SectorX, int SectorY, int SectorZ,
 	PrepareHouseCleanup();
 	PatchSector(SectorX, SectorY, SectorZ, FullSector, Script, SaveHouses);
 	FinishHouseCleanup();
+	RefreshMonsterhomeCandidates(SectorX, SectorY, SectorZ);
 
 	// TODO(fusion): Similar to `SectorRefreshable` but with a reduced radius.
 	int SearchRadiusX = 32 / 2;
@@ -157,6 +157,10 @@ void DeleteAtCreature(uint32 CreatureID, ObjectType Type, int Amount, uint32 Val
 void ProcessCronSystem(void);
 bool SectorRefreshable(int SectorX, int SectorY, int SectorZ);
 void RefreshSector(int SectorX, int SectorY, int SectorZ, const uint8 *Data, int Count);
+void StartRefreshMap(void);
+bool RefreshMapActive(void);
+void RefreshMapSector(int SectorX, int SectorY, int SectorZ, const uint8 *Data, int Count);
+void ProcessRefreshMap(void);
 void RefreshMap(void);
 void RefreshCylinders(void);
 void ApplyPatch(int SectorX, int SectorY, int SectorZ,
@@ -3,59 +3,167 @@
 #include "cr.hh"
 #include "map.hh"
 #include "threads.hh"
+#include "writer.hh"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define MAX_READER_WORKERS 8
+
+// NOTE(fusion): Orders are kept in bounded queues where producers block while
+// the queue is full and consumers while it's empty. Sector and map orders use
+// the original map index and `HelpBuffer` so they're served by the reader
+// thread alone, but character loads are independent of each other and have
+// their own queue, served by `ReaderWorkers` threads.
+struct TReaderOrderQueue {
+	TReaderOrderQueue(void) :
+			WritePointer(0), ReadPointer(0), Mutex(1),
+			BufferEmpty(NARRAY(Order)), BufferFull(0) {}
+
+	TReaderThreadOrder Order[200];
+	int WritePointer;
+	int ReadPointer;
+	Semaphore Mutex;
+	Semaphore BufferEmpty;
+	Semaphore BufferFull;
+};
 
 static ThreadHandle ReaderThread;
+static ThreadHandle ReaderWorkerThread[MAX_READER_WORKERS];
+static int ReaderWorkerThreads;
 
-static TReaderThreadOrder OrderBuffer[200];
-static int OrderPointerWrite;
-static int OrderPointerRead;
-static Semaphore OrderBufferEmpty(NARRAY(OrderBuffer));
-static Semaphore OrderBufferFull(0);
+static TReaderOrderQueue OrderQueue;
+static TReaderOrderQueue CharacterOrderQueue;
 
+// NOTE(fusion): Replies are inserted by the reader thread and its workers and
+// taken by the game thread, which releases `ReplyBufferEmpty` for each one so
+// producers are held back only while the buffer is actually full. Map replies
+// are additionally limited to half the buffer, leaving room for sector and
+// character replies during a map refresh.
 static TReaderThreadReply ReplyBuffer[200];
 static int ReplyPointerWrite;
 static int ReplyPointerRead;
+static Semaphore ReplyBufferMutex(1);
+static Semaphore ReplyBufferEmpty(NARRAY(ReplyBuffer));
+static Semaphore MapReplyBufferEmpty(NARRAY(ReplyBuffer) / 2);
+static bool ReaderTerminating;
 
 static TDynamicWriteBuffer HelpBuffer(KB(64));
 
+// NOTE(fusion): Preprocessed index of the original map. It is built by the game
+// thread during startup (see `InitOrigMapIndex`) from the original sector files,
+// whenever they're newer than the index or the object types it was encoded with
+// have changed, and then mapped into memory, making sector loads a simple table
+// lookup. After that, only the reader thread reads it, until `ExitReader`.
+#define ORIGMAP_INDEX_MAGIC 0x4D47524F // "ORGM"
+#define ORIGMAP_INDEX_VERSION 2
+#define ORIGMAP_INDEX_HEADER_SIZE 20
+
+struct TOrigMapEntry {
+	int SectorX;
+	int SectorY;
+	int SectorZ;
+	int Offset;
+	int Size;
+};
+
+static uint8 *OrigMapData;
+static int OrigMapDataSize;
+static TOrigMapEntry *OrigMapEntry;
+static int OrigMapEntries;
+
+// NOTE(fusion): Refresh request latencies, in microseconds, from the time the
+// order is inserted. They're written by the reader thread and summarized by
+// the game thread.
+static Semaphore ReaderStatisticsMutex(1);
+static int ReaderSectorRequests;
+static int ReaderSectorIndexHits;
+static int64 ReaderSectorWaitTotal;
+static int64 ReaderSectorLatencyTotal;
+static int64 ReaderSectorLatencyMax;
+
+// NOTE(fusion): Order-to-reply latencies, in microseconds, from the time the
+// order is inserted until the game thread processes its reply, by reply type.
+static int ReaderReplies[3];
+static int64 ReaderReplyLatencyTotal[3];
+static int64 ReaderReplyLatencyMax[3];
+static int ReaderReplyStalls;
+static int ReaderCharacterWaits;
+
 // Reader Orders
 // =============================================================================
 void InitReaderBuffers(void){
-	OrderPointerWrite = 0;
-	OrderPointerRead = 0;
+	OrderQueue.WritePointer = 0;
+	OrderQueue.ReadPointer = 0;
+	CharacterOrderQueue.WritePointer = 0;
+	CharacterOrderQueue.ReadPointer = 0;
 	ReplyPointerWrite = 0;
 	ReplyPointerRead = 0;
+	ReaderTerminating = false;
+}
+
+static void PushOrder(TReaderOrderQueue *Queue, const TReaderThreadOrder *Order){
+	Queue->Mutex.down();
+	int Orders = (Queue->WritePointer - Queue->ReadPointer);
+	Queue->Mutex.up();
+	if(Orders >= NARRAY(Queue->Order)){
+		error("InsertOrder (Reader): Order buffer is full; waiting...\n");
+	}
+
+	Queue->BufferEmpty.down();
+	Queue->Mutex.down();
+	Queue->Order[Queue->WritePointer % NARRAY(Queue->Order)] = *Order;
+	Queue->WritePointer += 1;
+	Queue->Mutex.up();
+	Queue->BufferFull.up();
+}
+
+static void PopOrder(TReaderOrderQueue *Queue, TReaderThreadOrder *Order){
+	Queue->BufferFull.down();
+	Queue->Mutex.down();
+	*Order = Queue->Order[Queue->ReadPointer % NARRAY(Queue->Order)];
+	Queue->ReadPointer += 1;
+	Queue->Mutex.up();
+	Queue->BufferEmpty.up();
 }
 
 void InsertOrder(TReaderThreadOrderType OrderType,
 		int SectorX, int SectorY, int SectorZ, uint32 CharacterID){
-	int Orders = (OrderPointerWrite - OrderPointerRead);
-	if(Orders >= NARRAY(OrderBuffer)){
-		error("InsertOrder (Reader): Order buffer is full => Enlarging.\n");
+	TReaderThreadOrder Order = {};
+	Order.OrderType = OrderType;
+	Order.SectorX = SectorX;
+	Order.SectorY = SectorY;
+	Order.SectorZ = SectorZ;
+	Order.CharacterID = CharacterID;
+	Order.OrderTime = GetMonotonicMicroseconds();
+	if(OrderType == READER_ORDER_LOADCHARACTER){
+		PushOrder(&CharacterOrderQueue, &Order);
+	}else{
+		PushOrder(&OrderQueue, &Order);
 	}
-
-	OrderBufferEmpty.down();
-	int WritePos = OrderPointerWrite % NARRAY(OrderBuffer);
-	OrderBuffer[WritePos].OrderType = OrderType;
-	OrderBuffer[WritePos].SectorX = SectorX;
-	OrderBuffer[WritePos].SectorY = SectorY;
-	OrderBuffer[WritePos].SectorZ = SectorZ;
-	OrderBuffer[WritePos].CharacterID = CharacterID;
-	OrderPointerWrite += 1;
-	OrderBufferFull.up();
 }
 
 void GetOrder(TReaderThreadOrder *Order){
-	OrderBufferFull.down();
-	*Order = OrderBuffer[OrderPointerRead % NARRAY(OrderBuffer)];
-	OrderPointerRead += 1;
-	OrderBufferEmpty.up();
+	PopOrder(&OrderQueue, Order);
+}
+
+void GetCharacterOrder(TReaderThreadOrder *Order){
+	PopOrder(&CharacterOrderQueue, Order);
 }
 
 void TerminateReaderOrder(void){
 	InsertOrder(READER_ORDER_TERMINATE, 0, 0, 0, 0);
 }
 
+void TerminateCharacterOrder(void){
+	TReaderThreadOrder Order = {};
+	Order.OrderType = READER_ORDER_TERMINATE;
+	Order.OrderTime = GetMonotonicMicroseconds();
+	PushOrder(&CharacterOrderQueue, &Order);
+}
+
 void LoadSectorOrder(int SectorX, int SectorY, int SectorZ){
 	InsertOrder(READER_ORDER_LOADSECTOR, SectorX, SectorY, SectorZ, 0);
 }
@@ -64,16 +172,14 @@ void LoadCharacterOrder(uint32 CharacterID){
 	InsertOrder(READER_ORDER_LOADCHARACTER, 0, 0, 0, CharacterID);
 }
 
-void ProcessLoadSectorOrder(int SectorX, int SectorY, int SectorZ){
-	// TODO(fusion): We parsed sector files way too many times now. And there
-	// is also a drop in loader quality.
-	char FileName[4096];
-	snprintf(FileName, sizeof(FileName), "%s/%04d-%04d-%02d.sec",
-			ORIGMAPPATH, SectorX, SectorY, SectorZ);
-	if(!FileExists(FileName)){
-		return;
-	}
+void LoadMapOrder(void){
+	InsertOrder(READER_ORDER_LOADMAP, 0, 0, 0, 0);
+}
 
+// NOTE(fusion): Parse refreshable fields from an original sector file into
+// `HelpBuffer`, returning the number of bytes written. The data is formatted
+// as expected by `RefreshSector`.
+static int ReadSectorRefreshData(const char *FileName){
 	int OffsetX = -1;
 	int OffsetY = -1;
 	bool Refreshable = false;
@@ -119,35 +225,419 @@ void ProcessLoadSectorOrder(int SectorX, int SectorY, int SectorZ){
 		}
 	}
 
-	int Size = HelpBuffer.Position;
+	return HelpBuffer.Position;
+}
+
+static bool OrigMapEntryLess(const TOrigMapEntry &A, const TOrigMapEntry &B){
+	if(A.SectorX != B.SectorX){
+		return A.SectorX < B.SectorX;
+	}else if(A.SectorY != B.SectorY){
+		return A.SectorY < B.SectorY;
+	}else{
+		return A.SectorZ < B.SectorZ;
+	}
+}
+
+static void GetOrigMapIndexFileName(char *Buffer, int BufferSize){
+	snprintf(Buffer, BufferSize, "%s/origmap.idx", SAVEPATH);
+}
+
+// NOTE(fusion): Sector data is stored the way `LoadObjects` encodes it, which
+// depends on the object types, so the index also records a checksum of them.
+static uint32 GetObjectTypesChecksum(void){
+	char FileName[4096];
+	snprintf(FileName, sizeof(FileName), "%s/objects.srv", DATAPATH);
+	FILE *File = fopen(FileName, "rb");
+	if(File == NULL){
+		error("GetObjectTypesChecksum: Cannot open %s.\n", FileName);
+		return 0;
+	}
+
+	uint32 Checksum = 2166136261U;
+	uint8 Buffer[KB(16)];
+	while(true){
+		usize Read = fread(Buffer, 1, sizeof(Buffer), File);
+		if(Read == 0){
+			break;
+		}
+
+		for(usize i = 0; i < Read; i += 1){
+			Checksum = (Checksum ^ Buffer[i]) * 16777619U;
+		}
+	}
+	fclose(File);
+	return Checksum;
+}
+
+static bool OrigMapIndexOutdated(const char *IndexFileName, uint32 ObjectTypes){
+	struct stat IndexStat;
+	if(stat(IndexFileName, &IndexStat) != 0){
+		return true;
+	}
+
+	uint8 Header[ORIGMAP_INDEX_HEADER_SIZE];
+	FILE *IndexFile = fopen(IndexFileName, "rb");
+	if(IndexFile == NULL){
+		return true;
+	}
+	usize HeaderSize = fread(Header, 1, sizeof(Header), IndexFile);
+	fclose(IndexFile);
+	if(HeaderSize != sizeof(Header)){
+		return true;
+	}
+
+	TReadBuffer Buffer(Header, sizeof(Header));
+	uint32 Magic = Buffer.readQuad();
+	uint32 Version = Buffer.readQuad();
+	Buffer.readQuad(); // Entries
+	Buffer.readQuad(); // DataSize
+	uint32 IndexObjectTypes = Buffer.readQuad();
+	if(Magic != ORIGMAP_INDEX_MAGIC || Version != ORIGMAP_INDEX_VERSION
+			|| IndexObjectTypes != ObjectTypes){
+		return true;
+	}
+
+	// NOTE(fusion): Removing a sector file updates the directory itself.
+	struct stat FileStat;
+	if(stat(ORIGMAPPATH, &FileStat) != 0 || FileStat.st_mtime > IndexStat.st_mtime){
+		return true;
+	}
+
+	DIR *OrigMapDir = opendir(ORIGMAPPATH);
+	if(OrigMapDir == NULL){
+		return true;
+	}
+
+	bool Result = false;
+	char FileName[4096];
+	while(dirent *DirEntry = readdir(OrigMapDir)){
+		const char *FileExt = findLast(DirEntry->d_name, '.');
+		if(FileExt == NULL || strcmp(FileExt, ".sec") != 0){
+			continue;
+		}
+
+		snprintf(FileName, sizeof(FileName), "%s/%s", ORIGMAPPATH, DirEntry->d_name);
+		if(stat(FileName, &FileStat) != 0 || FileStat.st_mtime > IndexStat.st_mtime){
+			Result = true;
+			break;
+		}
+	}
+
+	closedir(OrigMapDir);
+	return Result;
+}
+
+static void BuildOrigMapIndex(const char *IndexFileName, uint32 ObjectTypes){
+	print(1, "Building original map index ...\n");
+
+	DIR *OrigMapDir = opendir(ORIGMAPPATH);
+	if(OrigMapDir == NULL){
+		error("BuildOrigMapIndex: Subdirectory %s not found.\n", ORIGMAPPATH);
+		return;
+	}
+
+	int MaxEntries = 1024;
+	int Entries = 0;
+	TOrigMapEntry *Entry = (TOrigMapEntry*)malloc(MaxEntries * sizeof(TOrigMapEntry));
+	TDynamicWriteBuffer Data(MB(1));
+	char FileName[4096];
+	while(dirent *DirEntry = readdir(OrigMapDir)){
+		if(DirEntry->d_type != DT_REG){
+			continue;
+		}
+
+		const char *FileExt = findLast(DirEntry->d_name, '.');
+		if(FileExt == NULL || strcmp(FileExt, ".sec") != 0){
+			continue;
+		}
+
+		int SectorX, SectorY, SectorZ;
+		if(sscanf(DirEntry->d_name, "%d-%d-%d.sec", &SectorX, &SectorY, &SectorZ) != 3){
+			continue;
+		}
+
+		snprintf(FileName, sizeof(FileName), "%s/%s", ORIGMAPPATH, DirEntry->d_name);
+		try{
+			int Size = ReadSectorRefreshData(FileName);
+			if(Size > 0){
+				if(Entries >= MaxEntries){
+					MaxEntries *= 2;
+					Entry = (TOrigMapEntry*)realloc(Entry, MaxEntries * sizeof(TOrigMapEntry));
+				}
+
+				Entry[Entries].SectorX = SectorX;
+				Entry[Entries].SectorY = SectorY;
+				Entry[Entries].SectorZ = SectorZ;
+				Entry[Entries].Offset = Data.Position;
+				Entry[Entries].Size = Size;
+				Entries += 1;
+				Data.writeBytes(HelpBuffer.Data, Size);
+			}
+		}catch(const char *str){
+			error("BuildOrigMapIndex: Error while processing file %s (%s).\n", FileName, str);
+		}
+	}
+	closedir(OrigMapDir);
+
+	std::sort(Entry, Entry + Entries, OrigMapEntryLess);
+
+	// NOTE(fusion): Write to a temporary file first so a failed build doesn't
+	// leave a truncated index behind.
+	char TempFileName[4096];
+	snprintf(TempFileName, sizeof(TempFileName), "%s.tmp", IndexFileName);
+	try{
+		TWriteBinaryFile File;
+		File.open(TempFileName);
+		File.writeQuad(ORIGMAP_INDEX_MAGIC);
+		File.writeQuad(ORIGMAP_INDEX_VERSION);
+		File.writeQuad((uint32)Entries);
+		File.writeQuad((uint32)Data.Position);
+		File.writeQuad(ObjectTypes);
+		for(int i = 0; i < Entries; i += 1){
+			File.writeQuad((uint32)Entry[i].SectorX);
+			File.writeQuad((uint32)Entry[i].SectorY);
+			File.writeQuad((uint32)Entry[i].SectorZ);
+			File.writeQuad((uint32)Entry[i].Offset);
+			File.writeQuad((uint32)Entry[i].Size);
+		}
+		File.writeBytes(Data.Data, Data.Position);
+		File.close();
+
+		if(rename(TempFileName, IndexFileName) != 0){
+			error("BuildOrigMapIndex: Cannot rename %s.\n", TempFileName);
+		}else{
+			print(1, "Original map index built (%d sectors, %d bytes).\n",
+					Entries, Data.Position);
+		}
+	}catch(const char *str){
+		error("BuildOrigMapIndex: Cannot write index (%s).\n", str);
+	}
+
+	free(Entry);
+}
+
+static void UnloadOrigMapIndex(void){
+	if(OrigMapData != NULL){
+		munmap(OrigMapData, OrigMapDataSize);
+		OrigMapData = NULL;
+		OrigMapDataSize = 0;
+	}
+
+	delete[] OrigMapEntry;
+	OrigMapEntry = NULL;
+	OrigMapEntries = 0;
+}
+
+void InitOrigMapIndex(void){
+	// NOTE(fusion): This is called during startup, once object types are loaded
+	// because sector data can only be parsed after that, but before any order
+	// reaches the reader thread, so queued orders never wait for a rebuild.
+	char IndexFileName[4096];
+	GetOrigMapIndexFileName(IndexFileName, sizeof(IndexFileName));
+	uint32 ObjectTypes = GetObjectTypesChecksum();
+	if(OrigMapIndexOutdated(IndexFileName, ObjectTypes)){
+		BuildOrigMapIndex(IndexFileName, ObjectTypes);
+	}
+
+	int FileDescriptor = open(IndexFileName, O_RDONLY);
+	if(FileDescriptor == -1){
+		error("InitOrigMapIndex: Cannot open %s; falling back to sector files.\n", IndexFileName);
+		return;
+	}
+
+	struct stat IndexStat;
+	if(fstat(FileDescriptor, &IndexStat) == 0 && IndexStat.st_size >= ORIGMAP_INDEX_HEADER_SIZE){
+		void *Mapping = mmap(NULL, (size_t)IndexStat.st_size, PROT_READ, MAP_SHARED, FileDescriptor, 0);
+		if(Mapping != MAP_FAILED){
+			OrigMapData = (uint8*)Mapping;
+			OrigMapDataSize = (int)IndexStat.st_size;
+		}
+	}
+	close(FileDescriptor);
+
+	if(OrigMapData == NULL){
+		error("InitOrigMapIndex: Cannot map %s; falling back to sector files.\n", IndexFileName);
+		return;
+	}
+
+	TReadBuffer Buffer(OrigMapData, OrigMapDataSize);
+	uint32 Magic = Buffer.readQuad();
+	uint32 Version = Buffer.readQuad();
+	int Entries = (int)Buffer.readQuad();
+	int DataSize = (int)Buffer.readQuad();
+	Buffer.readQuad(); // ObjectTypes
+	int DataStart = ORIGMAP_INDEX_HEADER_SIZE + Entries * 20;
+	if(Magic != ORIGMAP_INDEX_MAGIC || Version != ORIGMAP_INDEX_VERSION
+			|| Entries < 0 || DataSize < 0 || DataStart < ORIGMAP_INDEX_HEADER_SIZE
+			|| (OrigMapDataSize - DataStart) != DataSize){
+		error("InitOrigMapIndex: Invalid index %s; falling back to sector files.\n", IndexFileName);
+		UnloadOrigMapIndex();
+		return;
+	}
+
+	OrigMapEntry = new TOrigMapEntry[Entries];
+	OrigMapEntries = Entries;
+	for(int i = 0; i < Entries; i += 1){
+		OrigMapEntry[i].SectorX = (int)Buffer.readQuad();
+		OrigMapEntry[i].SectorY = (int)Buffer.readQuad();
+		OrigMapEntry[i].SectorZ = (int)Buffer.readQuad();
+		OrigMapEntry[i].Offset = DataStart + (int)Buffer.readQuad();
+		OrigMapEntry[i].Size = (int)Buffer.readQuad();
+		if(OrigMapEntry[i].Size <= 0 || OrigMapEntry[i].Offset < DataStart
+				|| OrigMapEntry[i].Size > (OrigMapDataSize - OrigMapEntry[i].Offset)){
+			error("InitOrigMapIndex: Invalid entry in %s; falling back to sector files.\n", IndexFileName);
+			UnloadOrigMapIndex();
+			return;
+		}
+	}
+
+	print(1, "Original map index loaded (%d sectors).\n", OrigMapEntries);
+}
+
+static TOrigMapEntry *FindOrigMapEntry(int SectorX, int SectorY, int SectorZ){
+	TOrigMapEntry Key = {};
+	Key.SectorX = SectorX;
+	Key.SectorY = SectorY;
+	Key.SectorZ = SectorZ;
+	TOrigMapEntry *End = OrigMapEntry + OrigMapEntries;
+	TOrigMapEntry *Entry = std::lower_bound(OrigMapEntry, End, Key, OrigMapEntryLess);
+	if(Entry == End || OrigMapEntryLess(Key, *Entry)){
+		return NULL;
+	}
+	return Entry;
+}
+
+void ProcessLoadSectorOrder(int SectorX, int SectorY, int SectorZ, int64 OrderTime){
+	if(OrigMapData != NULL){
+		// NOTE(fusion): The reply data is still copied because its receiver
+		// takes ownership of it.
+		TOrigMapEntry *Entry = FindOrigMapEntry(SectorX, SectorY, SectorZ);
+		if(Entry != NULL){
+			uint8 *Data = new uint8[Entry->Size];
+			memcpy(Data, OrigMapData + Entry->Offset, Entry->Size);
+			SectorReply(SectorX, SectorY, SectorZ, Data, Entry->Size, OrderTime);
+		}
+		return;
+	}
+
+	// TODO(fusion): We parsed sector files way too many times now. And there
+	// is also a drop in loader quality.
+	char FileName[4096];
+	snprintf(FileName, sizeof(FileName), "%s/%04d-%04d-%02d.sec",
+			ORIGMAPPATH, SectorX, SectorY, SectorZ);
+	if(!FileExists(FileName)){
+		return;
+	}
+
+	int Size = ReadSectorRefreshData(FileName);
 	if(Size > 0){
 		uint8 *Data = new uint8[Size];
 		memcpy(Data, HelpBuffer.Data, Size);
-		SectorReply(SectorX, SectorY, SectorZ, Data, Size);
+		SectorReply(SectorX, SectorY, SectorZ, Data, Size, OrderTime);
 	}
 }
 
-void ProcessLoadCharacterOrder(uint32 CharacterID){
+void ProcessLoadCharacterOrder(uint32 CharacterID, int64 OrderTime){
 	while(true){
+		uint32 Generation = GetPlayerPoolReleaseGeneration();
 		TPlayerData *Slot = AssignPlayerPoolSlot(CharacterID, true);
 		if(Slot == NULL){
 			error("ProcessLoadCharacterOrder: Cannot assign slot for player data.\n");
 			break;
 		}
 
-		if(Slot->Locked == GetGameThreadID()){
+		pid_t Locked = Slot->Locked;
+		if(Locked == gettid()){
+			IncreasePlayerPoolSlotSticky(Slot);
+			ReleasePlayerPoolSlot(Slot);
+			CharacterReply(CharacterID, OrderTime);
 			break;
 		}
 
-		if(Slot->Locked == gettid()){
-			IncreasePlayerPoolSlotSticky(Slot);
-			ReleasePlayerPoolSlot(Slot);
-			CharacterReply(CharacterID);
+		// NOTE(fusion): The slot is locked by another thread, in which case
+		// `AssignPlayerPoolSlot` returned it with an extra sticky reference
+		// that we don't need while waiting.
+		DecreasePlayerPoolSlotSticky(Slot);
+		if(Locked == GetGameThreadID()){
 			break;
 		}
 
-		DelayThread(1, 0);
+		ReaderStatisticsMutex.down();
+		ReaderCharacterWaits += 1;
+		ReaderStatisticsMutex.up();
+
+		// NOTE(fusion): The timeout is only a safety net, slots are released
+		// through `ReleasePlayerPoolSlot` which wakes us up.
+		WaitPlayerPoolRelease(Generation, 1000);
+	}
+}
+
+// NOTE(fusion): Bulk version of `ProcessLoadSectorOrder` used to refresh the
+// whole map before a reboot. Each sector with refreshable fields is sent back
+// with its own `READER_REPLY_MAPDATA` reply and the last reply, with no data,
+// signals that the whole map was processed. See `RefreshMap`.
+static void InsertMapReply(int SectorX, int SectorY, int SectorZ,
+		const uint8 *Source, int Size, int64 OrderTime){
+	// NOTE(fusion): Leave room in the reply buffer for regular sector and
+	// character replies. The game thread releases `MapReplyBufferEmpty` as
+	// map replies are taken.
+	ReplyBufferMutex.down();
+	bool Terminating = ReaderTerminating;
+	ReplyBufferMutex.up();
+	if(!Terminating){
+		MapReplyBufferEmpty.down();
+	}
+
+	uint8 *Data = new uint8[Size];
+	memcpy(Data, Source, Size);
+	MapReply(SectorX, SectorY, SectorZ, Data, Size, OrderTime);
+}
+
+void ProcessLoadMapOrder(int64 OrderTime){
+	int SectorCounter = 0;
+	if(OrigMapData != NULL){
+		for(int i = 0; i < OrigMapEntries; i += 1){
+			TOrigMapEntry *Entry = &OrigMapEntry[i];
+			InsertMapReply(Entry->SectorX, Entry->SectorY, Entry->SectorZ,
+					OrigMapData + Entry->Offset, Entry->Size, OrderTime);
+			SectorCounter += 1;
+		}
+	}else if(DIR *OrigMapDir = opendir(ORIGMAPPATH)){
+		char FileName[4096];
+		while(dirent *DirEntry = readdir(OrigMapDir)){
+			if(DirEntry->d_type != DT_REG){
+				continue;
+			}
+
+			const char *FileExt = findLast(DirEntry->d_name, '.');
+			if(FileExt == NULL || strcmp(FileExt, ".sec") != 0){
+				continue;
+			}
+
+			int SectorX, SectorY, SectorZ;
+			if(sscanf(DirEntry->d_name, "%d-%d-%d.sec", &SectorX, &SectorY, &SectorZ) != 3){
+				continue;
+			}
+
+			snprintf(FileName, sizeof(FileName), "%s/%s", ORIGMAPPATH, DirEntry->d_name);
+			try{
+				int Size = ReadSectorRefreshData(FileName);
+				if(Size > 0){
+					InsertMapReply(SectorX, SectorY, SectorZ, HelpBuffer.Data, Size, OrderTime);
+					SectorCounter += 1;
+				}
+			}catch(const char *str){
+				error("ProcessLoadMapOrder: Error while processing file %s (%s).\n", FileName, str);
+			}
+		}
+
+		closedir(OrigMapDir);
+	}else{
+		error("ProcessLoadMapOrder: Subdirectory %s not found.\n", ORIGMAPPATH);
 	}
+
+	print(2, "ProcessLoadMapOrder: %d refreshable sectors loaded.\n", SectorCounter);
+	MapReply(0, 0, 0, NULL, 0, OrderTime);
 }
 
 int ReaderThreadLoop(void *Unused){
@@ -160,12 +650,26 @@ int ReaderThreadLoop(void *Unused){
 
 		switch(Order.OrderType){
 			case READER_ORDER_LOADSECTOR:{
-				ProcessLoadSectorOrder(Order.SectorX, Order.SectorY, Order.SectorZ);
+				int64 StartTime = GetMonotonicMicroseconds();
+				ProcessLoadSectorOrder(Order.SectorX, Order.SectorY, Order.SectorZ, Order.OrderTime);
+				int64 EndTime = GetMonotonicMicroseconds();
+
+				ReaderStatisticsMutex.down();
+				ReaderSectorRequests += 1;
+				if(OrigMapData != NULL){
+					ReaderSectorIndexHits += 1;
+				}
+				ReaderSectorWaitTotal += StartTime - Order.OrderTime;
+				ReaderSectorLatencyTotal += EndTime - Order.OrderTime;
+				if(ReaderSectorLatencyMax < (EndTime - Order.OrderTime)){
+					ReaderSectorLatencyMax = EndTime - Order.OrderTime;
+				}
+				ReaderStatisticsMutex.up();
 				break;
 			}
 
-			case READER_ORDER_LOADCHARACTER:{
-				ProcessLoadCharacterOrder(Order.CharacterID);
+			case READER_ORDER_LOADMAP:{
+				ProcessLoadMapOrder(Order.OrderTime);
 				break;
 			}
 
@@ -179,14 +683,50 @@ int ReaderThreadLoop(void *Unused){
 	return 0;
 }
 
+int ReaderWorkerLoop(void *Unused){
+	TReaderThreadOrder Order = {};
+	while(true){
+		GetCharacterOrder(&Order);
+		if(Order.OrderType == READER_ORDER_TERMINATE){
+			break;
+		}
+
+		if(Order.OrderType == READER_ORDER_LOADCHARACTER){
+			ProcessLoadCharacterOrder(Order.CharacterID, Order.OrderTime);
+		}else{
+			error("ReaderWorkerLoop: Unexpected command %d.\n", Order.OrderType);
+		}
+	}
+
+	return 0;
+}
+
 // Reader Replies
 // =============================================================================
-void InsertReply(TReaderThreadReplyType ReplyType,
-		int SectorX, int SectorY, int SectorZ, uint8 *Data, int Size){
-	int Replies = (ReplyPointerWrite - ReplyPointerRead);
-	while(Replies > NARRAY(ReplyBuffer)){
-		error("InsertReply (Reader): Buffer is full; waiting...\n");
-		DelayThread(5, 0);
+void InsertReply(TReaderThreadReplyType ReplyType, int SectorX, int SectorY,
+		int SectorZ, uint8 *Data, int Size, int64 OrderTime){
+	ReplyBufferMutex.down();
+	bool Terminating = ReaderTerminating;
+	bool Full = (ReplyPointerWrite - ReplyPointerRead) >= NARRAY(ReplyBuffer);
+	ReplyBufferMutex.up();
+
+	if(!Terminating){
+		if(Full){
+			ReaderStatisticsMutex.down();
+			ReaderReplyStalls += 1;
+			ReaderStatisticsMutex.up();
+		}
+
+		ReplyBufferEmpty.down();
+	}
+
+	// NOTE(fusion): Nobody will process replies once the reader is shutting
+	// down, see `ExitReader`.
+	ReplyBufferMutex.down();
+	if(ReaderTerminating){
+		ReplyBufferMutex.up();
+		delete[] Data;
+		return;
 	}
 
 	int WritePos = ReplyPointerWrite % NARRAY(ReplyBuffer);
@@ -196,24 +736,55 @@ void InsertReply(TReaderThreadReplyType ReplyType,
 	ReplyBuffer[WritePos].SectorZ = SectorZ;
 	ReplyBuffer[WritePos].Data = Data;
 	ReplyBuffer[WritePos].Size = Size;
+	ReplyBuffer[WritePos].OrderTime = OrderTime;
 	ReplyPointerWrite += 1;
+	ReplyBufferMutex.up();
 }
 
 bool GetReply(TReaderThreadReply *Reply){
+	ReplyBufferMutex.down();
 	bool Result = (ReplyPointerRead < ReplyPointerWrite);
 	if(Result){
 		*Reply = ReplyBuffer[ReplyPointerRead % NARRAY(ReplyBuffer)];
 		ReplyPointerRead += 1;
 	}
+	ReplyBufferMutex.up();
+
+	if(Result){
+		ReplyBufferEmpty.up();
+		if(Reply->ReplyType == READER_REPLY_MAPDATA && Reply->Data != NULL){
+			MapReplyBufferEmpty.up();
+		}
+	}
 	return Result;
 }
 
-void SectorReply(int SectorX, int SectorY, int SectorZ, uint8 *Data, int Size){
-	InsertReply(READER_REPLY_SECTORDATA, SectorX, SectorY, SectorZ, Data, Size);
+void SectorReply(int SectorX, int SectorY, int SectorZ, uint8 *Data, int Size, int64 OrderTime){
+	InsertReply(READER_REPLY_SECTORDATA, SectorX, SectorY, SectorZ, Data, Size, OrderTime);
+}
+
+void CharacterReply(uint32 CharacterID, int64 OrderTime){
+	InsertReply(READER_REPLY_CHARACTERDATA, 0, 0, 0, NULL, (int)CharacterID, OrderTime);
 }
 
-void CharacterReply(uint32 CharacterID){
-	InsertReply(READER_REPLY_CHARACTERDATA, 0, 0, 0, NULL, (int)CharacterID);
+void MapReply(int SectorX, int SectorY, int SectorZ, uint8 *Data, int Size, int64 OrderTime){
+	InsertReply(READER_REPLY_MAPDATA, SectorX, SectorY, SectorZ, Data, Size, OrderTime);
+}
+
+static void RecordReplyLatency(TReaderThreadReplyType ReplyType, int64 OrderTime){
+	int Type = (int)ReplyType;
+	if(Type < 0 || Type >= NARRAY(ReaderReplies)){
+		return;
+	}
+
+	int64 Latency = GetMonotonicMicroseconds() - OrderTime;
+	ReaderStatisticsMutex.down();
+	ReaderReplies[Type] += 1;
+	ReaderReplyLatencyTotal[Type] += Latency;
+	if(ReaderReplyLatencyMax[Type] < Latency){
+		ReaderReplyLatencyMax[Type] = Latency;
+	}
+	ReaderStatisticsMutex.up();
 }
 
 void ProcessSectorReply(TRefreshSectorFunction *RefreshSector,
@@ -234,9 +805,16 @@ void ProcessCharacterReply(TSendMailsFunction *SendMails, uint32 CharacterID){
 	ReleasePlayerPoolSlot(Slot);
 }
 
-void ProcessReaderThreadReplies(TRefreshSectorFunction *RefreshSector, TSendMailsFunction *SendMails){
+void ProcessReaderThreadReplies(TRefreshSectorFunction *RefreshSector,
+		TRefreshSectorFunction *RefreshMapSector, TSendMailsFunction *SendMails){
 	TReaderThreadReply Reply = {};
 	while(GetReply(&Reply)){
+		// NOTE(fusion): A map order yields one reply per sector so only the
+		// last one, with no data, counts towards its latency.
+		if(Reply.ReplyType != READER_REPLY_MAPDATA || Reply.Data == NULL){
+			RecordReplyLatency(Reply.ReplyType, Reply.OrderTime);
+		}
+
 		switch(Reply.ReplyType){
 			case READER_REPLY_SECTORDATA:{
 				ProcessSectorReply(RefreshSector,
@@ -250,6 +828,14 @@ void ProcessReaderThreadReplies(TRefreshSectorFunction *RefreshSector, TSendMail
 				break;
 			}
 
+			case READER_REPLY_MAPDATA:{
+				// NOTE(fusion): Ownership of `Reply.Data` is transferred to
+				// `RefreshMapSector`, which will apply it over time.
+				RefreshMapSector(Reply.SectorX, Reply.SectorY, Reply.SectorZ,
+						Reply.Data, Reply.Size);
+				break;
+			}
+
 			default:{
 				error("ProcessReaderThreadReplies: Unknown response %d.\n", Reply.ReplyType);
 				break;
@@ -260,18 +846,93 @@ void ProcessReaderThreadReplies(TRefreshSectorFunction *RefreshSector, TSendMail
 
 // Initialization
 // =============================================================================
+void ReaderLatencySummary(void){
+	ReaderStatisticsMutex.down();
+	if(ReaderSectorRequests > 0){
+		Log("reader", "sector requests: %d (%d from index).\n",
+				ReaderSectorRequests, ReaderSectorIndexHits);
+		Log("reader", "average wait: %d usec, average latency: %d usec, max latency: %d usec.\n",
+				(int)(ReaderSectorWaitTotal / ReaderSectorRequests),
+				(int)(ReaderSectorLatencyTotal / ReaderSectorRequests),
+				(int)ReaderSectorLatencyMax);
+	}
+	ReaderSectorRequests = 0;
+	ReaderSectorIndexHits = 0;
+	ReaderSectorWaitTotal = 0;
+	ReaderSectorLatencyTotal = 0;
+	ReaderSectorLatencyMax = 0;
+
+	static const char ReplyName[3][10] = {"sector", "character", "map"};
+	for(int Type = 0; Type < NARRAY(ReaderReplies); Type += 1){
+		if(ReaderReplies[Type] > 0){
+			Log("reader", "%s replies: %d, average order-to-reply: %d usec, max: %d usec.\n",
+					ReplyName[Type], ReaderReplies[Type],
+					(int)(ReaderReplyLatencyTotal[Type] / ReaderReplies[Type]),
+					(int)ReaderReplyLatencyMax[Type]);
+		}
+		ReaderReplies[Type] = 0;
+		ReaderReplyLatencyTotal[Type] = 0;
+		ReaderReplyLatencyMax[Type] = 0;
+	}
+
+	if(ReaderReplyStalls > 0 || ReaderCharacterWaits > 0){
+		Log("reader", "reply buffer full: %d times, character loads waiting for a slot: %d.\n",
+				ReaderReplyStalls, ReaderCharacterWaits);
+	}
+	ReaderReplyStalls = 0;
+	ReaderCharacterWaits = 0;
+	ReaderStatisticsMutex.up();
+}
+
 void InitReader(void){
 	InitReaderBuffers();
 	ReaderThread = StartThread(ReaderThreadLoop, NULL, false);
 	if(ReaderThread == INVALID_THREAD_HANDLE){
 		throw "cannot start reader thread";
 	}
+
+	int Workers = std::max<int>(1, std::min<int>(ReaderWorkers, MAX_READER_WORKERS));
+	for(ReaderWorkerThreads = 0;
+			ReaderWorkerThreads < Workers;
+			ReaderWorkerThreads += 1){
+		ThreadHandle Worker = StartThread(ReaderWorkerLoop, NULL, false);
+		if(Worker == INVALID_THREAD_HANDLE){
+			throw "cannot start reader worker thread";
+		}
+		ReaderWorkerThread[ReaderWorkerThreads] = Worker;
+	}
 }
 
 void ExitReader(void){
+	for(int i = 0; i < ReaderWorkerThreads; i += 1){
+		TerminateCharacterOrder();
+	}
+
 	if(ReaderThread != INVALID_THREAD_HANDLE){
 		TerminateReaderOrder();
+	}
+
+	// NOTE(fusion): The game thread won't take any more replies so producers
+	// that are blocked on a full reply buffer must be released. They'll drop
+	// whatever they were about to insert.
+	ReplyBufferMutex.down();
+	ReaderTerminating = true;
+	ReplyBufferMutex.up();
+	for(int i = 0; i <= ReaderWorkerThreads; i += 1){
+		ReplyBufferEmpty.up();
+		MapReplyBufferEmpty.up();
+	}
+
+	for(int i = 0; i < ReaderWorkerThreads; i += 1){
+		JoinThread(ReaderWorkerThread[i]);
+		ReaderWorkerThread[i] = INVALID_THREAD_HANDLE;
+	}
+	ReaderWorkerThreads = 0;
+
+	if(ReaderThread != INVALID_THREAD_HANDLE){
 		JoinThread(ReaderThread);
 		ReaderThread = INVALID_THREAD_HANDLE;
 	}
+
+	UnloadOrigMapIndex();
 }
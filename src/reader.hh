@@ -13,11 +13,13 @@ enum TReaderThreadOrderType: int {
 	READER_ORDER_TERMINATE		= 0,
 	READER_ORDER_LOADSECTOR		= 1,
 	READER_ORDER_LOADCHARACTER	= 2,
+	READER_ORDER_LOADMAP		= 3,
 };
 
 enum TReaderThreadReplyType: int {
 	READER_REPLY_SECTORDATA		= 0,
 	READER_REPLY_CHARACTERDATA	= 1,
+	READER_REPLY_MAPDATA		= 2,
 };
 
 struct TReaderThreadOrder {
@@ -26,6 +28,7 @@ struct TReaderThreadOrder {
 	int SectorY;
 	int SectorZ;
 	uint32 CharacterID;
+	int64 OrderTime;
 };
 
 struct TReaderThreadReply {
@@ -35,29 +38,39 @@ struct TReaderThreadReply {
 	int SectorZ;
 	uint8 *Data;
 	int Size;
+	int64 OrderTime;
 };
 
 void InitReaderBuffers(void);
 void InsertOrder(TReaderThreadOrderType OrderType,
 		int SectorX, int SectorY, int SectorZ, uint32 CharacterID);
 void GetOrder(TReaderThreadOrder *Order);
+void GetCharacterOrder(TReaderThreadOrder *Order);
 void TerminateReaderOrder(void);
+void TerminateCharacterOrder(void);
 void LoadSectorOrder(int SectorX, int SectorY, int SectorZ);
 void LoadCharacterOrder(uint32 CharacterID);
-void ProcessLoadSectorOrder(int SectorX, int SectorY, int SectorZ);
-void ProcessLoadCharacterOrder(uint32 CharacterID);
+void LoadMapOrder(void);
+void ProcessLoadSectorOrder(int SectorX, int SectorY, int SectorZ, int64 OrderTime);
+void ProcessLoadCharacterOrder(uint32 CharacterID, int64 OrderTime);
+void ProcessLoadMapOrder(int64 OrderTime);
 int ReaderThreadLoop(void *Unused);
+int ReaderWorkerLoop(void *Unused);
 
-void InsertReply(TReaderThreadReplyType ReplyType,
-		int SectorX, int SectorY, int SectorZ, uint8 *Data, int Size);
+void InsertReply(TReaderThreadReplyType ReplyType, int SectorX, int SectorY,
+		int SectorZ, uint8 *Data, int Size, int64 OrderTime);
 bool GetReply(TReaderThreadReply *Reply);
-void SectorReply(int SectorX, int SectorY, int SectorZ, uint8 *Data, int Size);
-void CharacterReply(uint32 CharacterID);
+void SectorReply(int SectorX, int SectorY, int SectorZ, uint8 *Data, int Size, int64 OrderTime);
+void CharacterReply(uint32 CharacterID, int64 OrderTime);
+void MapReply(int SectorX, int SectorY, int SectorZ, uint8 *Data, int Size, int64 OrderTime);
 void ProcessSectorReply(TRefreshSectorFunction *RefreshSector,
 		int SectorX, int SectorY, int SectorZ, uint8 *Data, int Size);
 void ProcessCharacterReply(TSendMailsFunction *SendMails, uint32 CharacterID);
-void ProcessReaderThreadReplies(TRefreshSectorFunction *RefreshSector, TSendMailsFunction *SendMails);
+void ProcessReaderThreadReplies(TRefreshSectorFunction *RefreshSector,
+		TRefreshSectorFunction *RefreshMapSector, TSendMailsFunction *SendMails);
+void ReaderLatencySummary(void);
 
+void InitOrigMapIndex(void);
 void InitReader(void);
 void ExitReader(void);
 
@@ -11,7 +11,10 @@
 //	- TReadBinaryFile::error
 //	- TWriteBinaryFile::open
 //	- TWriteBinaryFile::error
-static char ErrorString[100];
+//	It is also per thread since reader workers parse player files concurrently.
+// It can't be a member of the file either, because the file is usually a local
+// that is already destroyed once the exception is caught.
+static thread_local char ErrorString[100];
 
 // Helper Functions
 // =============================================================================
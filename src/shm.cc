@@ -25,6 +25,13 @@ struct TSharedMemory {
 	GAMESTATE GameState;
 	pid_t GameProcessID;
 	pid_t GameThreadID;
+
+	// NOTE(fusion): Object store usage and high-water marks. These were appended
+	// to the original layout so external tools reading the fields above aren't
+	// affected.
+	uint32 ObjectCounterMax;
+	int ObjectBlocks;
+	int ObjectBlocksMax;
 };
 
 static TSharedMemory *SHM = NULL;
@@ -187,6 +194,9 @@ char *GetPrintlogLine(int Line){
 void IncrementObjectCounter(void){
 	if(SHM != NULL){
 		SHM->ObjectCounter += 1;
+		if(SHM->ObjectCounter > SHM->ObjectCounterMax){
+			SHM->ObjectCounterMax = SHM->ObjectCounter;
+		}
 	}
 }
 
@@ -204,6 +214,39 @@ uint32 GetObjectCounter(void){
 	return ObjectCounter;
 }
 
+uint32 GetObjectCounterMax(void){
+	uint32 ObjectCounterMax = 0;
+	if(SHM != NULL){
+		ObjectCounterMax = SHM->ObjectCounterMax;
+	}
+	return ObjectCounterMax;
+}
+
+void SetObjectBlocks(int Blocks){
+	if(SHM != NULL){
+		SHM->ObjectBlocks = Blocks;
+		if(SHM->ObjectBlocks > SHM->ObjectBlocksMax){
+			SHM->ObjectBlocksMax = SHM->ObjectBlocks;
+		}
+	}
+}
+
+int GetObjectBlocks(void){
+	int ObjectBlocks = 0;
+	if(SHM != NULL){
+		ObjectBlocks = SHM->ObjectBlocks;
+	}
+	return ObjectBlocks;
+}
+
+int GetObjectBlocksMax(void){
+	int ObjectBlocksMax = 0;
+	if(SHM != NULL){
+		ObjectBlocksMax = SHM->ObjectBlocksMax;
+	}
+	return ObjectBlocksMax;
+}
+
 void IncrementPlayersOnline(void){
 	if(SHM != NULL){
 		SHM->PlayersOnline += 1;
@@ -168,3 +168,63 @@ void Semaphore::up(void){
 	pthread_mutex_unlock(&this->mutex);
 	pthread_cond_signal(&this->condition);
 }
+
+Event::Event(void){
+	this->counter = 0;
+
+	if(pthread_mutex_init(&this->mutex, NULL) != 0){
+		error("Event::Event: Cannot set up mutex.\n");
+	}
+
+	if(pthread_cond_init(&this->condition, NULL) != 0){
+		error("Event::Event: Cannot set up wait condition.\n");
+	}
+}
+
+Event::~Event(void){
+	// NOTE(fusion): Same as `Semaphore::~Semaphore`.
+	int ErrorCode;
+	if((ErrorCode = pthread_mutex_destroy(&this->mutex)) != 0){
+		error("Event::~Event: Cannot release mutex: (%d) %s.\n",
+				ErrorCode, strerrordesc_np(ErrorCode));
+	}else if((ErrorCode = pthread_cond_destroy(&this->condition)) != 0){
+		error("Event::~Event: Cannot release wait condition: (%d) %s.\n",
+				ErrorCode, strerrordesc_np(ErrorCode));
+	}
+}
+
+uint32 Event::generation(void){
+	pthread_mutex_lock(&this->mutex);
+	uint32 Generation = this->counter;
+	pthread_mutex_unlock(&this->mutex);
+	return Generation;
+}
+
+void Event::signal(void){
+	pthread_mutex_lock(&this->mutex);
+	this->counter += 1;
+	pthread_mutex_unlock(&this->mutex);
+	pthread_cond_broadcast(&this->condition);
+}
+
+bool Event::wait(uint32 Generation, int Milliseconds){
+	struct timespec Deadline;
+	clock_gettime(CLOCK_REALTIME, &Deadline);
+	Deadline.tv_sec += Milliseconds / 1000;
+	Deadline.tv_nsec += (long)(Milliseconds % 1000) * 1000000L;
+	if(Deadline.tv_nsec >= 1000000000L){
+		Deadline.tv_sec += 1;
+		Deadline.tv_nsec -= 1000000000L;
+	}
+
+	bool Result = true;
+	pthread_mutex_lock(&this->mutex);
+	while(this->counter == Generation){
+		if(pthread_cond_timedwait(&this->condition, &this->mutex, &Deadline) != 0){
+			Result = (this->counter != Generation);
+			break;
+		}
+	}
+	pthread_mutex_unlock(&this->mutex);
+	return Result;
+}
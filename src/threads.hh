@@ -30,4 +30,21 @@ struct Semaphore {
 	pthread_cond_t condition;
 };
 
+// NOTE(fusion): Generation counter that threads can block on until another
+// thread advances it. Reading the generation before checking whatever shared
+// state is being waited on makes sure a signal in between isn't lost.
+struct Event {
+	Event(void);
+	~Event(void);
+	uint32 generation(void);
+	void signal(void);
+	bool wait(uint32 Generation, int Milliseconds);
+
+	// DATA
+	// =================
+	uint32 counter;
+	pthread_mutex_t mutex;
+	pthread_cond_t condition;
+};
+
 #endif //TIBIA_THREADS_HH_
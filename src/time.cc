@@ -91,3 +91,11 @@ uint32 GetRoundForNextMinute(void){
 	int SecondsToNextMinute = 60 - LocalTime.tm_sec;
 	return SecondsToNextMinute + RoundNr + 30;
 }
+
+// NOTE(fusion): Used to measure elapsed time for things like time budgets,
+// where wall clock adjustments would get in the way.
+int64 GetMonotonicMicroseconds(void){
+	struct timespec Time;
+	clock_gettime(CLOCK_MONOTONIC, &Time);
+	return (int64)Time.tv_sec * 1000000 + (int64)(Time.tv_nsec / 1000);
+}
@@ -27,6 +27,11 @@ static int ReplyPointerRead;
 
 static TQueryManagerConnection *QueryManagerConnection;
 
+// NOTE(fusion): The writer's own copy of the online list, which is kept up to
+// date with the deltas sent by `CreatePlayerList`.
+static vector<TPlayerlistEntry> PlayerlistEntry(0, 100, 100);
+static int PlayerlistEntries;
+
 // Protocol Orders
 // =============================================================================
 void InitProtocol(void){
@@ -257,7 +262,7 @@ void LogoutOrder(TPlayer *Player){
 }
 
 void PlayerlistOrder(int NumberOfPlayers, const char *PlayerNames,
-		int *PlayerLevels, int *PlayerProfessions){
+		int *PlayerLevels, int *PlayerProfessions, bool Delta){
 	if(PlayerNames == NULL){
 		error("PlayerlistOrder: PlayerNames is NULL.\n");
 		return;
@@ -278,6 +283,7 @@ void PlayerlistOrder(int NumberOfPlayers, const char *PlayerNames,
 	Data->PlayerNames = PlayerNames;
 	Data->PlayerLevels = PlayerLevels;
 	Data->PlayerProfessions = PlayerProfessions;
+	Data->Delta = Delta;
 
 	InsertOrder(WRITER_ORDER_PLAYERLIST, Data);
 }
@@ -434,31 +440,96 @@ void ProcessLogoutOrder(TLogoutOrderData *Data){
 	delete Data;
 }
 
+static void ApplyPlayerlistOrder(TPlayerlistOrderData *Data){
+	if(!Data->Delta || Data->NumberOfPlayers < 0){
+		PlayerlistEntries = 0;
+	}
+
+	for(int PlayerNr = 0; PlayerNr < Data->NumberOfPlayers; PlayerNr += 1){
+		const char *Name = &Data->PlayerNames[PlayerNr * 30];
+		int EntryNr = 0;
+		if(Data->Delta){
+			while(EntryNr < PlayerlistEntries
+					&& strcmp(PlayerlistEntry.at(EntryNr)->Name, Name) != 0){
+				EntryNr += 1;
+			}
+		}else{
+			EntryNr = PlayerlistEntries;
+		}
+
+		if(Data->PlayerLevels[PlayerNr] == 0){
+			if(EntryNr < PlayerlistEntries){
+				PlayerlistEntries -= 1;
+				*PlayerlistEntry.at(EntryNr) = *PlayerlistEntry.at(PlayerlistEntries);
+			}
+			continue;
+		}
+
+		TPlayerlistEntry *Entry = PlayerlistEntry.at(EntryNr);
+		if(EntryNr >= PlayerlistEntries){
+			strcpy(Entry->Name, Name);
+			PlayerlistEntries += 1;
+		}
+		Entry->Level = Data->PlayerLevels[PlayerNr];
+		Entry->Profession = Data->PlayerProfessions[PlayerNr];
+	}
+}
+
+static void WritePlayerlistFile(TPlayerlistOrderData *Data){
+	FILE *File = fopen(PlayerlistFile, "a");
+	if(File == NULL){
+		error("WritePlayerlistFile: Cannot open %s.\n", PlayerlistFile);
+		return;
+	}
+
+	fprintf(File, "%d %s %d\n", (int)time(NULL),
+			(Data->Delta ? "delta" : "full"), Data->NumberOfPlayers);
+	for(int PlayerNr = 0; PlayerNr < Data->NumberOfPlayers; PlayerNr += 1){
+		const char *Name = &Data->PlayerNames[PlayerNr * 30];
+		if(Data->PlayerLevels[PlayerNr] == 0){
+			fprintf(File, "-%s\n", Name);
+		}else{
+			char Profession[30];
+			GetProfessionName(Profession, Data->PlayerProfessions[PlayerNr], false, true);
+			fprintf(File, "+%s,%d,%s\n", Name, Data->PlayerLevels[PlayerNr], Profession);
+		}
+	}
+	fprintf(File, "%d online\n", PlayerlistEntries);
+	fclose(File);
+}
+
 void ProcessPlayerlistOrder(TPlayerlistOrderData *Data){
 	if(Data == NULL){
 		error("ProcessPlayerlistOrder: No data passed.\n");
 		return;
 	}
 
+	ApplyPlayerlistOrder(Data);
+
 	bool NewRecord = false;
-	if(Data->NumberOfPlayers <= 0){
-		int Ret = QueryManagerConnection->createPlayerlist(Data->NumberOfPlayers,
+	if(PlayerlistFile[0] != 0){
+		WritePlayerlistFile(Data);
+	}else if(Data->NumberOfPlayers < 0 || PlayerlistEntries == 0){
+		int Ret = QueryManagerConnection->createPlayerlist(
+				(Data->NumberOfPlayers < 0 ? -1 : 0),
 				NULL, NULL, NULL, &NewRecord);
 		if(Ret != 0){
 			error("ProcessPlayerlistOrder: Request failed (1).\n");
 		}
 	}else{
-		const char **Names      = (const char**)alloca(Data->NumberOfPlayers * sizeof(const char*));
-		int *Levels             = (int*)alloca(Data->NumberOfPlayers * sizeof(int));
-		char (*Professions)[30] = (char(*)[30])alloca(Data->NumberOfPlayers * 30);
-		for(int PlayerNr = 0; PlayerNr < Data->NumberOfPlayers; PlayerNr += 1){
-			Names[PlayerNr] = &Data->PlayerNames[PlayerNr * 30];
-			Levels[PlayerNr] = Data->PlayerLevels[PlayerNr];
-			GetProfessionName(Professions[PlayerNr],
-					Data->PlayerProfessions[PlayerNr], false, true);
+		// NOTE(fusion): The query manager only takes complete lists so the
+		// delta is applied here and the whole list is sent from this thread.
+		const char **Names      = (const char**)alloca(PlayerlistEntries * sizeof(const char*));
+		int *Levels             = (int*)alloca(PlayerlistEntries * sizeof(int));
+		char (*Professions)[30] = (char(*)[30])alloca(PlayerlistEntries * 30);
+		for(int EntryNr = 0; EntryNr < PlayerlistEntries; EntryNr += 1){
+			TPlayerlistEntry *Entry = PlayerlistEntry.at(EntryNr);
+			Names[EntryNr] = Entry->Name;
+			Levels[EntryNr] = Entry->Level;
+			GetProfessionName(Professions[EntryNr], Entry->Profession, false, true);
 		}
 
-		int Ret = QueryManagerConnection->createPlayerlist(Data->NumberOfPlayers,
+		int Ret = QueryManagerConnection->createPlayerlist(PlayerlistEntries,
 				Names, Levels, Professions, &NewRecord);
 		if(Ret != 0){
 			error("ProcessPlayerlistOrder: Request failed (2).\n");
@@ -466,7 +537,7 @@ void ProcessPlayerlistOrder(TPlayerlistOrderData *Data){
 	}
 
 	if(NewRecord){
-		BroadcastReply("New record: %d players are logged in.", Data->NumberOfPlayers);
+		BroadcastReply("New record: %d players are logged in.", PlayerlistEntries);
 	}
 
 	delete[] Data->PlayerNames;
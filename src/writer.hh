@@ -43,11 +43,21 @@ struct TLogoutOrderData{
 	char Residence[30];
 };
 
+// NOTE(fusion): With `Delta` set, the order only holds players that joined or
+// changed level or profession since the last one, and players that left with
+// a level of zero. See `CreatePlayerList`.
 struct TPlayerlistOrderData{
 	int NumberOfPlayers;
 	const char *PlayerNames;
 	int *PlayerLevels;
 	int *PlayerProfessions;
+	bool Delta;
+};
+
+struct TPlayerlistEntry{
+	char Name[30];
+	int Level;
+	int Profession;
 };
 
 struct TKillStatisticsOrderData{
@@ -114,7 +124,7 @@ void GetOrder(TWriterThreadOrder *Order);
 void TerminateWriterOrder(void);
 void LogoutOrder(TPlayer *Player);
 void PlayerlistOrder(int NumberOfPlayers, const char *PlayerNames,
-		int *PlayerLevels, int *PlayerProfessions);
+		int *PlayerLevels, int *PlayerProfessions, bool Delta);
 void KillStatisticsOrder(int NumberOfRaces, const char *RaceNames,
 		int *KilledPlayers, int *KilledCreatures);
 void PunishmentOrder(TCreature *Gamemaster, const char *Name, const char *IPAddress,